@@ -56,7 +56,8 @@
 #include "boot_serial/boot_serial.h"
 #include "boot_serial_priv.h"
 
-#ifdef CONFIG_BOOT_ERASE_PROGRESSIVELY
+#if defined(CONFIG_BOOT_ERASE_PROGRESSIVELY) || \
+    defined(MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
 #include "bootutil_priv.h"
 #endif
 
@@ -64,7 +65,11 @@
 
 MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
 
+#ifdef MCUBOOT_SERIAL_MAX_RECEIVE_SIZE
+#define BOOT_SERIAL_INPUT_MAX   MCUBOOT_SERIAL_MAX_RECEIVE_SIZE
+#else
 #define BOOT_SERIAL_INPUT_MAX   512
+#endif
 #define BOOT_SERIAL_OUT_MAX     128
 
 #ifdef __ZEPHYR__
@@ -95,6 +100,39 @@ static uint32_t curr_off;
 static uint32_t img_size;
 static struct nmgr_hdr *bs_hdr;
 
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+#ifdef MCUBOOT_SWAP_USING_STATUS
+#error "Resumable uploads need the status area of the image trailer"
+#endif
+
+#define BS_RESUME_INTERVAL  MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+#define BS_RESUME_MAGIC     0x52534d55
+
+/*
+ * Upload progress. The records are appended to the status area of the
+ * trailer of the primary slot, which is only used while swapping, and the
+ * latest one is the valid one. A record with img_size == 0 ends the upload.
+ */
+struct bs_resume_rec {
+    uint32_t magic;
+    uint32_t img_size;
+    uint32_t off;
+    uint32_t crc;           /* CRC32 of the image data before off. */
+};
+
+#define BS_RESUME_REC_MAX \
+    (sizeof(struct bs_resume_rec) > BOOT_MAX_ALIGN ? \
+     sizeof(struct bs_resume_rec) : BOOT_MAX_ALIGN)
+
+static uint32_t img_crc;
+static uint32_t resume_next;
+static bool resume_tried;
+#endif
+
+#ifdef MCUBOOT_SERIAL_UPLOAD_LZ4_MAX
+static uint8_t lz4_buf[MCUBOOT_SERIAL_UPLOAD_LZ4_MAX];
+#endif
+
 static char bs_obuf[BOOT_SERIAL_OUT_MAX];
 
 static int bs_cbor_writer(struct cbor_encoder_writer *, const char *data,
@@ -222,6 +260,266 @@ bs_list(char *buf, int len)
     boot_serial_output();
 }
 
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+/*
+ * CRC32 (IEEE 802.3), as computed by zlib, so that a host can check which
+ * image data it is resuming.
+ */
+static uint32_t
+bs_crc32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    int i;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
+static uint32_t
+bs_resume_rec_sz(const struct flash_area *fap)
+{
+    uint32_t align = flash_area_align(fap);
+
+    return (sizeof(struct bs_resume_rec) + align - 1) / align * align;
+}
+
+static uint32_t
+bs_resume_slots(const struct flash_area *fap)
+{
+    return boot_status_sz(flash_area_align(fap)) / bs_resume_rec_sz(fap);
+}
+
+/*
+ * Read the latest progress record of the slot, and find the first free
+ * record after it. Returns 0 if there is one.
+ */
+static int
+bs_resume_read(const struct flash_area *fap, struct bs_resume_rec *rec)
+{
+    struct bs_resume_rec tmp;
+    uint32_t sz = bs_resume_rec_sz(fap);
+    uint32_t i;
+    int rc = -1;
+
+    resume_next = 0;
+    for (i = 0; i < bs_resume_slots(fap); i++) {
+        if (flash_area_read(fap, boot_status_off(fap) + i * sz, &tmp,
+                            sizeof(tmp))) {
+            return -1;
+        }
+        if (bootutil_buffer_is_erased(fap, &tmp, sizeof(tmp))) {
+            continue;
+        }
+        /* Never write over a record, even a torn one. */
+        resume_next = i + 1;
+        if (tmp.magic == BS_RESUME_MAGIC) {
+            *rec = tmp;
+            rc = 0;
+        }
+    }
+
+    return rc;
+}
+
+/*
+ * Append a progress record. Saving the progress is best effort: the upload
+ * goes on if it fails, it just can't be resumed from there.
+ */
+static void
+bs_resume_save(const struct flash_area *fap, uint32_t size, uint32_t off,
+               uint32_t crc)
+{
+    uint8_t buf[BS_RESUME_REC_MAX];
+    struct bs_resume_rec rec;
+    uint32_t sz = bs_resume_rec_sz(fap);
+
+    /* A padded image covers the trailer, there is no room for the records. */
+    if (img_size > boot_status_off(fap)) {
+        return;
+    }
+    /* Keep the last record for the end of the upload. */
+    if (resume_next + (size != 0) >= bs_resume_slots(fap)) {
+        return;
+    }
+
+    rec.magic = BS_RESUME_MAGIC;
+    rec.img_size = size;
+    rec.off = off;
+    rec.crc = crc;
+    memset(buf, flash_area_erased_val(fap), sz);
+    memcpy(buf, &rec, sizeof(rec));
+    if (flash_area_write(fap, boot_status_off(fap) + resume_next * sz, buf,
+                         sz)) {
+        BOOT_LOG_WRN("Unable to save the upload progress");
+    }
+    resume_next++;
+}
+
+/*
+ * Pick up an upload interrupted by a reset: check the data in the slot
+ * against the latest progress record, erase what may have been written
+ * after it, and continue from the last multiple of the resume interval.
+ */
+static void
+bs_resume_load(const struct flash_area *fap)
+{
+    struct bs_resume_rec rec;
+    uint8_t buf[64];
+    uint32_t start;
+    uint32_t end;
+    uint32_t crc;
+    uint32_t crc_start;
+    uint32_t off;
+    uint32_t len;
+
+    resume_tried = true;
+    if (bs_resume_read(fap, &rec) || rec.img_size == 0 ||
+        rec.img_size > boot_status_off(fap) || rec.off > rec.img_size) {
+        return;
+    }
+
+    start = rec.off - rec.off % BS_RESUME_INTERVAL;
+    crc = 0;
+    crc_start = 0;
+    for (off = 0; off < rec.off; off += len) {
+        len = rec.off - off;
+        if (len > sizeof(buf)) {
+            len = sizeof(buf);
+        }
+        if (off < start && off + len > start) {
+            len = start - off;
+        }
+        if (flash_area_read(fap, off, buf, len)) {
+            return;
+        }
+        crc = bs_crc32(crc, buf, len);
+        if (off + len == start) {
+            crc_start = crc;
+        }
+    }
+    if (crc != rec.crc) {
+        BOOT_LOG_WRN("Upload progress does not match the slot contents");
+        return;
+    }
+
+    /*
+     * The next record is saved once the upload gets past the next interval,
+     * so the data written since then fits in two intervals, unless the
+     * records ran out and the upload went on without saving its progress.
+     * If the records ran out or the two intervals reach them, erase up to
+     * the end of the slot, records included, and save the progress again
+     * from the first record.
+     */
+    end = start + 2 * BS_RESUME_INTERVAL;
+    if (end > boot_status_off(fap) ||
+        resume_next + 1 >= bs_resume_slots(fap)) {
+        end = fap->fa_size;
+        resume_next = 0;
+    }
+    if (flash_area_erase(fap, start, end - start)) {
+        BOOT_LOG_ERR("Unable to erase the slot to resume the upload");
+        return;
+    }
+
+    img_size = rec.img_size;
+    curr_off = start;
+    img_crc = crc_start;
+    bs_resume_save(fap, img_size, curr_off, img_crc);
+    BOOT_LOG_INF("Resuming upload at 0x%x", curr_off);
+}
+
+/*
+ * Forget about the upload in progress, as a reset does, so that the next
+ * request picks it up from the progress records.
+ */
+void
+bs_upload_forget(void)
+{
+    curr_off = 0;
+    img_size = 0;
+    img_crc = 0;
+    resume_next = 0;
+    resume_tried = false;
+}
+#endif /* MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL */
+
+#ifdef MCUBOOT_SERIAL_UPLOAD_LZ4_MAX
+/*
+ * Decompress an LZ4 block (the raw block format, without the frame header)
+ * of exactly dlen bytes. Every chunk is compressed on its own, so matches
+ * never reach into an earlier chunk. Returns 0 on success.
+ */
+static int
+bs_lz4_decompress(const uint8_t *src, size_t slen, uint8_t *dst, size_t dlen)
+{
+    const uint8_t *send = src + slen;
+    size_t out = 0;
+    size_t len;
+    size_t dist;
+    uint8_t token;
+
+    while (src < send) {
+        token = *src++;
+
+        /* Literals, with 255 valued extension bytes for long runs. */
+        len = token >> 4;
+        if (len == 15) {
+            do {
+                if (src == send) {
+                    return -1;
+                }
+                len += *src;
+            } while (*src++ == 255);
+        }
+        if (len > (size_t)(send - src) || len > dlen - out) {
+            return -1;
+        }
+        memcpy(&dst[out], src, len);
+        src += len;
+        out += len;
+
+        /* The last sequence has no match. */
+        if (src == send) {
+            break;
+        }
+
+        if (send - src < 2) {
+            return -1;
+        }
+        dist = src[0] | (src[1] << 8);
+        src += 2;
+        if (dist == 0 || dist > out) {
+            return -1;
+        }
+
+        len = (token & 0x0f) + 4;
+        if (len == 15 + 4) {
+            do {
+                if (src == send) {
+                    return -1;
+                }
+                len += *src;
+            } while (*src++ == 255);
+        }
+        if (len > dlen - out) {
+            return -1;
+        }
+        /* The match may overlap the output, so copy byte by byte. */
+        for (; len > 0; len--, out++) {
+            dst[out] = dst[out - dist];
+        }
+    }
+
+    return out == dlen ? 0 : -1;
+}
+#endif /* MCUBOOT_SERIAL_UPLOAD_LZ4_MAX */
+
 /*
  * Image upload request.
  */
@@ -233,10 +531,15 @@ bs_upload(char *buf, int len)
     size_t img_blen = 0;
     uint8_t rem_bytes;
     long long int data_len = UINT_MAX;
+    long long int lz4_len = -1;
     int img_num;
     size_t slen;
     const struct flash_area *fap = NULL;
     int rc;
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+    const uint8_t *chunk;
+    uint32_t chunk_off;
+#endif
 #ifdef CONFIG_BOOT_ERASE_PROGRESSIVELY
     static off_t off_last = -1;
     struct flash_sector sector;
@@ -251,6 +554,7 @@ bs_upload(char *buf, int len)
      *   "data":<image data>
      *   "len":<image len>
      *   "off":<current offset of image data>
+     *   "lz4":<length of data once decompressed, if it is LZ4 compressed (OPTIONAL)>
      * }
      */
 
@@ -276,6 +580,12 @@ bs_upload(char *buf, int len)
             case _Member_off:
                 off = member->_Member_off;
                 break;
+            case _Member_lz4:
+                if (member->_Member_lz4 < 0) {
+                    goto out_invalid_data;
+                }
+                lz4_len = member->_Member_lz4;
+                break;
             case _Member_sha:
             default:
                 /* Nothing to do. */
@@ -290,12 +600,32 @@ bs_upload(char *buf, int len)
         goto out_invalid_data;
     }
 
+    if (lz4_len >= 0) {
+#ifdef MCUBOOT_SERIAL_UPLOAD_LZ4_MAX
+        /* The offsets and lengths are those of the decompressed image. */
+        if (lz4_len > sizeof(lz4_buf) ||
+            bs_lz4_decompress(img_data, img_blen, lz4_buf, lz4_len)) {
+            goto out_invalid_data;
+        }
+        img_data = lz4_buf;
+        img_blen = lz4_len;
+#else
+        goto out_invalid_data;
+#endif
+    }
+
     rc = flash_area_open(flash_area_id_from_multi_image_slot(img_num, 0), &fap);
     if (rc) {
         rc = MGMT_ERR_EINVAL;
         goto out;
     }
 
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+    if (off != 0 && !resume_tried) {
+        bs_resume_load(fap);
+    }
+#endif
+
     if (off == 0) {
         curr_off = 0;
         if (data_len > fap->fa_size) {
@@ -306,8 +636,24 @@ bs_upload(char *buf, int len)
         if (rc) {
             goto out_invalid_data;
         }
+#elif defined(MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+        /* Drop the progress records of an earlier upload. */
+        rc = flash_area_sector_from_off(boot_status_off(fap), &sector);
+        if (rc == 0) {
+            rc = flash_area_erase(fap, sector.fs_off,
+                                  fap->fa_size - sector.fs_off);
+        }
+        if (rc) {
+            goto out_invalid_data;
+        }
+        off_last = -1;
 #endif
         img_size = data_len;
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+        img_crc = 0;
+        resume_next = 0;
+        resume_tried = true;
+#endif
     }
     if (off != curr_off) {
         rc = 0;
@@ -344,6 +690,10 @@ bs_upload(char *buf, int len)
 #endif
 
     BOOT_LOG_INF("Writing at 0x%x until 0x%x", curr_off, curr_off + img_blen);
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+    chunk = img_data;
+    chunk_off = curr_off;
+#endif
     if (rem_bytes) {
         /* the last chunk of the image might be unaligned */
         uint8_t wbs_aligned[BOOT_MAX_ALIGN];
@@ -392,6 +742,15 @@ bs_upload(char *buf, int len)
                 }
             }
         }
+#endif
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+        img_crc = bs_crc32(img_crc, chunk, curr_off - chunk_off);
+        if (curr_off == img_size) {
+            bs_resume_save(fap, 0, curr_off, img_crc);
+        } else if (curr_off / BS_RESUME_INTERVAL !=
+                   chunk_off / BS_RESUME_INTERVAL) {
+            bs_resume_save(fap, img_size, curr_off, img_crc);
+        }
 #endif
     } else {
     out_invalid_data:
@@ -413,6 +772,64 @@ out:
     flash_area_close(fap);
 }
 
+/*
+ * Upload state request: report where the upload in progress, or the one
+ * interrupted by a reset, can be resumed from, and whether compressed chunks
+ * are accepted.
+ *
+ * Expected data format, the map may be empty.
+ * {
+ *   "image":<image number in a multi-image set (OPTIONAL)>
+ * }
+ */
+static void
+bs_upload_state(char *buf, int len)
+{
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+    const struct flash_area *fap;
+    Upload_t upload;
+    int img_num = 0;
+    int i;
+
+    if (len > 0 && cbor_decode_Upload((const uint8_t *)buf, len, &upload)) {
+        for (i = 0; i < upload._Upload_members_count; i++) {
+            if (upload._Upload_members[i]._Member_choice == _Member_image) {
+                img_num = upload._Upload_members[i]._Member_image;
+            }
+        }
+    }
+
+    if (!resume_tried &&
+        flash_area_open(flash_area_id_from_multi_image_slot(img_num, 0),
+                        &fap) == 0) {
+        bs_resume_load(fap);
+        flash_area_close(fap);
+    }
+#else
+    (void)buf;
+    (void)len;
+#endif
+
+    cbor_encoder_create_map(&bs_root, &bs_rsp, CborIndefiniteLength);
+    cbor_encode_text_stringz(&bs_rsp, "rc");
+    cbor_encode_int(&bs_rsp, 0);
+    cbor_encode_text_stringz(&bs_rsp, "off");
+    cbor_encode_uint(&bs_rsp, curr_off);
+    cbor_encode_text_stringz(&bs_rsp, "len");
+    cbor_encode_uint(&bs_rsp, img_size);
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+    cbor_encode_text_stringz(&bs_rsp, "crc");
+    cbor_encode_uint(&bs_rsp, img_crc);
+#endif
+#ifdef MCUBOOT_SERIAL_UPLOAD_LZ4_MAX
+    /* The largest chunk which can be sent LZ4 compressed. */
+    cbor_encode_text_stringz(&bs_rsp, "lz4");
+    cbor_encode_uint(&bs_rsp, sizeof(lz4_buf));
+#endif
+    cbor_encoder_close_container(&bs_root, &bs_rsp);
+    boot_serial_output();
+}
+
 /*
  * Console echo control/image erase. Send empty response, don't do anything.
  */
@@ -477,7 +894,11 @@ boot_serial_input(char *buf, int len)
             bs_list(buf, len);
             break;
         case IMGMGR_NMGR_ID_UPLOAD:
-            bs_upload(buf, len);
+            if (hdr->nh_op == NMGR_OP_READ) {
+                bs_upload_state(buf, len);
+            } else {
+                bs_upload(buf, len);
+            }
             break;
         default:
             bs_empty_rsp(buf, len);
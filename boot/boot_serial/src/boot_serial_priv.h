@@ -63,6 +63,9 @@ struct nmgr_hdr {
 #define IMGMGR_NMGR_ID_UPLOAD           1
 
 void boot_serial_input(char *buf, int len);
+#ifdef MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+void bs_upload_forget(void);
+#endif
 extern const struct boot_uart_funcs *boot_uf;
 
 #ifdef __cplusplus
@@ -39,7 +39,9 @@ static bool decode_Member(
 	|| ((p_state->p_payload = p_payload_bak) && ((p_state->elem_count = elem_count_bak) || 1) && (((strx_decode(p_state, &((*p_type_result)._Member_off_key), NULL, NULL))&& !memcmp("off", (*p_type_result)._Member_off_key.value, (*p_type_result)._Member_off_key.len)
 	&& (intx32_decode(p_state, &((*p_type_result)._Member_off), NULL, NULL))) && (((*p_type_result)._Member_choice = _Member_off) || 1)))
 	|| ((p_state->p_payload = p_payload_bak) && ((p_state->elem_count = elem_count_bak) || 1) && (((strx_decode(p_state, &((*p_type_result)._Member_sha_key), NULL, NULL))&& !memcmp("sha", (*p_type_result)._Member_sha_key.value, (*p_type_result)._Member_sha_key.len)
-	&& (strx_decode(p_state, &((*p_type_result)._Member_sha), NULL, NULL))) && (((*p_type_result)._Member_choice = _Member_sha) || 1))))));
+	&& (strx_decode(p_state, &((*p_type_result)._Member_sha), NULL, NULL))) && (((*p_type_result)._Member_choice = _Member_sha) || 1)))
+	|| ((p_state->p_payload = p_payload_bak) && ((p_state->elem_count = elem_count_bak) || 1) && (((strx_decode(p_state, &((*p_type_result)._Member_lz4_key), NULL, NULL))&& !memcmp("lz4", (*p_type_result)._Member_lz4_key.value, (*p_type_result)._Member_lz4_key.len)
+	&& (intx32_decode(p_state, &((*p_type_result)._Member_lz4), NULL, NULL))) && (((*p_type_result)._Member_choice = _Member_lz4) || 1))))));
 
 	if (!result)
 	{
@@ -58,8 +60,8 @@ static bool decode_Upload(
 	size_t *p_temp_elem_count = temp_elem_counts;
 	Upload_t* p_type_result = (Upload_t*)p_result;
 
-	bool result = (((list_start_decode(p_state, &(*(p_temp_elem_count++)), 1, 5))
-	&& multi_decode(1, 5, &(*p_type_result)._Upload_members_count, (void*)decode_Member, p_state, &((*p_type_result)._Upload_members), NULL, NULL, sizeof(_Member_t))
+	bool result = (((list_start_decode(p_state, &(*(p_temp_elem_count++)), 1, 6))
+	&& multi_decode(1, 6, &(*p_type_result)._Upload_members_count, (void*)decode_Member, p_state, &((*p_type_result)._Upload_members), NULL, NULL, sizeof(_Member_t))
 	&& ((p_state->elem_count = *(--p_temp_elem_count)) || 1)));
 
 	if (!result)
@@ -45,6 +45,10 @@ typedef struct {
 			cbor_string_type_t _Member_sha_key;
 			cbor_string_type_t _Member_sha;
 		};
+		struct {
+			cbor_string_type_t _Member_lz4_key;
+			int32_t _Member_lz4;
+		};
 	};
 	enum {
 		_Member_image,
@@ -52,11 +56,12 @@ typedef struct {
 		_Member_len,
 		_Member_off,
 		_Member_sha,
+		_Member_lz4,
 	} _Member_choice;
 } _Member_t;
 
 typedef struct {
-	_Member_t _Upload_members[5];
+	_Member_t _Upload_members[6];
 	size_t _Upload_members_count;
 } Upload_t;
 
@@ -39,6 +39,7 @@ TEST_CASE_DECL(boot_serial_empty_msg)
 TEST_CASE_DECL(boot_serial_empty_img_msg)
 TEST_CASE_DECL(boot_serial_img_msg)
 TEST_CASE_DECL(boot_serial_upload_bigger_image)
+TEST_CASE_DECL(boot_serial_upload_resume)
 
 static void
 test_uart_write(const char *str, int len)
@@ -62,6 +63,7 @@ TEST_SUITE(boot_serial_suite)
     boot_serial_empty_img_msg();
     boot_serial_img_msg();
     boot_serial_upload_bigger_image();
+    boot_serial_upload_resume();
 }
 
 int
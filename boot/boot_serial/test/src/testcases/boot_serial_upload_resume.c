@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <flash_map_backend/flash_map_backend.h>
+
+#include "boot_test.h"
+
+#if MYNEWT_VAL(BOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+
+#define RESUME_INTERVAL MYNEWT_VAL(BOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+#define CHUNK_LEN       128
+
+/*
+ * More resumes than there are progress records with any flash alignment:
+ * each resume saves one.
+ */
+#define RESUMES         400
+
+/* All of the slot but the interval which holds the trailer. */
+static uint32_t img_len;
+
+static uint8_t
+img_byte(uint32_t off)
+{
+    return (uint8_t)(off * 7 + (off >> 8));
+}
+
+static int
+cbor_uint(uint8_t *p, int major, uint32_t val)
+{
+    if (val < 24) {
+        p[0] = major << 5 | val;
+        return 1;
+    }
+    if (val < 0x100) {
+        p[0] = major << 5 | 24;
+        p[1] = val;
+        return 2;
+    }
+    if (val < 0x10000) {
+        p[0] = major << 5 | 25;
+        p[1] = val >> 8;
+        p[2] = val;
+        return 3;
+    }
+    p[0] = major << 5 | 26;
+    p[1] = val >> 24;
+    p[2] = val >> 16;
+    p[3] = val >> 8;
+    p[4] = val;
+    return 5;
+}
+
+static int
+cbor_str(uint8_t *p, const char *str)
+{
+    int len = cbor_uint(p, 3, strlen(str));
+
+    memcpy(p + len, str, strlen(str));
+    return len + strlen(str);
+}
+
+static void
+send_upload(int op, uint32_t off)
+{
+    char buf[sizeof(struct nmgr_hdr) + CHUNK_LEN + 32];
+    struct nmgr_hdr *hdr;
+    uint8_t *p;
+    uint32_t len;
+    uint32_t i;
+    int n = 0;
+
+    hdr = (struct nmgr_hdr *)buf;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->nh_op = op;
+    hdr->nh_group = htons(MGMT_GROUP_ID_IMAGE);
+    hdr->nh_id = IMGMGR_NMGR_ID_UPLOAD;
+    p = (uint8_t *)(hdr + 1);
+
+    if (op == NMGR_OP_READ) {
+        /* An upload state request. */
+        p[n++] = 0xa0;
+    } else {
+        len = img_len - off;
+        if (len > CHUNK_LEN) {
+            len = CHUNK_LEN;
+        }
+        p[n++] = 0xa0 | (off == 0 ? 3 : 2);
+        n += cbor_str(p + n, "data");
+        n += cbor_uint(p + n, 2, len);
+        for (i = 0; i < len; i++) {
+            p[n++] = img_byte(off + i);
+        }
+        if (off == 0) {
+            n += cbor_str(p + n, "len");
+            n += cbor_uint(p + n, 0, img_len);
+        }
+        n += cbor_str(p + n, "off");
+        n += cbor_uint(p + n, 0, off);
+    }
+    hdr->nh_len = htons(n);
+
+    tx_msg(buf, sizeof(*hdr) + n);
+}
+
+static void
+upload(uint32_t from, uint32_t to)
+{
+    uint32_t off;
+
+    for (off = from; off < to; off += CHUNK_LEN) {
+        send_upload(NMGR_OP_WRITE, off);
+    }
+}
+
+/* Reset, as far as the upload is concerned, and ask where to resume. */
+static void
+reset_and_resume(void)
+{
+    bs_upload_forget();
+    send_upload(NMGR_OP_READ, 0);
+}
+
+#endif
+
+/*
+ * Resume an upload which went on after the progress records ran out, and
+ * was interrupted well past the last record saved.
+ */
+TEST_CASE(boot_serial_upload_resume)
+{
+#if MYNEWT_VAL(BOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+    const struct flash_area *fap;
+    uint8_t buf[64];
+    uint32_t off;
+    int rc;
+    int i;
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_PRIMARY(0), &fap);
+    assert(rc == 0);
+    img_len = fap->fa_size - RESUME_INTERVAL;
+
+    /* Past the first interval, where the progress is saved. */
+    upload(0, RESUME_INTERVAL + CHUNK_LEN);
+
+    /* Every resume saves the progress again, until the records run out. */
+    for (i = 0; i < RESUMES; i++) {
+        reset_and_resume();
+    }
+
+    /* The upload gets nearly done without saving its progress. */
+    upload(RESUME_INTERVAL, img_len - CHUNK_LEN);
+
+    reset_and_resume();
+    upload(RESUME_INTERVAL, img_len);
+
+    for (off = 0; off < img_len; off += sizeof(buf)) {
+        rc = flash_area_read(fap, off, buf, sizeof(buf));
+        assert(rc == 0);
+        for (i = 0; i < sizeof(buf) && off + i < img_len; i++) {
+            assert(buf[i] == img_byte(off + i));
+        }
+    }
+    flash_area_close(fap);
+#endif
+}
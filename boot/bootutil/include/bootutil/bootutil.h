@@ -97,9 +97,23 @@ fih_int boot_go(struct boot_rsp *rsp);
 struct boot_loader_state;
 fih_int context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp);
 
+#ifdef MCUBOOT_STAGED_BOOT
+/*
+ * With a staged boot, boot_go() returns as soon as Image 0 and the images it
+ * depends on were checked; the images of MCUBOOT_DEFERRED_IMAGES are only
+ * checked by boot_go_deferred(), which must be called once after a successful
+ * boot_go(), before starting them. On return, bit N of failed is set if image
+ * N must not be started.
+ */
+fih_int boot_go_deferred(uint32_t *failed);
+fih_int context_boot_go_deferred(struct boot_loader_state *state,
+                                 uint32_t *failed);
+#endif
+
 int boot_swap_type_multi(int image_index);
 int boot_swap_type(void);
 
+int boot_set_pending_multi(int image_index, int permanent);
 int boot_set_pending(int permanent);
 int boot_set_confirmed(void);
 
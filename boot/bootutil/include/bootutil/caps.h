@@ -47,6 +47,15 @@ uint32_t bootutil_get_caps(void);
 #define BOOTUTIL_CAP_DOWNGRADE_PREVENTION   (1<<12)
 #define BOOTUTIL_CAP_ENC_X25519             (1<<13)
 #define BOOTUTIL_CAP_BOOTSTRAP              (1<<14)
+#define BOOTUTIL_CAP_HASH_BLOCKS            (1<<15)
+#define BOOTUTIL_CAP_LMS                    (1<<16)
+#define BOOTUTIL_CAP_SWAP_USING_OFFSET      (1<<17)
+#define BOOTUTIL_CAP_TRAILER_COMPACT        (1<<18)
+#define BOOTUTIL_CAP_STAGED_BOOT            (1<<19)
+#define BOOTUTIL_CAP_ERASE_SKIP_ERASED      (1<<20)
+#define BOOTUTIL_CAP_ENC_AEAD               (1<<21)
+#define BOOTUTIL_CAP_DIRECT_XIP             (1<<22)
+#define BOOTUTIL_CAP_WARM_BOOT              (1<<23)
 
 /*
  * Query the number of images this bootloader is configured for.  This
@@ -54,6 +63,18 @@ uint32_t bootutil_get_caps(void);
  */
 uint32_t bootutil_get_num_images(void);
 
+/*
+ * Query the number of slots per image this bootloader is configured for.
+ * This is also primarily used for testing.
+ */
+uint32_t bootutil_get_num_slots(void);
+
+/*
+ * Query the number of boot attempts given to an image which is not confirmed,
+ * 0 if the bootloader has no attempt counter.  Also primarily for testing.
+ */
+uint32_t bootutil_get_boot_attempts(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,171 @@
+/*
+ * This module provides a thin abstraction over some of the crypto
+ * primitives to make it easier to swap out the used crypto library.
+ *
+ * At this point, there are two choices: MCUBOOT_USE_MBED_TLS, or
+ * MCUBOOT_USE_TINYCRYPT.  It is a compile error there is not exactly
+ * one of these defined.
+ */
+
+#ifndef __BOOTUTIL_CRYPTO_AES_CMAC_H_
+#define __BOOTUTIL_CRYPTO_AES_CMAC_H_
+
+/*
+ * AES-CMAC (NIST SP 800-38B, RFC 4493) is built on the AES-128 of the
+ * AES-CTR backend, so it needs nothing more from the crypto library than
+ * image encryption does. The AES of one block is the first block of the CTR
+ * key stream, with that block as the counter. The key is kept by
+ * bootutil_aes_cmac_finish(), so several MACs can be computed after setting
+ * it once.
+ */
+#include "bootutil/crypto/aes_ctr.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOTUTIL_CRYPTO_AES_CMAC_KEY_SIZE   BOOTUTIL_CRYPTO_AES_CTR_KEY_SIZE
+#define BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE   BOOTUTIL_CRYPTO_AES_CTR_BLOCK_SIZE
+
+/* The constant of the subkey derivation, for a 128-bit block. */
+#define BOOTUTIL_AES_CMAC_RB 0x87
+
+typedef struct {
+    bootutil_aes_ctr_context aes;
+    uint8_t k1[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+    uint8_t k2[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+    /* The chaining value. */
+    uint8_t x[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+    /* The last block, which is only processed once more data comes in. */
+    uint8_t last[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+    uint8_t last_len;
+} bootutil_aes_cmac_context;
+
+static inline void bootutil_aes_cmac_init(bootutil_aes_cmac_context *ctx)
+{
+    bootutil_aes_ctr_init(&ctx->aes);
+}
+
+static inline void bootutil_aes_cmac_drop(bootutil_aes_cmac_context *ctx)
+{
+    bootutil_aes_ctr_drop(&ctx->aes);
+    memset(ctx->k1, 0, sizeof(ctx->k1));
+    memset(ctx->k2, 0, sizeof(ctx->k2));
+    memset(ctx->x, 0, sizeof(ctx->x));
+    memset(ctx->last, 0, sizeof(ctx->last));
+}
+
+/* Replace `block` with its AES. */
+static inline int _bootutil_aes_cmac_cipher(bootutil_aes_cmac_context *ctx, uint8_t *block)
+{
+    uint8_t counter[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+
+    memcpy(counter, block, sizeof(counter));
+    memset(block, 0, sizeof(counter));
+    return bootutil_aes_ctr_encrypt(&ctx->aes, counter, block, sizeof(counter), 0, block);
+}
+
+/* Multiply `in` by x in GF(2^128). */
+static inline void _bootutil_aes_cmac_double(const uint8_t *in, uint8_t *out)
+{
+    uint8_t carry;
+    int i;
+
+    carry = (in[0] & 0x80) ? BOOTUTIL_AES_CMAC_RB : 0;
+    for (i = 0; i < BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE - 1; i++) {
+        out[i] = (uint8_t)((in[i] << 1) | (in[i + 1] >> 7));
+    }
+    out[i] = (uint8_t)(in[i] << 1) ^ carry;
+}
+
+static inline int bootutil_aes_cmac_set_key(bootutil_aes_cmac_context *ctx, const uint8_t *k)
+{
+    uint8_t l[BOOTUTIL_CRYPTO_AES_CMAC_TAG_SIZE];
+    int rc;
+
+    rc = bootutil_aes_ctr_set_key(&ctx->aes, k);
+    if (rc != 0) {
+        return -1;
+    }
+
+    memset(l, 0, sizeof(l));
+    rc = _bootutil_aes_cmac_cipher(ctx, l);
+    if (rc != 0) {
+        return -1;
+    }
+    _bootutil_aes_cmac_double(l, ctx->k1);
+    _bootutil_aes_cmac_double(ctx->k1, ctx->k2);
+    memset(l, 0, sizeof(l));
+
+    memset(ctx->x, 0, sizeof(ctx->x));
+    ctx->last_len = 0;
+    return 0;
+}
+
+static inline int bootutil_aes_cmac_update(bootutil_aes_cmac_context *ctx, const uint8_t *data, uint32_t len)
+{
+    uint32_t n;
+    int i;
+
+    while (len > 0) {
+        if (ctx->last_len == sizeof(ctx->last)) {
+            for (i = 0; i < (int)sizeof(ctx->x); i++) {
+                ctx->x[i] ^= ctx->last[i];
+            }
+            if (_bootutil_aes_cmac_cipher(ctx, ctx->x) != 0) {
+                return -1;
+            }
+            ctx->last_len = 0;
+        }
+
+        n = sizeof(ctx->last) - ctx->last_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&ctx->last[ctx->last_len], data, n);
+        ctx->last_len += n;
+        data += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+static inline int bootutil_aes_cmac_finish(bootutil_aes_cmac_context *ctx, uint8_t *tag)
+{
+    const uint8_t *k;
+    int rc;
+    int i;
+
+    if (ctx->last_len == sizeof(ctx->last)) {
+        k = ctx->k1;
+    } else {
+        k = ctx->k2;
+        ctx->last[ctx->last_len] = 0x80;
+        memset(&ctx->last[ctx->last_len + 1], 0,
+               sizeof(ctx->last) - ctx->last_len - 1);
+    }
+
+    for (i = 0; i < (int)sizeof(ctx->x); i++) {
+        ctx->x[i] ^= ctx->last[i] ^ k[i];
+    }
+    rc = _bootutil_aes_cmac_cipher(ctx, ctx->x);
+    if (rc == 0) {
+        memcpy(tag, ctx->x, sizeof(ctx->x));
+    }
+
+    /* Ready for the next MAC under the same key. */
+    memset(ctx->x, 0, sizeof(ctx->x));
+    memset(ctx->last, 0, sizeof(ctx->last));
+    ctx->last_len = 0;
+    return rc != 0 ? -1 : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOTUTIL_CRYPTO_AES_CMAC_H_ */
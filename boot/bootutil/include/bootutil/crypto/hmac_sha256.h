@@ -2,9 +2,9 @@
  * This module provides a thin abstraction over some of the crypto
  * primitives to make it easier to swap out the used crypto library.
  *
- * At this point, there are two choices: MCUBOOT_USE_MBED_TLS, or
- * MCUBOOT_USE_TINYCRYPT.  It is a compile error there is not exactly
- * one of these defined.
+ * At this point, there are three choices: MCUBOOT_USE_MBED_TLS,
+ * MCUBOOT_USE_TINYCRYPT or MCUBOOT_USE_CC310.  It is a compile error there
+ * is not exactly one of these defined.
  */
 
 #ifndef __BOOTUTIL_CRYPTO_HMAC_SHA256_H_
@@ -12,69 +12,132 @@
 
 #include "mcuboot_config/mcuboot_config.h"
 
-#if (defined(MCUBOOT_USE_TINYCRYPT)) != 1
-    #error "One crypto backend must be defined: TINYCRYPT"
+#if (defined(MCUBOOT_USE_MBED_TLS) + \
+     defined(MCUBOOT_USE_TINYCRYPT) + \
+     defined(MCUBOOT_USE_CC310)) != 1
+    #error "One crypto backend must be defined: either CC310, MBED_TLS or TINYCRYPT"
 #endif
 
-#if defined(MCUBOOT_USE_TINYCRYPT)
-    #include <tinycrypt/sha256.h>
-    #include <tinycrypt/utils.h>
-    #include <tinycrypt/constants.h>
-    #include <tinycrypt/hmac.h>
-#endif /* MCUBOOT_USE_TINYCRYPT */
+/*
+ * HMAC is built on the SHA-256 of the selected backend. The key is absorbed
+ * when it is set: the context keeps the SHA-256 states after the inner and
+ * the outer padded key blocks. A keyed context can be copied with
+ * bootutil_hmac_sha256_clone() to compute several MACs under the same key,
+ * each of which then costs two compressions less than setting the key again.
+ */
+#include "bootutil/crypto/sha256.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#if defined(MCUBOOT_USE_TINYCRYPT)
-typedef struct tc_hmac_state_struct bootutil_hmac_sha256_context;
+#define BOOTUTIL_HMAC_SHA256_IPAD 0x36
+#define BOOTUTIL_HMAC_SHA256_OPAD 0x5c
+
+typedef struct {
+    bootutil_sha256_context inner;
+    bootutil_sha256_context outer;
+} bootutil_hmac_sha256_context;
+
+/*
+ * The states are initialized here, even though setting the key starts them
+ * again, so that a context can always be dropped once it was initialized.
+ */
 static inline void bootutil_hmac_sha256_init(bootutil_hmac_sha256_context *ctx)
 {
-    (void)ctx;
+    bootutil_sha256_init(&ctx->inner);
+    bootutil_sha256_init(&ctx->outer);
 }
 
 static inline void bootutil_hmac_sha256_drop(bootutil_hmac_sha256_context *ctx)
 {
-    (void)ctx;
+    bootutil_sha256_drop(&ctx->inner);
+    bootutil_sha256_drop(&ctx->outer);
 }
 
+/*
+ * The return values of the SHA-256 backends are not uniform (TinyCrypt
+ * returns 1 on success), and none of them fails on valid arguments, so
+ * they are not checked here, like everywhere else in bootutil.
+ */
 static inline int bootutil_hmac_sha256_set_key(bootutil_hmac_sha256_context *ctx, const uint8_t *key, unsigned int key_size)
 {
-    int rc;
-    rc = tc_hmac_set_key(ctx, key, key_size);
-    if (rc != TC_CRYPTO_SUCCESS) {
+    uint8_t block[BOOTUTIL_CRYPTO_SHA256_BLOCK_SIZE];
+    unsigned int i;
+
+    if (key == NULL || key_size == 0) {
         return -1;
     }
-    rc = tc_hmac_init(ctx);
-    if (rc != TC_CRYPTO_SUCCESS) {
-        return -1;
+
+    memset(block, 0, sizeof(block));
+    if (key_size > BOOTUTIL_CRYPTO_SHA256_BLOCK_SIZE) {
+        bootutil_sha256_init(&ctx->inner);
+        (void)bootutil_sha256_update(&ctx->inner, key, key_size);
+        (void)bootutil_sha256_finish(&ctx->inner, block);
+    } else {
+        memcpy(block, key, key_size);
+    }
+
+    for (i = 0; i < sizeof(block); i++) {
+        block[i] ^= BOOTUTIL_HMAC_SHA256_IPAD;
     }
+    bootutil_sha256_init(&ctx->inner);
+    (void)bootutil_sha256_update(&ctx->inner, block, sizeof(block));
+
+    for (i = 0; i < sizeof(block); i++) {
+        block[i] ^= BOOTUTIL_HMAC_SHA256_IPAD ^ BOOTUTIL_HMAC_SHA256_OPAD;
+    }
+    bootutil_sha256_init(&ctx->outer);
+    (void)bootutil_sha256_update(&ctx->outer, block, sizeof(block));
+
+    memset(block, 0, sizeof(block));
     return 0;
 }
 
+/*
+ * Start a new MAC in `dst` with the key of `src`, which must not have been
+ * updated since its key was set.
+ */
+static inline void bootutil_hmac_sha256_clone(bootutil_hmac_sha256_context *dst, const bootutil_hmac_sha256_context *src)
+{
+    bootutil_sha256_clone(&dst->inner, &src->inner);
+    bootutil_sha256_clone(&dst->outer, &src->outer);
+}
+
 static inline int bootutil_hmac_sha256_update(bootutil_hmac_sha256_context *ctx, const void *data, unsigned int data_length)
 {
-    int rc;
-    rc = tc_hmac_update(ctx, data, data_length);
-    if (rc != TC_CRYPTO_SUCCESS) {
+    if (data == NULL && data_length != 0) {
         return -1;
     }
+    (void)bootutil_sha256_update(&ctx->inner, data, data_length);
     return 0;
 }
 
 static inline int bootutil_hmac_sha256_finish(bootutil_hmac_sha256_context *ctx, uint8_t *tag, unsigned int taglen)
 {
-    int rc;
-    rc = tc_hmac_final(tag, taglen, ctx);
-    if (rc != TC_CRYPTO_SUCCESS) {
+    uint8_t digest[BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE];
+
+    if (tag == NULL || taglen > sizeof(digest)) {
         return -1;
     }
+
+    (void)bootutil_sha256_finish(&ctx->inner, digest);
+
+    /*
+     * Finish in the inner state, so the keyed outer state stays intact; the
+     * clone also wakes up a backend which powers down after each hash.
+     */
+    bootutil_sha256_clone(&ctx->inner, &ctx->outer);
+    (void)bootutil_sha256_update(&ctx->inner, digest, sizeof(digest));
+    (void)bootutil_sha256_finish(&ctx->inner, digest);
+
+    memcpy(tag, digest, taglen);
+    memset(digest, 0, sizeof(digest));
     return 0;
 }
-#endif /* MCUBOOT_USE_TINYCRYPT */
 
 #ifdef __cplusplus
 }
@@ -66,6 +66,12 @@ static inline void bootutil_sha256_drop(bootutil_sha256_context *ctx)
     (void)ctx;
 }
 
+static inline void bootutil_sha256_clone(bootutil_sha256_context *dst,
+                                         const bootutil_sha256_context *src)
+{
+    mbedtls_sha256_clone(dst, src);
+}
+
 static inline int bootutil_sha256_update(bootutil_sha256_context *ctx,
                                          const void *data,
                                          uint32_t data_len)
@@ -92,6 +98,12 @@ static inline void bootutil_sha256_drop(bootutil_sha256_context *ctx)
     (void)ctx;
 }
 
+static inline void bootutil_sha256_clone(bootutil_sha256_context *dst,
+                                         const bootutil_sha256_context *src)
+{
+    *dst = *src;
+}
+
 static inline int bootutil_sha256_update(bootutil_sha256_context *ctx,
                                          const void *data,
                                          uint32_t data_len)
@@ -118,6 +130,14 @@ static inline void bootutil_sha256_drop(bootutil_sha256_context *ctx)
     nrf_cc310_disable();
 }
 
+/* The hash state lives in the context, the CryptoCell only has to be on. */
+static inline void bootutil_sha256_clone(bootutil_sha256_context *dst,
+                                         const bootutil_sha256_context *src)
+{
+    *dst = *src;
+    nrf_cc310_enable();
+}
+
 static inline int bootutil_sha256_update(bootutil_sha256_context *ctx,
                                           const void *data,
                                           uint32_t data_len)
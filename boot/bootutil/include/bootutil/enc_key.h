@@ -58,9 +58,20 @@ extern "C" {
 #define BOOT_ENC_TLV_ALIGN_SIZE \
     ((((BOOT_ENC_TLV_SIZE - 1) / BOOT_MAX_ALIGN) + 1) * BOOT_MAX_ALIGN)
 
+/* The IMAGE_TLV_ENC_AEAD TLV: key check value, tag and plaintext SHA256. */
+#define BOOT_ENC_AEAD_KCV_SIZE  16
+#define BOOT_ENC_AEAD_TAG_SIZE  16
+#define BOOT_ENC_AEAD_TLV_SIZE  \
+    (BOOT_ENC_AEAD_KCV_SIZE + BOOT_ENC_AEAD_TAG_SIZE + 32)
+
 struct enc_key_data {
     uint8_t valid;
     bootutil_aes_ctr_context aes_ctr;
+#if defined(MCUBOOT_ENC_AEAD)
+    /* Derived from the image key by boot_enc_set_key(). */
+    uint8_t mac_key[BOOT_ENC_KEY_SIZE];
+    uint8_t kcv[BOOT_ENC_AEAD_KCV_SIZE];
+#endif
 };
 
 extern const struct bootutil_key bootutil_enc_key;
@@ -80,6 +91,11 @@ void boot_encrypt(struct enc_key_data *enc_state, int image_index,
         const struct flash_area *fap, uint32_t off, uint32_t sz,
         uint32_t blk_off, uint8_t *buf);
 void boot_enc_zeroize(struct enc_key_data *enc_state);
+#if defined(MCUBOOT_ENC_AEAD)
+int boot_enc_mac(struct enc_key_data *enc_state, int image_index,
+        const struct flash_area *fap, uint32_t off, uint32_t sz,
+        uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *kcv, uint8_t *tag);
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file flash_cache.h
+ *
+ * Read cache between bootutil and the flash map backend.
+ *
+ * When MCUBOOT_FLASH_CACHE is defined, bootutil reads go through a small LRU
+ * cache of flash pages which is kept coherent with the writes and erases
+ * done by bootutil. It is configured with:
+ *
+ * - MCUBOOT_FLASH_CACHE_PAGE_SIZE: the size of a cache page in bytes, a
+ *   power of two (default 256). Reads of at least a page bypass the cache.
+ * - MCUBOOT_FLASH_CACHE_PAGES: the number of cache pages (default 8).
+ * - MCUBOOT_FLASH_CACHE_AREA_FILTER(fap): an expression which is true for
+ *   the flash areas to cache (default: all of them), for example
+ *   `((fap)->fa_device_id != FLASH_DEVICE_INTERNAL_FLASH)`.
+ */
+
+#ifndef H_BOOTUTIL_FLASH_CACHE_
+#define H_BOOTUTIL_FLASH_CACHE_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct flash_area;
+
+struct boot_flash_cache_stats {
+    uint32_t hits;      /* Page lookups served from the cache. */
+    uint32_t misses;    /* Page lookups which had to read the flash. */
+    uint32_t bypassed;  /* Reads which did not go through the cache. */
+};
+
+/**
+ * Cached equivalents of flash_area_read(), flash_area_write() and
+ * flash_area_erase(). Bootutil calls them in place of the backend functions
+ * when the cache is enabled.
+ */
+int boot_flash_cache_read(const struct flash_area *fap, uint32_t off,
+                          void *dst, uint32_t len);
+int boot_flash_cache_write(const struct flash_area *fap, uint32_t off,
+                           const void *src, uint32_t len);
+int boot_flash_cache_erase(const struct flash_area *fap, uint32_t off,
+                           uint32_t len);
+
+/**
+ * Drops every cached page. Must be called if the flash is modified other
+ * than through bootutil.
+ */
+void boot_flash_cache_invalidate(void);
+
+/**
+ * Reads the hit and miss counters accumulated since the last reset.
+ */
+void boot_flash_cache_get_stats(struct boot_flash_cache_stats *stats);
+
+/**
+ * Clears the hit and miss counters.
+ */
+void boot_flash_cache_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BOOTUTIL_FLASH_CACHE_ */
@@ -58,6 +58,19 @@ struct flash_area;
  * ih_load_addr field of the header.
  */
 #define IMAGE_F_RAM_LOAD                 0x00000020
+/*
+ * Indicates that the image is hashed in fixed-size blocks: the SHA256 TLV
+ * holds the hash of the IMAGE_TLV_SHA256_BLOCKS payload instead of the hash
+ * of the image itself.
+ */
+#define IMAGE_F_HASH_BLOCKS              0x00000040
+/*
+ * Indicates that the payload of an encrypted image is authenticated: the
+ * protected IMAGE_TLV_ENC_AEAD TLV holds a tag of the ciphertext and the
+ * SHA256 of the plaintext, and the SHA256 TLV holds the hash of the header
+ * and of the protected TLVs only.
+ */
+#define IMAGE_F_AEAD                     0x00000080
 
 /*
  * ECSDA224 is with NIST P-224
@@ -77,15 +90,21 @@ struct flash_area;
 #define IMAGE_TLV_KEYHASH           0x01   /* hash of the public key */
 #define IMAGE_TLV_PUBKEY            0x02   /* public key */
 #define IMAGE_TLV_SHA256            0x10   /* SHA256 of image hdr and body */
+#define IMAGE_TLV_SHA256_BLOCKS     0x13   /* Block size and SHA256 of each
+                                              block of hdr and body */
 #define IMAGE_TLV_RSA2048_PSS       0x20   /* RSA2048 of hash output */
 #define IMAGE_TLV_ECDSA224          0x21   /* ECDSA of hash output */
 #define IMAGE_TLV_ECDSA256          0x22   /* ECDSA of hash output */
 #define IMAGE_TLV_RSA3072_PSS       0x23   /* RSA3072 of hash output */
 #define IMAGE_TLV_ED25519           0x24   /* ed25519 of hash output */
+#define IMAGE_TLV_LMS               0x25   /* LMS of hash output */
 #define IMAGE_TLV_ENC_RSA2048       0x30   /* Key encrypted with RSA-OAEP-2048 */
 #define IMAGE_TLV_ENC_KW128         0x31   /* Key encrypted with AES-KW-128 */
 #define IMAGE_TLV_ENC_EC256         0x32   /* Key encrypted with ECIES-EC256 */
 #define IMAGE_TLV_ENC_X25519        0x33   /* Key encrypted with ECIES-X25519 */
+#define IMAGE_TLV_ENC_AEAD          0x34   /* Key check value, AES-CMAC of the
+                                              ciphertext, SHA256 of the
+                                              plaintext */
 #define IMAGE_TLV_DEPENDENCY        0x40   /* Image depends on other image */
 #define IMAGE_TLV_SEC_CNT           0x50   /* security counter */
 #define IMAGE_TLV_BOOT_RECORD       0x60   /* measured boot record */
@@ -173,6 +192,12 @@ int bootutil_tlv_iter_begin(struct image_tlv_iter *it,
 int bootutil_tlv_iter_next(struct image_tlv_iter *it, uint32_t *off,
                            uint16_t *len, uint16_t *type);
 
+int bootutil_img_check_blocks(struct enc_key_data *enc_state, int image_index,
+                              struct image_header *hdr,
+                              const struct flash_area *fap,
+                              uint8_t *tmp_buf, uint32_t tmp_buf_sz,
+                              uint32_t off, uint32_t len);
+
 int32_t bootutil_get_img_security_cnt(struct image_header *hdr,
                                       const struct flash_area *fap,
                                       uint32_t *security_cnt);
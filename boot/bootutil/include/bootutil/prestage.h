@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file prestage.h
+ *
+ * Preparation of an upgrade by the running image.
+ *
+ * These functions are called by the image, not by the boot loader, once a
+ * new image was written to a secondary slot. They check the new image and
+ * erase the sectors which the upgrade will write but which hold nothing,
+ * while the device is still in service, and then mark the upgrade pending.
+ * A boot loader built with MCUBOOT_ERASE_SKIP_ERASED does not erase those
+ * sectors again, which shortens the upgrade at the next reset. The boot
+ * loader still validates the image itself: nothing done here is trusted.
+ *
+ * All of this can be interrupted by a reset at any point, and called again.
+ */
+
+#ifndef H_BOOTUTIL_PRESTAGE_
+#define H_BOOTUTIL_PRESTAGE_
+
+#include <stdint.h>
+
+#include "bootutil/fault_injection_hardening.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Validates the image in the secondary slot of an image, as the boot loader
+ * will before upgrading to it. Encrypted images can't be checked here.
+ *
+ * @param image_index   The image to check.
+ * @param tmp_buf       A buffer for reading the image.
+ * @param tmp_buf_sz    The size of tmp_buf.
+ *
+ * @return              FIH_SUCCESS if the image is valid.
+ */
+fih_int boot_prestage_validate(int image_index, uint8_t *tmp_buf,
+                               uint32_t tmp_buf_sz);
+
+/**
+ * Erases the sectors of the slots of an image, and of the scratch area,
+ * which the upgrade to the image in the secondary slot erases before writing
+ * to them but which hold no part of an image nor of a trailer.
+ *
+ * @param image_index   The image to upgrade.
+ *
+ * @return              0 on success; nonzero on failure.
+ */
+int boot_prestage_erase(int image_index);
+
+/**
+ * Prepares the upgrade to the image in the secondary slot of an image:
+ * validates it, erases the sectors of boot_prestage_erase() and marks it
+ * pending, as boot_set_pending_multi() does.
+ *
+ * @param image_index   The image to upgrade.
+ * @param permanent     0 to test the image once; 1 to run it forever.
+ * @param tmp_buf       A buffer for reading the image.
+ * @param tmp_buf_sz    The size of tmp_buf.
+ *
+ * @return              0 on success; BOOT_EBADIMAGE if the image is not
+ *                      valid; another nonzero value on failure.
+ */
+int boot_prestage(int image_index, int permanent, uint8_t *tmp_buf,
+                  uint32_t tmp_buf_sz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BOOTUTIL_PRESTAGE_ */
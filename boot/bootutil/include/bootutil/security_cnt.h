@@ -63,6 +63,27 @@ fih_int boot_nv_security_counter_get(uint32_t image_id, fih_int *security_cnt);
 int32_t boot_nv_security_counter_update(uint32_t image_id,
                                         uint32_t img_security_cnt);
 
+#ifdef MCUBOOT_NV_SECURITY_COUNTER_BATCH
+/**
+ * Updates the stored values of several security counters in one operation.
+ * Only provided by platforms which define MCUBOOT_NV_SECURITY_COUNTER_BATCH;
+ * the boot loader calls it at most once per boot, with all the updates that
+ * were staged during the boot.
+ *
+ * @param img_security_cnt  New security counter values, indexed by image id.
+ *                          Each value to update follows the same rules as
+ *                          for boot_nv_security_counter_update().
+ * @param image_cnt         Number of elements in img_security_cnt.
+ * @param update_mask       Bit i is set if the counter of image i must be
+ *                          updated; the other values must be ignored.
+ *
+ * @return                  0 on success; nonzero on failure.
+ */
+int32_t boot_nv_security_counter_update_batch(const uint32_t *img_security_cnt,
+                                              uint32_t image_cnt,
+                                              uint32_t update_mask);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
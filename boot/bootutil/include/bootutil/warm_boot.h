@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file warm_boot.h
+ *
+ * Boot state kept in retained RAM across warm resets.
+ *
+ * When MCUBOOT_WARM_BOOT is defined, the boot loader records its decision in
+ * a block of RAM which is not initialized at reset, just before handing over
+ * to the image. After a warm reset which did not change the flash, the next
+ * boot returns the recorded decision without reading the image slots. The
+ * platform provides the functions declared at the end of this file.
+ */
+
+#ifndef H_BOOTUTIL_WARM_BOOT_
+#define H_BOOTUTIL_WARM_BOOT_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+#include "bootutil/image.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef MCUBOOT_IMAGE_NUMBER
+#define BOOT_WARM_IMAGES        MCUBOOT_IMAGE_NUMBER
+#else
+#define BOOT_WARM_IMAGES        1
+#endif
+
+#define BOOT_WARM_MAGIC         0x4d524157 /* "WARM" */
+#define BOOT_WARM_MAC_SZ        32
+
+/* The trailer of one slot, as read by boot_read_swap_state(). */
+struct boot_warm_trailer {
+    uint8_t magic;
+    uint8_t swap_type;
+    uint8_t copy_done;
+    uint8_t image_ok;
+};
+
+struct boot_warm_image {
+    /* Header of the image in the primary slot, validated by the boot. */
+    struct image_header hdr;
+    /* Trailers of the primary and the secondary slot at handoff. */
+    struct boot_warm_trailer trailer[2];
+};
+
+/**
+ * Boot state recorded at handoff. The MAC is an HMAC-SHA256 of the fields
+ * before it, under the key of boot_warm_key(); the CRC is a CRC-32C of all
+ * the fields before it, which rejects the content of RAM after a power-up
+ * without computing the MAC.
+ */
+struct boot_warm_state {
+    uint32_t magic;
+    uint32_t generation;    /* boot_warm_flash_generation() at handoff. */
+    uint32_t image_off;     /* br_image_off of the boot response. */
+    uint8_t flash_dev_id;   /* br_flash_dev_id of the boot response. */
+    uint8_t pad[3];
+    struct boot_warm_image images[BOOT_WARM_IMAGES];
+    uint8_t mac[BOOT_WARM_MAC_SZ];
+    uint32_t crc;
+};
+
+/**
+ * Returns the block of retained RAM holding the boot state. It must not be
+ * initialized at reset, nor used by the image for anything else.
+ *
+ * @return              The retained block; NULL if there is none.
+ */
+struct boot_warm_state *boot_warm_retained_state(void);
+
+/**
+ * Tells if the last reset kept the content of RAM and left the flash as it
+ * was when the previous boot handed over, e.g. a software reset or a
+ * watchdog reset. Power-on, brown-out and pin resets are cold.
+ *
+ * @return              true if the reset was warm.
+ */
+bool boot_warm_reset(void);
+
+/**
+ * Returns a counter which changes whenever the flash holding the image
+ * slots or their trailers is written or erased, by the boot loader or by
+ * the image, e.g. a count kept by the flash driver in retained RAM.
+ *
+ * @return              The current flash generation.
+ */
+uint32_t boot_warm_flash_generation(void);
+
+/**
+ * Returns the key of the MAC of the boot state. It must be readable by the
+ * boot loader only, so that the image can't forge a state.
+ *
+ * @param[out] key_len  The size of the key in bytes.
+ *
+ * @return              The key; NULL if there is none.
+ */
+const uint8_t *boot_warm_key(uint32_t *key_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BOOTUTIL_WARM_BOOT_ */
@@ -156,6 +156,26 @@ out:
 }
 #endif
 
+#if !defined(MCUBOOT_WATCHDOG_POLL) && defined(MCUBOOT_WATCHDOG_TICKS)
+/*
+ * Feed the watchdog if MCUBOOT_WATCHDOG_FEED_TICKS have passed since it was
+ * last fed here. Reading the tick counter is cheap, so this can be called
+ * for every block of a copy or a hash.
+ */
+void
+boot_wdt_poll(void)
+{
+    static uint32_t last_feed;
+    uint32_t now;
+
+    now = MCUBOOT_WATCHDOG_TICKS();
+    if ((uint32_t)(now - last_feed) >= MCUBOOT_WATCHDOG_FEED_TICKS) {
+        MCUBOOT_WATCHDOG_FEED();
+        last_feed = now;
+    }
+}
+#endif
+
 #ifndef MCUBOOT_SWAP_USING_STATUS
 
 static int
@@ -205,8 +225,15 @@ boot_magic_compatible_check(uint8_t tbl_val, uint8_t val)
 uint32_t
 boot_status_sz(uint32_t min_write_sz)
 {
+#ifdef MCUBOOT_TRAILER_COMPACT
+    /* The fields after the status area stay aligned for any write size. */
+    (void)min_write_sz;
+    return BOOT_STATUS_ENTRIES_SZ(BOOT_STATUS_MAX_ENTRIES *
+                                  BOOT_STATUS_STATE_COUNT, BOOT_MAX_ALIGN);
+#else
     return /* state for all sectors */
            BOOT_STATUS_MAX_ENTRIES * BOOT_STATUS_STATE_COUNT * min_write_sz;
+#endif
 }
 
 uint32_t
@@ -222,8 +249,13 @@ boot_trailer_sz(uint32_t min_write_sz)
            BOOT_ENC_KEY_SIZE * 2                  +
 #  endif
 #endif
+#ifdef MCUBOOT_TRAILER_COMPACT
+           /* swap_size + swap_type + copy_done + image_ok, in one unit */
+           BOOT_MAX_ALIGN                         +
+#else
            /* swap_type + copy_done + image_ok + swap_size */
            BOOT_MAX_ALIGN * 4                     +
+#endif
            BOOT_MAGIC_SZ;
 }
 
@@ -266,6 +298,36 @@ boot_magic_off(const struct flash_area *fap)
 
 #ifndef MCUBOOT_SWAP_USING_STATUS
 
+#ifdef MCUBOOT_TRAILER_COMPACT
+/*
+ * The compact trailer packs swap_size, swap_info, copy_done and image_ok, in
+ * this order, into the write unit before the magic. Each of them is added by
+ * programming the unit again, see boot_write_trailer().
+ */
+static inline uint32_t
+boot_swap_size_off(const struct flash_area *fap)
+{
+    return boot_magic_off(fap) - BOOT_MAX_ALIGN;
+}
+
+uint32_t
+boot_swap_info_off(const struct flash_area *fap)
+{
+    return boot_swap_size_off(fap) + sizeof(uint32_t);
+}
+
+static inline uint32_t
+boot_copy_done_off(const struct flash_area *fap)
+{
+    return boot_swap_info_off(fap) + 1;
+}
+
+static inline uint32_t
+boot_image_ok_off(const struct flash_area *fap)
+{
+    return boot_copy_done_off(fap) + 1;
+}
+#else
 static inline uint32_t
 boot_image_ok_off(const struct flash_area *fap)
 {
@@ -289,6 +351,7 @@ boot_swap_size_off(const struct flash_area *fap)
 {
     return boot_swap_info_off(fap) - BOOT_MAX_ALIGN;
 }
+#endif /* MCUBOOT_TRAILER_COMPACT */
 #endif
 
 #ifdef MCUBOOT_ENC_IMAGES
@@ -308,15 +371,34 @@ bool bootutil_buffer_is_erased(const struct flash_area *area,
                                const void *buffer, size_t len)
 {
     size_t i;
-    uint8_t *u8b;
+    const uint8_t *u8b;
     uint8_t erased_val;
+    uint32_t erased_word;
+    uint32_t word;
 
     if (buffer == NULL || len == 0) {
         return false;
     }
 
     erased_val = flash_area_erased_val(area);
-    for (i = 0, u8b = (uint8_t *)buffer; i < len; i++) {
+    u8b = (const uint8_t *)buffer;
+
+    /* Compare a word at a time once the buffer is aligned. */
+    for (i = 0; i < len && ((uintptr_t)&u8b[i] % sizeof(word)) != 0; i++) {
+        if (u8b[i] != erased_val) {
+            return false;
+        }
+    }
+
+    erased_word = erased_val * UINT32_C(0x01010101);
+    for (; len - i >= sizeof(word); i += sizeof(word)) {
+        memcpy(&word, &u8b[i], sizeof(word));
+        if (word != erased_word) {
+            return false;
+        }
+    }
+
+    for (; i < len; i++) {
         if (u8b[i] != erased_val) {
             return false;
         }
@@ -330,60 +412,58 @@ int
 boot_read_swap_state(const struct flash_area *fap,
                      struct boot_swap_state *state)
 {
+    /* swap_info, copy_done, image_ok and magic, up to the end of the area. */
+    uint8_t buf[BOOT_MAX_ALIGN * 3 + BOOT_MAGIC_SZ];
     uint32_t magic[BOOT_MAGIC_ARR_SZ];
     uint32_t off;
-    uint8_t swap_info;
+    uint32_t len;
+    uint8_t *swap_info;
+    uint8_t *copy_done;
+    uint8_t *image_ok;
     int rc;
 
-    off = boot_magic_off(fap);
-    rc = flash_area_read(fap, off, magic, BOOT_MAGIC_SZ);
+    /* The fields are adjacent, so fetch them in a single read: on external
+     * flash the per-transaction overhead outweighs the few extra bytes.
+     */
+    off = boot_swap_info_off(fap);
+    len = fap->fa_size - off;
+    assert(len <= sizeof buf);
+    rc = flash_area_read(fap, off, buf, len);
     if (rc < 0) {
         return BOOT_EFLASH;
     }
+
+    swap_info = &buf[0];
+    copy_done = &buf[boot_copy_done_off(fap) - off];
+    image_ok = &buf[boot_image_ok_off(fap) - off];
+    memcpy(magic, &buf[boot_magic_off(fap) - off], BOOT_MAGIC_SZ);
+
     if (bootutil_buffer_is_erased(fap, magic, BOOT_MAGIC_SZ)) {
         state->magic = BOOT_MAGIC_UNSET;
     } else {
         state->magic = boot_magic_decode(magic);
     }
 
-    off = boot_swap_info_off(fap);
-    rc = flash_area_read(fap, off, &swap_info, sizeof swap_info);
-    if (rc < 0) {
-        return BOOT_EFLASH;
-    }
-
     /* Extract the swap type and image number */
-    state->swap_type = BOOT_GET_SWAP_TYPE(swap_info);
-    state->image_num = BOOT_GET_IMAGE_NUM(swap_info);
+    state->swap_type = BOOT_GET_SWAP_TYPE(*swap_info);
+    state->image_num = BOOT_GET_IMAGE_NUM(*swap_info);
 
-    if (bootutil_buffer_is_erased(fap, &swap_info, sizeof swap_info) ||
+    if (bootutil_buffer_is_erased(fap, swap_info, 1) ||
             state->swap_type > BOOT_SWAP_TYPE_REVERT) {
         state->swap_type = BOOT_SWAP_TYPE_NONE;
         state->image_num = 0;
     }
 
-    off = boot_copy_done_off(fap);
-    rc = flash_area_read(fap, off, &state->copy_done, sizeof state->copy_done);
-    if (rc < 0) {
-        return BOOT_EFLASH;
-    }
-    if (bootutil_buffer_is_erased(fap, &state->copy_done,
-                sizeof state->copy_done)) {
+    if (bootutil_buffer_is_erased(fap, copy_done, 1)) {
         state->copy_done = BOOT_FLAG_UNSET;
     } else {
-        state->copy_done = boot_flag_decode(state->copy_done);
+        state->copy_done = boot_flag_decode(*copy_done);
     }
 
-    off = boot_image_ok_off(fap);
-    rc = flash_area_read(fap, off, &state->image_ok, sizeof state->image_ok);
-    if (rc < 0) {
-        return BOOT_EFLASH;
-    }
-    if (bootutil_buffer_is_erased(fap, &state->image_ok,
-                sizeof state->image_ok)) {
+    if (bootutil_buffer_is_erased(fap, image_ok, 1)) {
         state->image_ok = BOOT_FLAG_UNSET;
     } else {
-        state->image_ok = boot_flag_decode(state->image_ok);
+        state->image_ok = boot_flag_decode(*image_ok);
     }
 
     return 0;
@@ -560,6 +640,27 @@ boot_write_trailer(const struct flash_area *fap, uint32_t off,
     if (inlen > BOOT_MAX_ALIGN || align > BOOT_MAX_ALIGN) {
         return -1;
     }
+#ifdef MCUBOOT_TRAILER_COMPACT
+    if (align > inlen || off % align != 0) {
+        /* The field shares its write unit: program the unit again, with
+         * the fields already written in it.
+         */
+        uint32_t unit_off = off - off % align;
+
+        rc = flash_area_read(fap, unit_off, buf, align);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+        memcpy(&buf[off - unit_off], inbuf, inlen);
+
+        rc = flash_area_write(fap, unit_off, buf, align);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+
+        return 0;
+    }
+#endif
     erased_val = flash_area_erased_val(fap);
     if (align < inlen) {
         align = inlen;
@@ -575,6 +676,44 @@ boot_write_trailer(const struct flash_area *fap, uint32_t off,
     return 0;
 }
 
+#ifdef MCUBOOT_TRAILER_COMPACT
+/**
+ * Marks an entry of the status area as written, by programming its bit. The
+ * write unit holding it is programmed again, with the bits already set.
+ *
+ * @returns 0 on success, != 0 on error.
+ */
+int
+boot_write_status_bit(const struct flash_area *fap, uint32_t entry)
+{
+    uint8_t buf[BOOT_MAX_ALIGN];
+    uint32_t off;
+    uint8_t align;
+    uint8_t erased_val;
+    uint8_t mask;
+    int rc;
+
+    align = flash_area_align(fap);
+    erased_val = flash_area_erased_val(fap);
+    off = boot_status_off(fap) + entry / 8 / align * align;
+    mask = 1 << (entry % 8);
+
+    rc = flash_area_read(fap, off, buf, align);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+    buf[entry / 8 % align] = (buf[entry / 8 % align] & ~mask) |
+                             (~erased_val & mask);
+
+    rc = flash_area_write(fap, off, buf, align);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    return 0;
+}
+#endif
+
 #endif /* MCUBOOT_SWAP_USING_STATUS */
 
 static int
@@ -609,6 +748,99 @@ boot_write_image_ok(const struct flash_area *fap)
     return boot_write_trailer_flag(fap, off, BOOT_FLAG_SET);
 }
 
+#ifdef MCUBOOT_BOOT_ATTEMPTS
+/**
+ * Reads the number of boot attempts recorded in an image trailer.
+ *
+ * Each attempt consumes one write unit at the start of the swap status area,
+ * which is otherwise unused when the slots are equivalent, so the counter only
+ * ever programs erased flash and is reset by erasing the slot. The compact
+ * trailer uses one bit per attempt instead.
+ *
+ * @param fap           The flash area of the image slot.
+ * @param attempts      On success, the number of recorded attempts.
+ *
+ * @returns 0 on success, != 0 on error.
+ */
+int
+boot_read_boot_attempts(const struct flash_area *fap, uint8_t *attempts)
+{
+    uint32_t off;
+    uint8_t erased_val;
+#ifdef MCUBOOT_TRAILER_COMPACT
+    uint8_t bits[(MCUBOOT_BOOT_ATTEMPTS + 7) / 8];
+#else
+    uint8_t align;
+    uint8_t val;
+#endif
+    uint8_t i;
+    int rc;
+
+    off = boot_status_off(fap);
+    erased_val = flash_area_erased_val(fap);
+
+#ifdef MCUBOOT_TRAILER_COMPACT
+    rc = flash_area_read(fap, off, bits, sizeof bits);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    for (i = 0; i < MCUBOOT_BOOT_ATTEMPTS; i++) {
+        if (!boot_status_bit_is_set(erased_val, bits, i)) {
+            break;
+        }
+    }
+#else
+    align = flash_area_align(fap);
+
+    for (i = 0; i < MCUBOOT_BOOT_ATTEMPTS; i++) {
+        rc = flash_area_read(fap, off + i * align, &val, sizeof val);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+        if (val == erased_val) {
+            break;
+        }
+    }
+#endif
+
+    *attempts = i;
+    return 0;
+}
+
+/**
+ * Records a boot attempt in an image trailer.
+ *
+ * @param fap           The flash area of the image slot.
+ * @param attempt       The number of attempts recorded so far.
+ *
+ * @returns 0 on success, != 0 on error.
+ */
+int
+boot_write_boot_attempt(const struct flash_area *fap, uint8_t attempt)
+{
+#ifndef MCUBOOT_TRAILER_COMPACT
+    uint32_t off;
+#endif
+
+    if (attempt >= MCUBOOT_BOOT_ATTEMPTS) {
+        return -1;
+    }
+
+#ifdef MCUBOOT_TRAILER_COMPACT
+    BOOT_LOG_DBG("writing boot attempt %u; fa_id=%d", (unsigned)attempt,
+                 fap->fa_id);
+    return boot_write_status_bit(fap, attempt);
+#else
+    off = boot_status_off(fap) + attempt * flash_area_align(fap);
+    BOOT_LOG_DBG("writing boot attempt %u; fa_id=%d off=0x%lx (0x%lx)",
+                 (unsigned)attempt, fap->fa_id, (unsigned long)off,
+                 (unsigned long)(fap->fa_off + off));
+    return boot_write_trailer_flag(fap, off, BOOT_FLAG_SET);
+#endif
+}
+#endif /* MCUBOOT_BOOT_ATTEMPTS */
+
 /**
  * Writes the specified value to the `swap-type` field of an image trailer.
  * This value is persisted so that the boot loader knows what swap operation to
@@ -678,43 +910,34 @@ boot_write_enc_key(const struct flash_area *fap, uint8_t slot,
                  (state)->copy_done,                                \
                  (state)->image_ok)
 
+/**
+ * Determines the swap type from the trailers of the two slots of an image.
+ *
+ * @param primary_slot      Swap state of the primary slot.
+ * @param secondary_slot    Swap state of the secondary slot.
+ *
+ * @return                  One of the BOOT_SWAP_TYPE_[...] values.
+ */
 int
-boot_swap_type_multi(int image_index)
+boot_swap_type_from_states(const struct boot_swap_state *primary_slot,
+                           const struct boot_swap_state *secondary_slot)
 {
     const struct boot_swap_table *table;
-    struct boot_swap_state primary_slot;
-    struct boot_swap_state secondary_slot;
-    int rc;
     size_t i;
 
-    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_PRIMARY(image_index),
-                                    &primary_slot);
-    if (rc) {
-        return BOOT_SWAP_TYPE_PANIC;
-    }
-
-    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
-                                    &secondary_slot);
-
-    BOOT_LOG_SWAP_STATE("boot_swap_type_multi: Primary image", &primary_slot);
-    BOOT_LOG_SWAP_STATE("boot_swap_type_multi: Secondary image", &secondary_slot);
-    if (rc) {
-        return BOOT_SWAP_TYPE_PANIC;
-    }
-
     for (i = 0; i < BOOT_SWAP_TABLES_COUNT; i++) {
         table = boot_swap_tables + i;
 
         if (boot_magic_compatible_check(table->magic_primary_slot,
-                                        primary_slot.magic) &&
+                                        primary_slot->magic) &&
             boot_magic_compatible_check(table->magic_secondary_slot,
-                                        secondary_slot.magic) &&
+                                        secondary_slot->magic) &&
             (table->image_ok_primary_slot == BOOT_FLAG_ANY   ||
-                table->image_ok_primary_slot == primary_slot.image_ok) &&
+                table->image_ok_primary_slot == primary_slot->image_ok) &&
             (table->image_ok_secondary_slot == BOOT_FLAG_ANY ||
-                table->image_ok_secondary_slot == secondary_slot.image_ok) &&
+                table->image_ok_secondary_slot == secondary_slot->image_ok) &&
             (table->copy_done_primary_slot == BOOT_FLAG_ANY  ||
-                table->copy_done_primary_slot == primary_slot.copy_done)) {
+                table->copy_done_primary_slot == primary_slot->copy_done)) {
             BOOT_LOG_INF("Swap type: %s",
                          table->swap_type == BOOT_SWAP_TYPE_TEST   ? "test"   :
                          table->swap_type == BOOT_SWAP_TYPE_PERM   ? "perm"   :
@@ -733,6 +956,31 @@ boot_swap_type_multi(int image_index)
     return BOOT_SWAP_TYPE_NONE;
 }
 
+int
+boot_swap_type_multi(int image_index)
+{
+    struct boot_swap_state primary_slot;
+    struct boot_swap_state secondary_slot;
+    int rc;
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_PRIMARY(image_index),
+                                    &primary_slot);
+    if (rc) {
+        return BOOT_SWAP_TYPE_PANIC;
+    }
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
+                                    &secondary_slot);
+
+    BOOT_LOG_SWAP_STATE("boot_swap_type_multi: Primary image", &primary_slot);
+    BOOT_LOG_SWAP_STATE("boot_swap_type_multi: Secondary image", &secondary_slot);
+    if (rc) {
+        return BOOT_SWAP_TYPE_PANIC;
+    }
+
+    return boot_swap_type_from_states(&primary_slot, &secondary_slot);
+}
+
 /*
  * This function is not used by the bootloader itself, but its required API
  * by external tooling like mcumgr.
@@ -744,8 +992,11 @@ boot_swap_type(void)
 }
 
 /**
- * Marks the image in the secondary slot as pending.  On the next reboot,
- * the system will perform a one-time boot of the the secondary slot image.
+ * Marks the image in the secondary slot of an image as pending.  On the next
+ * reboot, the system will perform a one-time boot of the the secondary slot
+ * image.
+ *
+ * @param image_index       Image pair index.
  *
  * @param permanent         Whether the image should be used permanently or
  *                              only tested once:
@@ -755,14 +1006,14 @@ boot_swap_type(void)
  * @return                  0 on success; nonzero on failure.
  */
 int
-boot_set_pending(int permanent)
+boot_set_pending_multi(int image_index, int permanent)
 {
     const struct flash_area *fap;
     struct boot_swap_state state_secondary_slot;
     uint8_t swap_type;
     int rc;
 
-    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(0),
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
                                     &state_secondary_slot);
     if (rc != 0) {
         return rc;
@@ -774,7 +1025,7 @@ boot_set_pending(int permanent)
         return 0;
 
     case BOOT_MAGIC_UNSET:
-        rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(0), &fap);
+        rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap);
         if (rc != 0) {
             rc = BOOT_EFLASH;
         } else {
@@ -791,7 +1042,7 @@ boot_set_pending(int permanent)
             } else {
                 swap_type = BOOT_SWAP_TYPE_TEST;
             }
-            rc = boot_write_swap_info(fap, swap_type, 0);
+            rc = boot_write_swap_info(fap, swap_type, image_index);
         }
 
         flash_area_close(fap);
@@ -801,7 +1052,7 @@ boot_set_pending(int permanent)
         /* The image slot is corrupt.  There is no way to recover, so erase the
          * slot to allow future upgrades.
          */
-        rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(0), &fap);
+        rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap);
         if (rc != 0) {
             return BOOT_EFLASH;
         }
@@ -816,6 +1067,23 @@ boot_set_pending(int permanent)
     }
 }
 
+/**
+ * Marks the image in the secondary slot as pending.  On the next reboot,
+ * the system will perform a one-time boot of the the secondary slot image.
+ *
+ * @param permanent         Whether the image should be used permanently or
+ *                              only tested once:
+ *                                  0=run image once, then confirm or revert.
+ *                                  1=run image forever.
+ *
+ * @return                  0 on success; nonzero on failure.
+ */
+int
+boot_set_pending(int permanent)
+{
+    return boot_set_pending_multi(0, permanent);
+}
+
 /**
  * Marks the image in the primary slot as confirmed.  The system will continue
  * booting into the image in the primary slot until told to boot from a
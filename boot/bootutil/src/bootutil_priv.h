@@ -43,6 +43,21 @@
 #include "bootutil/enc_key.h"
 #endif
 
+#ifdef MCUBOOT_FLASH_CACHE
+#include "bootutil/flash_cache.h"
+
+/*
+ * Route the flash accesses of bootutil through the read cache. Files which
+ * implement the flash map backend or the cache itself define
+ * BOOT_FLASH_CACHE_NO_REMAP before including this header.
+ */
+#ifndef BOOT_FLASH_CACHE_NO_REMAP
+#define flash_area_read     boot_flash_cache_read
+#define flash_area_write    boot_flash_cache_write
+#define flash_area_erase    boot_flash_cache_erase
+#endif
+#endif /* MCUBOOT_FLASH_CACHE */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,19 +82,43 @@ struct flash_area;
 
 #define BOOT_TMPBUF_SZ  256
 
-/** Number of image slots in flash; currently limited to two. */
+/*
+ * Size of the buffer which the image copy and the image hash share, see
+ * struct boot_loader_state. Larger buffers need fewer flash transactions.
+ * With encrypted images it must also hold the image header.
+ */
+#ifdef MCUBOOT_IO_BUF_SIZE
+#define BOOT_IO_BUF_SZ  MCUBOOT_IO_BUF_SIZE
+#else
+#define BOOT_IO_BUF_SZ  1024
+#endif
+
+#if BOOT_IO_BUF_SZ < BOOT_TMPBUF_SZ
+#error "MCUBOOT_IO_BUF_SIZE is too small"
+#endif
+
+/**
+ * Number of image slots in flash.  Two unless the platform configures more
+ * slots per image with MCUBOOT_NUM_SLOTS.
+ */
+#ifdef MCUBOOT_NUM_SLOTS
+#define BOOT_NUM_SLOTS                  MCUBOOT_NUM_SLOTS
+#else
 #define BOOT_NUM_SLOTS                  2
+#endif
 
 #if (defined(MCUBOOT_OVERWRITE_ONLY) + \
      defined(MCUBOOT_SWAP_USING_MOVE) + \
+     defined(MCUBOOT_SWAP_USING_OFFSET) + \
      defined(MCUBOOT_DIRECT_XIP) + \
      defined(MCUBOOT_RAM_LOAD)) + \
      defined(MCUBOOT_SWAP_USING_STATUS) > 1
-#error "Please enable only one of MCUBOOT_OVERWRITE_ONLY, MCUBOOT_SWAP_USING_MOVE, MCUBOOT_DIRECT_XIP or MCUBOOT_RAM_LOAD or MCUBOOT_SWAP_USING_STATUS"
+#error "Please enable only one of MCUBOOT_OVERWRITE_ONLY, MCUBOOT_SWAP_USING_MOVE, MCUBOOT_SWAP_USING_OFFSET, MCUBOOT_DIRECT_XIP or MCUBOOT_RAM_LOAD or MCUBOOT_SWAP_USING_STATUS"
 #endif
 
 #if !defined(MCUBOOT_OVERWRITE_ONLY) && \
     !defined(MCUBOOT_SWAP_USING_MOVE) && \
+    !defined(MCUBOOT_SWAP_USING_OFFSET) && \
     !defined(MCUBOOT_DIRECT_XIP) && \
     !defined(MCUBOOT_RAM_LOAD) && \
     !defined(MCUBOOT_SWAP_USING_STATUS)
@@ -191,6 +230,57 @@ _Static_assert(BOOT_IMAGE_NUMBER > 0, "Invalid value for BOOT_IMAGE_NUMBER");
 #endif
 #endif /* MCUBOOT_DIRECT_XIP || MCUBOOT_RAM_LOAD */
 
+#ifdef MCUBOOT_BOOT_ATTEMPTS
+#ifndef MCUBOOT_DIRECT_XIP_REVERT
+#error "The boot attempt counter (MCUBOOT_BOOT_ATTEMPTS) requires MCUBOOT_DIRECT_XIP_REVERT."
+#endif
+#if (MCUBOOT_BOOT_ATTEMPTS < 1) || (MCUBOOT_BOOT_ATTEMPTS > 255)
+#error "MCUBOOT_BOOT_ATTEMPTS must be in the range 1..255."
+#endif
+#endif /* MCUBOOT_BOOT_ATTEMPTS */
+
+#if defined(MCUBOOT_TRAILER_COMPACT) && defined(MCUBOOT_SWAP_USING_STATUS)
+#error "The compact trailer (MCUBOOT_TRAILER_COMPACT) is not used by MCUBOOT_SWAP_USING_STATUS."
+#endif
+
+#if defined(MCUBOOT_ENC_AEAD) && !defined(MCUBOOT_ENC_IMAGES)
+#error "Authenticated image encryption (MCUBOOT_ENC_AEAD) requires MCUBOOT_ENC_IMAGES."
+#endif
+
+#if defined(MCUBOOT_WARM_BOOT) && ARE_SLOTS_EQUIVALENT()
+#error "The warm boot state (MCUBOOT_WARM_BOOT) is only supported by the swap and overwrite modes."
+#endif
+
+#ifdef MCUBOOT_STAGED_BOOT
+#if ARE_SLOTS_EQUIVALENT()
+#error "The staged boot (MCUBOOT_STAGED_BOOT) is only supported by the swap and overwrite modes."
+#endif
+#if (BOOT_IMAGE_NUMBER < 2)
+#error "The staged boot (MCUBOOT_STAGED_BOOT) requires more than one image."
+#endif
+#ifndef MCUBOOT_DEFERRED_IMAGES
+#define MCUBOOT_DEFERRED_IMAGES 0
+#endif
+#if ((MCUBOOT_DEFERRED_IMAGES) & 1)
+#error "Image 0 is booted first, it can't be deferred (MCUBOOT_DEFERRED_IMAGES)."
+#endif
+#if ((MCUBOOT_DEFERRED_IMAGES) >> BOOT_IMAGE_NUMBER)
+#error "MCUBOOT_DEFERRED_IMAGES names images which don't exist."
+#endif
+#endif /* MCUBOOT_STAGED_BOOT */
+
+#if (BOOT_NUM_SLOTS < 2)
+#error "At least two image slots are required (MCUBOOT_NUM_SLOTS >= 2)."
+#endif
+
+#if (BOOT_NUM_SLOTS > 2) && !ARE_SLOTS_EQUIVALENT()
+#error "More than two slots per image (MCUBOOT_NUM_SLOTS > 2) are only supported in MCUBOOT_DIRECT_XIP or MCUBOOT_RAM_LOAD mode."
+#endif
+
+#if (BOOT_NUM_SLOTS > 32)
+#error "No more than 32 image slots are supported (MCUBOOT_NUM_SLOTS <= 32)."
+#endif
+
 #define BOOT_MAX_IMG_SECTORS       MCUBOOT_MAX_IMG_SECTORS
 
 /*
@@ -208,9 +298,13 @@ _Static_assert(BOOT_IMAGE_NUMBER > 0, "Invalid value for BOOT_IMAGE_NUMBER");
                                                                 | (type);      \
                                                     }
 
+#define BOOT_SLOT_NAME(slot)                                              \
+    (((slot) == BOOT_PRIMARY_SLOT) ? "Primary" :                          \
+     ((slot) == BOOT_SECONDARY_SLOT) ? "Secondary" : "Additional")
+
 #define BOOT_LOG_IMAGE_INFO(slot, hdr)                                    \
-    BOOT_LOG_INF("%-9s slot: version=%u.%u.%u+%u",                        \
-                 ((slot) == BOOT_PRIMARY_SLOT) ? "Primary" : "Secondary", \
+    BOOT_LOG_INF("%-9s slot %u: version=%u.%u.%u+%u",                     \
+                 BOOT_SLOT_NAME(slot), (unsigned)(slot),                  \
                  (hdr)->ih_ver.iv_major,                                  \
                  (hdr)->ih_ver.iv_minor,                                  \
                  (hdr)->ih_ver.iv_revision,                               \
@@ -231,6 +325,9 @@ _Static_assert(BOOT_IMAGE_NUMBER > 0, "Invalid value for BOOT_IMAGE_NUMBER");
 #define BOOT_STATUS_MOVE_STATE_COUNT    1
 #define BOOT_STATUS_SWAP_STATE_COUNT    2
 #define BOOT_STATUS_STATE_COUNT         (BOOT_STATUS_MOVE_STATE_COUNT + BOOT_STATUS_SWAP_STATE_COUNT)
+#elif MCUBOOT_SWAP_USING_OFFSET
+#define BOOT_STATUS_SWAP_STATE_COUNT    2
+#define BOOT_STATUS_STATE_COUNT         BOOT_STATUS_SWAP_STATE_COUNT
 #else
 #define BOOT_STATUS_STATE_COUNT         3
 #endif
@@ -238,6 +335,22 @@ _Static_assert(BOOT_IMAGE_NUMBER > 0, "Invalid value for BOOT_IMAGE_NUMBER");
 /** Maximum number of image sectors supported by the bootloader. */
 #define BOOT_STATUS_MAX_ENTRIES         BOOT_MAX_IMG_SECTORS
 
+/*
+ * Size of the first n entries of a status area, in whole write units. The
+ * compact trailer keeps one bit per entry instead of one write unit.
+ */
+#ifdef MCUBOOT_TRAILER_COMPACT
+#define BOOT_STATUS_ENTRIES_SZ(n, write_sz) \
+    ((((n) + 8 * (write_sz) - 1) / (8 * (write_sz))) * (write_sz))
+#else
+#define BOOT_STATUS_ENTRIES_SZ(n, write_sz) ((n) * (write_sz))
+#endif
+
+#if defined(MCUBOOT_TRAILER_COMPACT) && defined(MCUBOOT_BOOT_ATTEMPTS) && \
+    (MCUBOOT_BOOT_ATTEMPTS > BOOT_STATUS_MAX_ENTRIES * BOOT_STATUS_STATE_COUNT)
+#error "MCUBOOT_BOOT_ATTEMPTS does not fit in the compact status area."
+#endif
+
 #define BOOT_PRIMARY_SLOT               0
 #define BOOT_SECONDARY_SLOT             1
 
@@ -284,6 +397,18 @@ struct boot_loader_state {
     uint8_t swap_type[BOOT_IMAGE_NUMBER];
     uint32_t write_sz;
 
+#ifdef MCUBOOT_STAGED_BOOT
+    /* Images left to context_boot_go_deferred(), bit N for image N. */
+    uint32_t deferred;
+    /* Set by a successful context_boot_go(), until the deferred checks. */
+    bool handoff;
+#endif
+
+#if ARE_SLOTS_EQUIVALENT()
+    /* Slots left to the image selection, bit N for slot N. */
+    uint32_t candidates;
+#endif
+
 #if defined(MCUBOOT_ENC_IMAGES)
     struct enc_key_data enc[BOOT_IMAGE_NUMBER][BOOT_NUM_SLOTS];
 #endif
@@ -291,6 +416,25 @@ struct boot_loader_state {
 #if (BOOT_IMAGE_NUMBER > 1)
     uint8_t curr_img_idx;
 #endif
+
+#if MCUBOOT_SWAP_USING_OFFSET
+    /*
+     * Where the image in the secondary slot starts, either one sector into
+     * the slot or at its start, and a view of the slot from there.
+     */
+    struct {
+        uint32_t off;
+        struct flash_area area;
+    } secondary[BOOT_IMAGE_NUMBER];
+#endif
+
+    /*
+     * Working buffer of the phases which stream whole images through RAM:
+     * validating an image and copying regions during an upgrade. They never
+     * run at the same time, so they share it instead of having a buffer
+     * each, and each of them gets a larger one.
+     */
+    uint8_t io_buf[BOOT_IO_BUF_SZ];
 };
 
 fih_int bootutil_verify_sig(uint8_t *hash, uint32_t hlen, uint8_t *sig,
@@ -299,6 +443,18 @@ fih_int bootutil_verify_sig(uint8_t *hash, uint32_t hlen, uint8_t *sig,
 fih_int boot_fih_memequal(const void *s1, const void *s2, size_t n);
 
 int boot_magic_compatible_check(uint8_t tbl_val, uint8_t val);
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+fih_int boot_security_cnt_cache_init(void);
+fih_int boot_security_cnt_cache_get(uint32_t image_id, fih_int *security_cnt);
+int boot_security_cnt_cache_update(uint32_t image_id,
+                                   uint32_t img_security_cnt);
+int boot_security_cnt_cache_commit(void);
+#endif
+#ifdef MCUBOOT_WARM_BOOT
+fih_int boot_warm_load(struct boot_loader_state *state, struct boot_rsp *rsp);
+void boot_warm_save(struct boot_loader_state *state,
+                    const struct boot_rsp *rsp);
+#endif
 uint32_t boot_status_sz(uint32_t min_write_sz);
 uint32_t boot_trailer_sz(uint32_t min_write_sz);
 int boot_status_entries(int image_index, const struct flash_area *fap);
@@ -308,10 +464,29 @@ int boot_read_swap_state(const struct flash_area *fap,
                          struct boot_swap_state *state);
 int boot_read_swap_state_by_id(int flash_area_id,
                                struct boot_swap_state *state);
+int boot_swap_type_from_states(const struct boot_swap_state *primary_slot,
+                               const struct boot_swap_state *secondary_slot);
 int boot_write_magic(const struct flash_area *fap);
 int boot_write_status(const struct boot_loader_state *state, struct boot_status *bs);
+#ifdef MCUBOOT_TRAILER_COMPACT
+int boot_write_status_bit(const struct flash_area *fap, uint32_t entry);
+
+/*
+ * Tells whether the bit of a status entry is programmed, in a copy of the
+ * status area starting at the byte holding entry 0.
+ */
+static inline bool
+boot_status_bit_is_set(uint8_t erased_val, const uint8_t *bits, uint32_t entry)
+{
+    return ((bits[entry / 8] ^ erased_val) >> (entry % 8)) & 1;
+}
+#endif
 int boot_write_copy_done(const struct flash_area *fap);
 int boot_write_image_ok(const struct flash_area *fap);
+#ifdef MCUBOOT_BOOT_ATTEMPTS
+int boot_read_boot_attempts(const struct flash_area *fap, uint8_t *attempts);
+int boot_write_boot_attempt(const struct flash_area *fap, uint8_t attempt);
+#endif
 int boot_write_swap_info(const struct flash_area *fap, uint8_t swap_type,
                          uint8_t image_num);
 int boot_write_swap_size(const struct flash_area *fap, uint32_t swap_size);
@@ -327,6 +502,37 @@ int boot_copy_region(struct boot_loader_state *state,
 int boot_erase_region(const struct flash_area *fap, uint32_t off, uint32_t sz);
 bool boot_status_is_reset(const struct boot_status *bs);
 
+/*
+ * Returns the flash area to read the image in the given slot through. With
+ * swap using offset the image in the secondary slot doesn't always start at
+ * the start of the slot, and this is a view of the slot starting at the
+ * image, so that offsets in the image are offsets in the area. The slot
+ * itself, its sectors and its trailer, is still accessed through fap.
+ */
+#if MCUBOOT_SWAP_USING_OFFSET
+const struct flash_area *boot_img_area_view(struct boot_loader_state *state,
+                                            int slot,
+                                            const struct flash_area *fap);
+#else
+#define boot_img_area_view(state, slot, fap) (fap)
+#endif
+
+/*
+ * Called from the loops which copy, hash or erase whole images, to keep the
+ * watchdog fed. A port whose watchdog can tell when it is close to expiring
+ * defines MCUBOOT_WATCHDOG_POLL() to feed it only then. A port with a cheap
+ * monotonic counter defines MCUBOOT_WATCHDOG_TICKS() and
+ * MCUBOOT_WATCHDOG_FEED_TICKS, and the watchdog is fed once that many ticks
+ * have passed. Otherwise every call feeds it.
+ */
+#if defined(MCUBOOT_WATCHDOG_POLL)
+#define boot_wdt_poll() MCUBOOT_WATCHDOG_POLL()
+#elif defined(MCUBOOT_WATCHDOG_TICKS)
+void boot_wdt_poll(void);
+#else
+#define boot_wdt_poll() MCUBOOT_WATCHDOG_FEED()
+#endif
+
 #ifdef MCUBOOT_SWAP_USING_STATUS
 uint32_t boot_copy_done_off(const struct flash_area *fap);
 uint32_t boot_image_ok_off(const struct flash_area *fap);
@@ -403,6 +609,7 @@ static inline bool boot_u16_safe_add(uint16_t *dest, uint16_t a, uint16_t b)
 #define BOOT_IMG(state, slot) ((state)->imgs[BOOT_CURR_IMG(state)][(slot)])
 #define BOOT_IMG_AREA(state, slot) (BOOT_IMG(state, slot).area)
 #define BOOT_WRITE_SZ(state) ((state)->write_sz)
+#define BOOT_IO_BUF(state) ((state)->io_buf)
 #define BOOT_SWAP_TYPE(state) ((state)->swap_type[BOOT_CURR_IMG(state)])
 #define BOOT_TLV_OFF(hdr) ((hdr)->ih_hdr_size + (hdr)->ih_img_size)
 
@@ -40,10 +40,17 @@ uint32_t bootutil_get_caps(void)
 #if defined(MCUBOOT_SIGN_ED25519)
     res |= BOOTUTIL_CAP_ED25519;
 #endif
+#if defined(MCUBOOT_SIGN_LMS)
+    res |= BOOTUTIL_CAP_LMS;
+#endif
 #if defined(MCUBOOT_OVERWRITE_ONLY)
     res |= BOOTUTIL_CAP_OVERWRITE_UPGRADE;
 #elif defined(MCUBOOT_SWAP_USING_MOVE)
     res |= BOOTUTIL_CAP_SWAP_USING_MOVE;
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+    res |= BOOTUTIL_CAP_SWAP_USING_OFFSET;
+#elif defined(MCUBOOT_DIRECT_XIP)
+    res |= BOOTUTIL_CAP_DIRECT_XIP;
 #else
     res |= BOOTUTIL_CAP_SWAP_USING_SCRATCH;
 #endif
@@ -68,6 +75,24 @@ uint32_t bootutil_get_caps(void)
 #if defined(MCUBOOT_BOOTSTRAP)
     res |= BOOTUTIL_CAP_BOOTSTRAP;
 #endif
+#if defined(MCUBOOT_HASH_BLOCKS)
+    res |= BOOTUTIL_CAP_HASH_BLOCKS;
+#endif
+#if defined(MCUBOOT_TRAILER_COMPACT)
+    res |= BOOTUTIL_CAP_TRAILER_COMPACT;
+#endif
+#if defined(MCUBOOT_STAGED_BOOT)
+    res |= BOOTUTIL_CAP_STAGED_BOOT;
+#endif
+#if defined(MCUBOOT_ERASE_SKIP_ERASED)
+    res |= BOOTUTIL_CAP_ERASE_SKIP_ERASED;
+#endif
+#if defined(MCUBOOT_ENC_AEAD)
+    res |= BOOTUTIL_CAP_ENC_AEAD;
+#endif
+#if defined(MCUBOOT_WARM_BOOT)
+    res |= BOOTUTIL_CAP_WARM_BOOT;
+#endif
 
     return res;
 }
@@ -80,3 +105,21 @@ uint32_t bootutil_get_num_images(void)
     return 1;
 #endif
 }
+
+uint32_t bootutil_get_num_slots(void)
+{
+#if defined(MCUBOOT_NUM_SLOTS)
+    return MCUBOOT_NUM_SLOTS;
+#else
+    return 2;
+#endif
+}
+
+uint32_t bootutil_get_boot_attempts(void)
+{
+#if defined(MCUBOOT_BOOT_ATTEMPTS)
+    return MCUBOOT_BOOT_ATTEMPTS;
+#else
+    return 0;
+#endif
+}
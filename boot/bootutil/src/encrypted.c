@@ -37,6 +37,10 @@
 #include "mbedtls/asn1.h"
 #endif
 
+#if defined(MCUBOOT_ENC_AEAD)
+#include "bootutil/crypto/aes_cmac.h"
+#endif
+
 #include "bootutil/image.h"
 #include "bootutil/enc_key.h"
 #include "bootutil/sign_key.h"
@@ -305,6 +309,7 @@ hkdf(uint8_t *ikm, uint16_t ikm_len, uint8_t *info, uint16_t info_len,
         uint8_t *okm, uint16_t *okm_len)
 {
     bootutil_hmac_sha256_context hmac;
+    bootutil_hmac_sha256_context prk_hmac;
     uint8_t salt[BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE];
     uint8_t prk[BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE];
     uint8_t T[BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE];
@@ -323,6 +328,7 @@ hkdf(uint8_t *ikm, uint16_t ikm_len, uint8_t *info, uint16_t info_len,
     }
 
     bootutil_hmac_sha256_init(&hmac);
+    bootutil_hmac_sha256_init(&prk_hmac);
 
     memset(salt, 0, BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE);
     rc = bootutil_hmac_sha256_set_key(&hmac, salt, BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE);
@@ -344,16 +350,17 @@ hkdf(uint8_t *ikm, uint16_t ikm_len, uint8_t *info, uint16_t info_len,
      * Expand
      */
 
+    /* Every block is keyed with the PRK: set it once and clone the states. */
+    rc = bootutil_hmac_sha256_set_key(&prk_hmac, prk, BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE);
+    if (rc != 0) {
+        goto error;
+    }
+
     len = *okm_len;
     counter = 1;
     first = true;
     for (off = 0; len > 0; off += BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE, ++counter) {
-        bootutil_hmac_sha256_init(&hmac);
-
-        rc = bootutil_hmac_sha256_set_key(&hmac, prk, BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE);
-        if (rc != 0) {
-            goto error;
-        }
+        bootutil_hmac_sha256_clone(&hmac, &prk_hmac);
 
         if (first) {
             first = false;
@@ -388,10 +395,12 @@ hkdf(uint8_t *ikm, uint16_t ikm_len, uint8_t *info, uint16_t info_len,
         }
     }
 
+    bootutil_hmac_sha256_drop(&prk_hmac);
     bootutil_hmac_sha256_drop(&hmac);
     return 0;
 
 error:
+    bootutil_hmac_sha256_drop(&prk_hmac);
     bootutil_hmac_sha256_drop(&hmac);
     return -1;
 }
@@ -411,6 +420,40 @@ boot_enc_drop(struct enc_key_data *enc_state, uint8_t slot)
     return 0;
 }
 
+#if defined(MCUBOOT_ENC_AEAD)
+/*
+ * The key of the payload tag, and the key check value which commits an
+ * IMAGE_TLV_ENC_AEAD TLV to the image key, are both the AES-CMAC of a 16
+ * byte label under the image key.
+ */
+static int
+boot_enc_aead_derive(struct enc_key_data *enc, const uint8_t *key)
+{
+    bootutil_aes_cmac_context cmac;
+    int rc;
+
+    bootutil_aes_cmac_init(&cmac);
+    rc = bootutil_aes_cmac_set_key(&cmac, key);
+    if (rc == 0) {
+        rc = bootutil_aes_cmac_update(&cmac,
+                (const uint8_t *)"MCUBOOT-AEAD-MAC", 16);
+    }
+    if (rc == 0) {
+        rc = bootutil_aes_cmac_finish(&cmac, enc->mac_key);
+    }
+    if (rc == 0) {
+        rc = bootutil_aes_cmac_update(&cmac,
+                (const uint8_t *)"MCUBOOT-AEAD-KCV", 16);
+    }
+    if (rc == 0) {
+        rc = bootutil_aes_cmac_finish(&cmac, enc->kcv);
+    }
+    bootutil_aes_cmac_drop(&cmac);
+
+    return rc;
+}
+#endif /* MCUBOOT_ENC_AEAD */
+
 int
 boot_enc_set_key(struct enc_key_data *enc_state, uint8_t slot,
         const struct boot_status *bs)
@@ -418,6 +461,11 @@ boot_enc_set_key(struct enc_key_data *enc_state, uint8_t slot,
     int rc;
 
     rc = bootutil_aes_ctr_set_key(&enc_state[slot].aes_ctr, bs->enckey[slot]);
+#if defined(MCUBOOT_ENC_AEAD)
+    if (rc == 0) {
+        rc = boot_enc_aead_derive(&enc_state[slot], bs->enckey[slot]);
+    }
+#endif
     if (rc != 0) {
         boot_enc_drop(enc_state, slot);
         enc_state[slot].valid = 0;
@@ -758,6 +806,61 @@ boot_encrypt(struct enc_key_data *enc_state, int image_index,
     bootutil_aes_ctr_encrypt(&enc->aes_ctr, nonce, buf, sz, blk_off, buf);
 }
 
+#if defined(MCUBOOT_ENC_AEAD)
+/*
+ * Compute the AES-CMAC of the encrypted data at [off, off + sz) of a slot,
+ * and return it with the key check value of the slot's key. The data is
+ * read as is: nothing is decrypted.
+ */
+int
+boot_enc_mac(struct enc_key_data *enc_state, int image_index,
+        const struct flash_area *fap, uint32_t off, uint32_t sz,
+        uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *kcv, uint8_t *tag)
+{
+    bootutil_aes_cmac_context cmac;
+    struct enc_key_data *enc;
+    uint32_t end;
+    uint32_t blk_sz;
+    int rc;
+
+    rc = flash_area_id_to_multi_image_slot(image_index, fap->fa_id);
+    if (rc < 0) {
+        return rc;
+    }
+
+    enc = &enc_state[rc];
+    if (!enc->valid) {
+        return -1;
+    }
+
+    bootutil_aes_cmac_init(&cmac);
+    rc = bootutil_aes_cmac_set_key(&cmac, enc->mac_key);
+
+    for (end = off + sz; rc == 0 && off < end; off += blk_sz) {
+        blk_sz = end - off;
+        if (blk_sz > tmp_buf_sz) {
+            blk_sz = tmp_buf_sz;
+        }
+        rc = flash_area_read(fap, off, tmp_buf, blk_sz);
+        if (rc == 0) {
+            rc = bootutil_aes_cmac_update(&cmac, tmp_buf, blk_sz);
+        }
+        boot_wdt_poll();
+    }
+
+    if (rc == 0) {
+        rc = bootutil_aes_cmac_finish(&cmac, tag);
+    }
+    bootutil_aes_cmac_drop(&cmac);
+
+    if (rc == 0) {
+        memcpy(kcv, enc->kcv, BOOT_ENC_AEAD_KCV_SIZE);
+    }
+
+    return rc;
+}
+#endif /* MCUBOOT_ENC_AEAD */
+
 /**
  * Clears encrypted state after use.
  */
@@ -0,0 +1,262 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * LRU page cache for flash reads.
+ *
+ * Pages are identified by the flash device and the absolute address of the
+ * page, so that flash areas which overlap share the cached data and a write
+ * through any of them invalidates it. A page only holds the part of it which
+ * lies inside the flash area it was read through; a lookup which needs bytes
+ * outside of that range counts as a miss and refills the page.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_FLASH_CACHE
+
+/* This file calls the flash map backend, not its cached equivalents. */
+#define BOOT_FLASH_CACHE_NO_REMAP
+
+#include <flash_map_backend/flash_map_backend.h>
+#include "bootutil/flash_cache.h"
+#include "bootutil_priv.h"
+
+#ifndef MCUBOOT_FLASH_CACHE_PAGE_SIZE
+#define MCUBOOT_FLASH_CACHE_PAGE_SIZE   256
+#endif
+
+#ifndef MCUBOOT_FLASH_CACHE_PAGES
+#define MCUBOOT_FLASH_CACHE_PAGES       8
+#endif
+
+#ifndef MCUBOOT_FLASH_CACHE_AREA_FILTER
+#define MCUBOOT_FLASH_CACHE_AREA_FILTER(fap)    1
+#endif
+
+#if (MCUBOOT_FLASH_CACHE_PAGE_SIZE & (MCUBOOT_FLASH_CACHE_PAGE_SIZE - 1)) != 0
+#error "MCUBOOT_FLASH_CACHE_PAGE_SIZE must be a power of two."
+#endif
+
+#if (MCUBOOT_FLASH_CACHE_PAGES < 1)
+#error "MCUBOOT_FLASH_CACHE_PAGES must be at least 1."
+#endif
+
+#define CACHE_PAGE_SIZE   MCUBOOT_FLASH_CACHE_PAGE_SIZE
+#define CACHE_PAGE_MASK   (~((uint32_t)CACHE_PAGE_SIZE - 1))
+
+struct boot_flash_cache_page {
+    uint32_t addr;      /* Absolute address of the page. */
+    uint32_t lo;        /* Absolute range of the valid data, [lo, hi). */
+    uint32_t hi;
+    uint32_t last_use;  /* Value of the use counter on the last access. */
+    uint8_t dev;
+    bool valid;
+    uint8_t data[CACHE_PAGE_SIZE];
+};
+
+static struct boot_flash_cache_page cache_pages[MCUBOOT_FLASH_CACHE_PAGES];
+static uint32_t cache_use_cnt;
+static struct boot_flash_cache_stats cache_stats;
+
+static struct boot_flash_cache_page *
+boot_flash_cache_lookup(uint8_t dev, uint32_t addr, uint32_t len)
+{
+    struct boot_flash_cache_page *page;
+    int i;
+
+    for (i = 0; i < MCUBOOT_FLASH_CACHE_PAGES; i++) {
+        page = &cache_pages[i];
+        if (page->valid && page->dev == dev && page->lo <= addr &&
+            addr + len <= page->hi) {
+            return page;
+        }
+    }
+
+    return NULL;
+}
+
+static struct boot_flash_cache_page *
+boot_flash_cache_victim(uint8_t dev, uint32_t page_addr)
+{
+    struct boot_flash_cache_page *victim = &cache_pages[0];
+    struct boot_flash_cache_page *page;
+    int i;
+
+    for (i = 0; i < MCUBOOT_FLASH_CACHE_PAGES; i++) {
+        page = &cache_pages[i];
+        if (page->valid && page->dev == dev && page->addr == page_addr) {
+            /* Partially filled copy of the same page, refill it. */
+            return page;
+        }
+    }
+
+    for (i = 0; i < MCUBOOT_FLASH_CACHE_PAGES; i++) {
+        page = &cache_pages[i];
+        if (!page->valid) {
+            return page;
+        }
+        if (page->last_use < victim->last_use) {
+            victim = page;
+        }
+    }
+
+    return victim;
+}
+
+static struct boot_flash_cache_page *
+boot_flash_cache_fill(const struct flash_area *fap, uint32_t page_addr)
+{
+    struct boot_flash_cache_page *page;
+    uint32_t area_end;
+    uint32_t lo;
+    uint32_t hi;
+    int rc;
+
+    area_end = fap->fa_off + fap->fa_size;
+    lo = (page_addr > fap->fa_off) ? page_addr : fap->fa_off;
+    hi = page_addr + CACHE_PAGE_SIZE;
+    if (hi > area_end) {
+        hi = area_end;
+    }
+
+    page = boot_flash_cache_victim(fap->fa_device_id, page_addr);
+    page->valid = false;
+
+    rc = flash_area_read(fap, lo - fap->fa_off, &page->data[lo - page_addr],
+                         hi - lo);
+    if (rc != 0) {
+        return NULL;
+    }
+
+    page->addr = page_addr;
+    page->lo = lo;
+    page->hi = hi;
+    page->dev = fap->fa_device_id;
+    page->valid = true;
+
+    return page;
+}
+
+int
+boot_flash_cache_read(const struct flash_area *fap, uint32_t off, void *dst,
+                      uint32_t len)
+{
+    struct boot_flash_cache_page *page;
+    uint8_t *out = dst;
+    uint32_t addr;
+    uint32_t chunk;
+
+    if (!(MCUBOOT_FLASH_CACHE_AREA_FILTER(fap)) || len >= CACHE_PAGE_SIZE ||
+        off > fap->fa_size || len > fap->fa_size - off) {
+        /* Big reads (e.g. hashing the image) would only evict the useful
+         * pages, and out of range reads are left to the backend to reject.
+         */
+        cache_stats.bypassed++;
+        return flash_area_read(fap, off, dst, len);
+    }
+
+    addr = fap->fa_off + off;
+    while (len > 0) {
+        chunk = (addr & CACHE_PAGE_MASK) + CACHE_PAGE_SIZE - addr;
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        page = boot_flash_cache_lookup(fap->fa_device_id, addr, chunk);
+        if (page != NULL) {
+            cache_stats.hits++;
+        } else {
+            cache_stats.misses++;
+            page = boot_flash_cache_fill(fap, addr & CACHE_PAGE_MASK);
+            if (page == NULL) {
+                return -1;
+            }
+        }
+
+        page->last_use = ++cache_use_cnt;
+        memcpy(out, &page->data[addr - page->addr], chunk);
+
+        out += chunk;
+        addr += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+static void
+boot_flash_cache_invalidate_range(uint8_t dev, uint32_t addr, uint32_t len)
+{
+    struct boot_flash_cache_page *page;
+    int i;
+
+    for (i = 0; i < MCUBOOT_FLASH_CACHE_PAGES; i++) {
+        page = &cache_pages[i];
+        if (page->valid && page->dev == dev &&
+            page->lo < addr + len && addr < page->hi) {
+            page->valid = false;
+        }
+    }
+}
+
+int
+boot_flash_cache_write(const struct flash_area *fap, uint32_t off,
+                       const void *src, uint32_t len)
+{
+    /* Invalidate first: the write may not return (e.g. a reset). */
+    boot_flash_cache_invalidate_range(fap->fa_device_id, fap->fa_off + off,
+                                      len);
+    return flash_area_write(fap, off, src, len);
+}
+
+int
+boot_flash_cache_erase(const struct flash_area *fap, uint32_t off,
+                       uint32_t len)
+{
+    boot_flash_cache_invalidate_range(fap->fa_device_id, fap->fa_off + off,
+                                      len);
+    return flash_area_erase(fap, off, len);
+}
+
+void
+boot_flash_cache_invalidate(void)
+{
+    int i;
+
+    for (i = 0; i < MCUBOOT_FLASH_CACHE_PAGES; i++) {
+        cache_pages[i].valid = false;
+    }
+    cache_use_cnt = 0;
+}
+
+void
+boot_flash_cache_get_stats(struct boot_flash_cache_stats *stats)
+{
+    *stats = cache_stats;
+}
+
+void
+boot_flash_cache_reset_stats(void)
+{
+    memset(&cache_stats, 0, sizeof(cache_stats));
+}
+
+#endif /* MCUBOOT_FLASH_CACHE */
@@ -0,0 +1,266 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * LMS (RFC 8554) signature verification, with SHA-256 and 32-byte hashes.
+ *
+ * The verification only needs SHA-256: at most a few thousand compressions
+ * (2^w - 1 per Winternitz chain, plus one per tree level), which is much
+ * cheaper than the big number arithmetic of RSA or ECDSA on small cores.
+ *
+ * The public key is stored in the raw RFC 8554 format:
+ *   u32 lms_type || u32 lmots_type || I[16] || T[1][32]
+ * and the signature is an RFC 8554 LMS signature of the image hash:
+ *   u32 q || u32 lmots_type || C[32] || y[p][32] || u32 lms_type ||
+ *   path[h][32]
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_SIGN_LMS
+#include "bootutil/sign_key.h"
+#include "bootutil/crypto/sha256.h"
+#include "bootutil/fault_injection_hardening.h"
+
+#include "bootutil_priv.h"
+
+#define LMS_N               32
+#define LMS_I_LEN           16
+#define LMS_PUBKEY_LEN      (4 + 4 + LMS_I_LEN + LMS_N)
+
+#define LMS_D_PBLC          0x8080
+#define LMS_D_MESG          0x8181
+#define LMS_D_LEAF          0x8282
+#define LMS_D_INTR          0x8383
+
+struct lmots_params {
+    uint32_t type;
+    uint8_t w;          /* Winternitz parameter, in bits. */
+    uint16_t p;         /* Number of chains. */
+    uint8_t ls;         /* Left shift of the checksum. */
+};
+
+static const struct lmots_params lmots_params[] = {
+    { 1, 1, 265, 7 },   /* LMOTS_SHA256_N32_W1 */
+    { 2, 2, 133, 6 },   /* LMOTS_SHA256_N32_W2 */
+    { 3, 4,  67, 4 },   /* LMOTS_SHA256_N32_W4 */
+    { 4, 8,  34, 0 },   /* LMOTS_SHA256_N32_W8 */
+};
+
+static uint32_t
+lms_get_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void
+lms_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/*
+ * Return the tree height of an LMS_SHA256_M32_Hxx type, 0 if unsupported.
+ */
+static uint32_t
+lms_height(uint32_t type)
+{
+    switch (type) {
+    case 5: return 5;
+    case 6: return 10;
+    case 7: return 15;
+    case 8: return 20;
+    case 9: return 25;
+    default: return 0;
+    }
+}
+
+static const struct lmots_params *
+lmots_get_params(uint32_t type)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(lmots_params) / sizeof(lmots_params[0]); i++) {
+        if (lmots_params[i].type == type) {
+            return &lmots_params[i];
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t
+lmots_coef(const uint8_t *s, uint32_t i, uint8_t w)
+{
+    return ((1u << w) - 1) & (s[i * w / 8] >> (8 - (w * (i % (8 / w)) + w)));
+}
+
+/*
+ * Start a hash with I || u32str(r) || u16str(d), the prefix common to every
+ * LMS hash.
+ */
+static void
+lms_hash_start(bootutil_sha256_context *ctx, const uint8_t *ident,
+               uint32_t r, uint16_t d)
+{
+    uint8_t buf[4 + 2];
+
+    lms_put_u32(buf, r);
+    buf[4] = (uint8_t)(d >> 8);
+    buf[5] = (uint8_t)d;
+
+    bootutil_sha256_init(ctx);
+    bootutil_sha256_update(ctx, ident, LMS_I_LEN);
+    bootutil_sha256_update(ctx, buf, sizeof(buf));
+}
+
+/*
+ * Compute the candidate LM-OTS public key from the LM-OTS signature `ots`
+ * (RFC 8554, algorithm 4b).
+ */
+static void
+lmots_candidate_key(bootutil_sha256_context *ctx,
+                    const struct lmots_params *par, const uint8_t *ident,
+                    uint32_t q, const uint8_t *ots, const uint8_t *msg,
+                    uint8_t *key)
+{
+    bootutil_sha256_context pub_ctx;
+    /* Q || Cksm(Q) */
+    uint8_t qc[LMS_N + 2];
+    /* I || u32str(q) || u16str(i) || u8str(j) || tmp */
+    uint8_t chain[LMS_I_LEN + 4 + 2 + 1 + LMS_N];
+    const uint8_t *c = ots + 4;
+    const uint8_t *y = c + LMS_N;
+    uint32_t max = (1u << par->w) - 1;
+    uint32_t cksm = 0;
+    uint32_t i;
+    uint32_t j;
+
+    lms_hash_start(ctx, ident, q, LMS_D_MESG);
+    bootutil_sha256_update(ctx, c, LMS_N);
+    bootutil_sha256_update(ctx, msg, LMS_N);
+    bootutil_sha256_finish(ctx, qc);
+
+    for (i = 0; i < LMS_N * 8 / par->w; i++) {
+        cksm += max - lmots_coef(qc, i, par->w);
+    }
+    cksm <<= par->ls;
+    qc[LMS_N] = (uint8_t)(cksm >> 8);
+    qc[LMS_N + 1] = (uint8_t)cksm;
+
+    memcpy(chain, ident, LMS_I_LEN);
+    lms_put_u32(&chain[LMS_I_LEN], q);
+
+    lms_hash_start(&pub_ctx, ident, q, LMS_D_PBLC);
+    for (i = 0; i < par->p; i++) {
+        chain[LMS_I_LEN + 4] = (uint8_t)(i >> 8);
+        chain[LMS_I_LEN + 5] = (uint8_t)i;
+        memcpy(&chain[LMS_I_LEN + 7], &y[i * LMS_N], LMS_N);
+
+        /* Complete the chain from the signed position to the end. */
+        for (j = lmots_coef(qc, i, par->w); j < max; j++) {
+            chain[LMS_I_LEN + 6] = (uint8_t)j;
+            bootutil_sha256_init(ctx);
+            bootutil_sha256_update(ctx, chain, sizeof(chain));
+            bootutil_sha256_finish(ctx, &chain[LMS_I_LEN + 7]);
+        }
+
+        bootutil_sha256_update(&pub_ctx, &chain[LMS_I_LEN + 7], LMS_N);
+    }
+    bootutil_sha256_finish(&pub_ctx, key);
+    bootutil_sha256_drop(&pub_ctx);
+}
+
+fih_int
+bootutil_verify_sig(uint8_t *hash, uint32_t hlen, uint8_t *sig, size_t slen,
+                    uint8_t key_id)
+{
+    bootutil_sha256_context ctx;
+    const struct lmots_params *par;
+    const uint8_t *pubkey;
+    const uint8_t *ident;
+    const uint8_t *ots;
+    const uint8_t *path;
+    uint32_t lms_type;
+    uint32_t height;
+    uint32_t q;
+    uint32_t node;
+    uint32_t i;
+    size_t ots_len;
+    uint8_t tmp[LMS_N];
+    fih_int fih_rc = FIH_FAILURE;
+
+    if (hlen != LMS_N || *bootutil_keys[key_id].len != LMS_PUBKEY_LEN) {
+        FIH_RET(fih_rc);
+    }
+
+    pubkey = bootutil_keys[key_id].key;
+    lms_type = lms_get_u32(pubkey);
+    height = lms_height(lms_type);
+    par = lmots_get_params(lms_get_u32(pubkey + 4));
+    ident = pubkey + 8;
+    if (height == 0 || par == NULL) {
+        FIH_RET(fih_rc);
+    }
+
+    /* The parameters of the signature must match the ones of the key. */
+    ots_len = 4 + LMS_N + (size_t)par->p * LMS_N;
+    if (slen != 4 + ots_len + 4 + (size_t)height * LMS_N) {
+        FIH_RET(fih_rc);
+    }
+    q = lms_get_u32(sig);
+    ots = sig + 4;
+    path = ots + ots_len + 4;
+    if (q >= (1u << height) || lms_get_u32(ots) != par->type ||
+        lms_get_u32(ots + ots_len) != lms_type) {
+        FIH_RET(fih_rc);
+    }
+
+    lmots_candidate_key(&ctx, par, ident, q, ots, hash, tmp);
+
+    /* Climb from the leaf to the root of the tree. */
+    node = (1u << height) + q;
+    lms_hash_start(&ctx, ident, node, LMS_D_LEAF);
+    bootutil_sha256_update(&ctx, tmp, LMS_N);
+    bootutil_sha256_finish(&ctx, tmp);
+
+    for (i = 0; i < height; i++, node /= 2) {
+        lms_hash_start(&ctx, ident, node / 2, LMS_D_INTR);
+        if (node & 1) {
+            bootutil_sha256_update(&ctx, &path[i * LMS_N], LMS_N);
+            bootutil_sha256_update(&ctx, tmp, LMS_N);
+        } else {
+            bootutil_sha256_update(&ctx, tmp, LMS_N);
+            bootutil_sha256_update(&ctx, &path[i * LMS_N], LMS_N);
+        }
+        bootutil_sha256_finish(&ctx, tmp);
+    }
+    bootutil_sha256_drop(&ctx);
+
+    FIH_CALL(boot_fih_memequal, fih_rc, tmp, pubkey + 8 + LMS_I_LEN, LMS_N);
+
+    FIH_RET(fih_rc);
+}
+
+#endif /* MCUBOOT_SIGN_LMS */
@@ -57,17 +57,17 @@
 #include "bootutil_priv.h"
 
 /*
- * Compute SHA256 over the image.
+ * Add the range [start, end) of the image to the SHA256 calculation. The
+ * payload is decrypted first if needed.
  */
 static int
-bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
-                  struct image_header *hdr, const struct flash_area *fap,
-                  uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *hash_result,
-                  uint8_t *seed, int seed_len)
+bootutil_img_hash_range(struct enc_key_data *enc_state, int image_index,
+                        struct image_header *hdr, const struct flash_area *fap,
+                        uint8_t *tmp_buf, uint32_t tmp_buf_sz,
+                        bootutil_sha256_context *sha256_ctx,
+                        uint32_t start, uint32_t end)
 {
-    bootutil_sha256_context sha256_ctx;
     uint32_t blk_sz;
-    uint32_t size;
     uint16_t hdr_size;
     uint32_t off;
     int rc;
@@ -81,42 +81,23 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
     (void)hdr_size;
     (void)blk_off;
     (void)tlv_off;
+#endif
+
 #ifdef MCUBOOT_RAM_LOAD
+    (void)fap;
+    (void)tmp_buf;
+    (void)tmp_buf_sz;
     (void)blk_sz;
     (void)off;
     (void)rc;
-#endif
-#endif
-
-#ifdef MCUBOOT_ENC_IMAGES
-    /* Encrypted images only exist in the secondary slot */
-    if (MUST_DECRYPT(fap, image_index, hdr) &&
-            !boot_enc_valid(enc_state, image_index, fap)) {
-        return -1;
-    }
-#endif
-
-    bootutil_sha256_init(&sha256_ctx);
-
-    /* in some cases (split image) the hash is seeded with data from
-     * the loader image */
-    if (seed && (seed_len > 0)) {
-        bootutil_sha256_update(&sha256_ctx, seed, seed_len);
-    }
-
-    /* Hash is computed over image header and image itself. */
-    size = hdr_size = hdr->ih_hdr_size;
-    size += hdr->ih_img_size;
-    tlv_off = size;
-
-    /* If protected TLVs are present they are also hashed. */
-    size += hdr->ih_protect_tlv_size;
-
-#ifdef MCUBOOT_RAM_LOAD
-    bootutil_sha256_update(&sha256_ctx,(void*)(hdr->ih_load_addr), size);
+    bootutil_sha256_update(sha256_ctx, (void*)(hdr->ih_load_addr + start),
+                           end - start);
 #else
-    for (off = 0; off < size; off += blk_sz) {
-        blk_sz = size - off;
+    hdr_size = hdr->ih_hdr_size;
+    tlv_off = hdr_size + hdr->ih_img_size;
+
+    for (off = start; off < end; off += blk_sz) {
+        blk_sz = end - off;
         if (blk_sz > tmp_buf_sz) {
             blk_sz = tmp_buf_sz;
         }
@@ -135,7 +116,6 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
 #endif
         rc = flash_area_read(fap, off, tmp_buf, blk_sz);
         if (rc) {
-            bootutil_sha256_drop(&sha256_ctx);
             return rc;
         }
 #ifdef MCUBOOT_ENC_IMAGES
@@ -148,15 +128,427 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
             }
         }
 #endif
-        bootutil_sha256_update(&sha256_ctx, tmp_buf, blk_sz);
+        bootutil_sha256_update(sha256_ctx, tmp_buf, blk_sz);
+        boot_wdt_poll();
     }
 #endif /* MCUBOOT_RAM_LOAD */
+
+    return 0;
+}
+
+#ifdef MCUBOOT_HASH_BLOCKS
+/*
+ * Block hashed images (IMAGE_F_HASH_BLOCKS) carry an IMAGE_TLV_SHA256_BLOCKS
+ * TLV which holds the block size followed by the SHA256 of each block of the
+ * hashed area (header, payload and protected TLVs). The last block may be
+ * short. The image hash, stored in the SHA256 TLV and signed, is the SHA256
+ * of the whole TLV payload. Every block can then be hashed on its own, and a
+ * part of the image can be checked against the block hashes once these have
+ * been matched against the image hash.
+ */
+
+/*
+ * Find the block hash TLV and check that its size matches the image.
+ */
+static int
+bootutil_img_find_blocks(struct image_header *hdr,
+                         const struct flash_area *fap, uint32_t size,
+                         uint32_t *block_size, uint32_t *block_cnt,
+                         uint32_t *hashes_off)
+{
+    struct image_tlv_iter it;
+    uint32_t off;
+    uint16_t len;
+    int rc;
+
+    rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_SHA256_BLOCKS,
+                                 false);
+    if (rc) {
+        return rc;
+    }
+
+    rc = bootutil_tlv_iter_next(&it, &off, &len, NULL);
+    if (rc != 0) {
+        return -1;
+    }
+
+    if (len < sizeof(*block_size)) {
+        return -1;
+    }
+
+    rc = LOAD_IMAGE_DATA(hdr, fap, off, block_size, sizeof(*block_size));
+    if (rc) {
+        return rc;
+    }
+
+    if (*block_size == 0) {
+        return -1;
+    }
+
+    *block_cnt = size / *block_size + ((size % *block_size) != 0);
+    len -= sizeof(*block_size);
+    if ((len % 32) != 0 || len / 32 != *block_cnt) {
+        return -1;
+    }
+
+    *hashes_off = off + sizeof(*block_size);
+
+    return 0;
+}
+
+/*
+ * Compute the SHA256 of one block of the hashed area.
+ */
+static int
+bootutil_img_hash_block(struct enc_key_data *enc_state, int image_index,
+                        struct image_header *hdr, const struct flash_area *fap,
+                        uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint32_t size,
+                        uint32_t block_size, uint32_t block,
+                        uint8_t *hash_result)
+{
+    bootutil_sha256_context sha256_ctx;
+    uint32_t start;
+    uint32_t end;
+    int rc;
+
+    start = block * block_size;
+    end = start + block_size;
+    if (end > size) {
+        end = size;
+    }
+
+    bootutil_sha256_init(&sha256_ctx);
+    rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap, tmp_buf,
+                                 tmp_buf_sz, &sha256_ctx, start, end);
+    if (rc == 0) {
+        bootutil_sha256_finish(&sha256_ctx, hash_result);
+    }
+    bootutil_sha256_drop(&sha256_ctx);
+
+    return rc;
+}
+
+static int
+bootutil_img_hash_blocks(struct enc_key_data *enc_state, int image_index,
+                         struct image_header *hdr,
+                         const struct flash_area *fap, uint8_t *tmp_buf,
+                         uint32_t tmp_buf_sz, uint32_t size,
+                         uint8_t *hash_result)
+{
+    bootutil_sha256_context sha256_ctx;
+    uint32_t block_size;
+    uint32_t block_cnt;
+    uint32_t hashes_off;
+    uint32_t block;
+    uint8_t block_hash[32];
+    int rc;
+
+    rc = bootutil_img_find_blocks(hdr, fap, size, &block_size, &block_cnt,
+                                  &hashes_off);
+    if (rc) {
+        return rc;
+    }
+
+    /* The stored block hashes are not used here: the image hash is computed
+     * from the recomputed ones, so that it only matches if every block does.
+     */
+    bootutil_sha256_init(&sha256_ctx);
+    bootutil_sha256_update(&sha256_ctx, &block_size, sizeof(block_size));
+    for (block = 0; block < block_cnt; block++) {
+        rc = bootutil_img_hash_block(enc_state, image_index, hdr, fap, tmp_buf,
+                                     tmp_buf_sz, size, block_size, block,
+                                     block_hash);
+        if (rc) {
+            bootutil_sha256_drop(&sha256_ctx);
+            return rc;
+        }
+        bootutil_sha256_update(&sha256_ctx, block_hash, sizeof(block_hash));
+    }
     bootutil_sha256_finish(&sha256_ctx, hash_result);
     bootutil_sha256_drop(&sha256_ctx);
 
     return 0;
 }
 
+/*
+ * Check the blocks of a block hashed image which overlap the range
+ * [off, off + len) of the hashed area against the stored block hashes. The
+ * block hashes themselves are checked against the SHA256 TLV of the image,
+ * so this must only be relied upon once the image has been validated with
+ * bootutil_img_validate(); the other blocks are not read.
+ *
+ * Return 0 if the range is valid, nonzero otherwise.
+ */
+int
+bootutil_img_check_blocks(struct enc_key_data *enc_state, int image_index,
+                          struct image_header *hdr,
+                          const struct flash_area *fap,
+                          uint8_t *tmp_buf, uint32_t tmp_buf_sz,
+                          uint32_t off, uint32_t len)
+{
+    bootutil_sha256_context sha256_ctx;
+    struct image_tlv_iter it;
+    uint32_t size;
+    uint32_t block_size;
+    uint32_t block_cnt;
+    uint32_t hashes_off;
+    uint32_t block;
+    uint32_t tlv_off;
+    uint16_t tlv_len;
+    uint8_t stored_hash[32];
+    uint8_t block_hash[32];
+    uint8_t hash[32];
+    int rc;
+
+    if (!(hdr->ih_flags & IMAGE_F_HASH_BLOCKS)) {
+        return BOOT_EBADIMAGE;
+    }
+
+#ifdef MCUBOOT_ENC_IMAGES
+    if (MUST_DECRYPT(fap, image_index, hdr) &&
+            !boot_enc_valid(enc_state, image_index, fap)) {
+        return -1;
+    }
+#endif
+
+    size = hdr->ih_hdr_size + hdr->ih_img_size + hdr->ih_protect_tlv_size;
+    if (off > size || len > size - off) {
+        return BOOT_EBADARGS;
+    }
+
+    rc = bootutil_img_find_blocks(hdr, fap, size, &block_size, &block_cnt,
+                                  &hashes_off);
+    if (rc) {
+        return rc;
+    }
+
+    rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_SHA256, false);
+    if (rc) {
+        return rc;
+    }
+    rc = bootutil_tlv_iter_next(&it, &tlv_off, &tlv_len, NULL);
+    if (rc != 0 || tlv_len != sizeof(hash)) {
+        return -1;
+    }
+    rc = LOAD_IMAGE_DATA(hdr, fap, tlv_off, hash, sizeof(hash));
+    if (rc) {
+        return rc;
+    }
+
+    bootutil_sha256_init(&sha256_ctx);
+    bootutil_sha256_update(&sha256_ctx, &block_size, sizeof(block_size));
+    for (block = 0; block < block_cnt; block++) {
+        rc = LOAD_IMAGE_DATA(hdr, fap,
+                             hashes_off + block * sizeof(stored_hash),
+                             stored_hash, sizeof(stored_hash));
+        if (rc) {
+            goto out;
+        }
+        bootutil_sha256_update(&sha256_ctx, stored_hash, sizeof(stored_hash));
+
+        if (len == 0 || (block + 1) * block_size <= off ||
+            block * block_size >= off + len) {
+            continue;
+        }
+
+        rc = bootutil_img_hash_block(enc_state, image_index, hdr, fap, tmp_buf,
+                                     tmp_buf_sz, size, block_size, block,
+                                     block_hash);
+        if (rc) {
+            goto out;
+        }
+        if (memcmp(block_hash, stored_hash, sizeof(block_hash))) {
+            rc = BOOT_EBADIMAGE;
+            goto out;
+        }
+    }
+
+    bootutil_sha256_finish(&sha256_ctx, block_hash);
+    if (memcmp(block_hash, hash, sizeof(hash))) {
+        rc = BOOT_EBADIMAGE;
+    }
+
+out:
+    bootutil_sha256_drop(&sha256_ctx);
+    return rc;
+}
+#endif /* MCUBOOT_HASH_BLOCKS */
+
+#ifdef MCUBOOT_ENC_AEAD
+/*
+ * The payload of an authenticated encrypted image (IMAGE_F_AEAD) is not part
+ * of the image hash. The protected IMAGE_TLV_ENC_AEAD TLV stands for it: it
+ * holds the key check value of the image key, the AES-CMAC of the encrypted
+ * payload and the SHA256 of the plain payload. In the secondary slot the
+ * payload is checked with one CMAC pass over the ciphertext, without
+ * decrypting it; elsewhere it is plain and its SHA256 is checked.
+ *
+ * Like the block hashes, the values checked are not taken from the TLV: the
+ * image hash is computed with the recomputed ones in their place, so that it
+ * only matches the SHA256 TLV, and the signature, if they are right. They
+ * must match the TLV too, or the image would not validate once copied to the
+ * other slot.
+ */
+static int
+bootutil_img_hash_aead(struct enc_key_data *enc_state, int image_index,
+                       struct image_header *hdr, const struct flash_area *fap,
+                       uint8_t *tmp_buf, uint32_t tmp_buf_sz,
+                       uint8_t *hash_result)
+{
+    bootutil_sha256_context sha256_ctx;
+    struct image_tlv_iter it;
+    uint8_t aead[BOOT_ENC_AEAD_TLV_SIZE];
+    uint8_t check[BOOT_ENC_AEAD_TLV_SIZE];
+    uint32_t check_off;
+    uint32_t check_len;
+    uint32_t payload_off;
+    uint32_t tlv_off;
+    uint32_t aead_off;
+    uint32_t size;
+    uint16_t len;
+    int rc;
+
+    if (!IS_ENCRYPTED(hdr) || (hdr->ih_flags & IMAGE_F_HASH_BLOCKS)) {
+        return -1;
+    }
+
+    payload_off = hdr->ih_hdr_size;
+    tlv_off = payload_off + hdr->ih_img_size;
+    size = tlv_off + hdr->ih_protect_tlv_size;
+
+    rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_ENC_AEAD, true);
+    if (rc) {
+        return rc;
+    }
+    rc = bootutil_tlv_iter_next(&it, &aead_off, &len, NULL);
+    if (rc != 0 || len != sizeof(aead)) {
+        return -1;
+    }
+    rc = LOAD_IMAGE_DATA(hdr, fap, aead_off, aead, sizeof(aead));
+    if (rc) {
+        return rc;
+    }
+
+    if (MUST_DECRYPT(fap, image_index, hdr)) {
+        check_off = 0;
+        check_len = BOOT_ENC_AEAD_KCV_SIZE + BOOT_ENC_AEAD_TAG_SIZE;
+        rc = boot_enc_mac(enc_state, image_index, fap, payload_off,
+                          hdr->ih_img_size, tmp_buf, tmp_buf_sz, check,
+                          &check[BOOT_ENC_AEAD_KCV_SIZE]);
+    } else {
+        check_off = BOOT_ENC_AEAD_KCV_SIZE + BOOT_ENC_AEAD_TAG_SIZE;
+        check_len = sizeof(aead) - check_off;
+        bootutil_sha256_init(&sha256_ctx);
+        rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap,
+                                     tmp_buf, tmp_buf_sz, &sha256_ctx,
+                                     payload_off, tlv_off);
+        if (rc == 0) {
+            bootutil_sha256_finish(&sha256_ctx, &check[check_off]);
+        }
+        bootutil_sha256_drop(&sha256_ctx);
+    }
+    if (rc) {
+        return rc;
+    }
+    if (memcmp(&aead[check_off], &check[check_off], check_len)) {
+        return BOOT_EBADIMAGE;
+    }
+    memcpy(&aead[check_off], &check[check_off], check_len);
+
+    bootutil_sha256_init(&sha256_ctx);
+    rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap, tmp_buf,
+                                 tmp_buf_sz, &sha256_ctx, 0, payload_off);
+    if (rc == 0) {
+        rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap,
+                                     tmp_buf, tmp_buf_sz, &sha256_ctx,
+                                     tlv_off, aead_off);
+    }
+    if (rc == 0) {
+        bootutil_sha256_update(&sha256_ctx, aead, sizeof(aead));
+        rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap,
+                                     tmp_buf, tmp_buf_sz, &sha256_ctx,
+                                     aead_off + sizeof(aead), size);
+    }
+    if (rc == 0) {
+        bootutil_sha256_finish(&sha256_ctx, hash_result);
+    }
+    bootutil_sha256_drop(&sha256_ctx);
+
+    return rc;
+}
+#endif /* MCUBOOT_ENC_AEAD */
+
+/*
+ * Compute SHA256 over the image.
+ */
+static int
+bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
+                  struct image_header *hdr, const struct flash_area *fap,
+                  uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *hash_result,
+                  uint8_t *seed, int seed_len)
+{
+    bootutil_sha256_context sha256_ctx;
+    uint32_t size;
+    int rc;
+
+#ifdef MCUBOOT_ENC_IMAGES
+    /* Encrypted images only exist in the secondary slot */
+    if (MUST_DECRYPT(fap, image_index, hdr) &&
+            !boot_enc_valid(enc_state, image_index, fap)) {
+        return -1;
+    }
+#endif
+
+    /* Hash is computed over image header and image itself. If protected TLVs
+     * are present they are also hashed.
+     */
+    size = hdr->ih_hdr_size + hdr->ih_img_size + hdr->ih_protect_tlv_size;
+
+    if (hdr->ih_flags & IMAGE_F_AEAD) {
+#ifdef MCUBOOT_ENC_AEAD
+        /* Split images, which are hashed with a seed, are not encrypted. */
+        if (seed && (seed_len > 0)) {
+            return -1;
+        }
+        return bootutil_img_hash_aead(enc_state, image_index, hdr, fap,
+                                      tmp_buf, tmp_buf_sz, hash_result);
+#else
+        return -1;
+#endif
+    }
+
+    if (hdr->ih_flags & IMAGE_F_HASH_BLOCKS) {
+#ifdef MCUBOOT_HASH_BLOCKS
+        /* A seed would have to be part of every block. */
+        if (seed && (seed_len > 0)) {
+            return -1;
+        }
+        return bootutil_img_hash_blocks(enc_state, image_index, hdr, fap,
+                                        tmp_buf, tmp_buf_sz, size,
+                                        hash_result);
+#else
+        return -1;
+#endif
+    }
+
+    bootutil_sha256_init(&sha256_ctx);
+
+    /* in some cases (split image) the hash is seeded with data from
+     * the loader image */
+    if (seed && (seed_len > 0)) {
+        bootutil_sha256_update(&sha256_ctx, seed, seed_len);
+    }
+
+    rc = bootutil_img_hash_range(enc_state, image_index, hdr, fap, tmp_buf,
+                                 tmp_buf_sz, &sha256_ctx, 0, size);
+    if (rc == 0) {
+        bootutil_sha256_finish(&sha256_ctx, hash_result);
+    }
+    bootutil_sha256_drop(&sha256_ctx);
+
+    return rc;
+}
+
 /*
  * Currently, we only support being able to verify one type of
  * signature, because there is a single verification function that we
@@ -166,7 +558,8 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
 #if (defined(MCUBOOT_SIGN_RSA)      + \
      defined(MCUBOOT_SIGN_EC)       + \
      defined(MCUBOOT_SIGN_EC256)    + \
-     defined(MCUBOOT_SIGN_ED25519)) > 1
+     defined(MCUBOOT_SIGN_ED25519)  + \
+     defined(MCUBOOT_SIGN_LMS)) > 1
 #error "Only a single signature type is supported!"
 #endif
 
@@ -192,6 +585,14 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
 #    define EXPECTED_SIG_TLV IMAGE_TLV_ED25519
 #    define SIG_BUF_SIZE 64
 #    define EXPECTED_SIG_LEN(x) ((x) == SIG_BUF_SIZE)
+#elif defined(MCUBOOT_SIGN_LMS)
+#    define EXPECTED_SIG_TLV IMAGE_TLV_LMS
+/* The largest signature with LMOTS_SHA256_N32_W4 or W8 and any height. */
+#    ifndef MCUBOOT_SIGN_LMS_MAX_SIG_LEN
+#        define MCUBOOT_SIGN_LMS_MAX_SIG_LEN 2988
+#    endif
+#    define SIG_BUF_SIZE MCUBOOT_SIGN_LMS_MAX_SIG_LEN
+#    define EXPECTED_SIG_LEN(x)  (1) /* the length depends on the key */
 #else
 #    define SIG_BUF_SIZE 32 /* no signing, sha256 digest only */
 #endif
@@ -478,8 +879,8 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
                 goto out;
             }
 
-            FIH_CALL(boot_nv_security_counter_get, fih_rc, image_index,
-                                                           &security_cnt);
+            FIH_CALL(boot_security_cnt_cache_get, fih_rc, image_index,
+                                                          &security_cnt);
             if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
                 goto out;
             }
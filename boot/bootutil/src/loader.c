@@ -111,6 +111,7 @@ static int
 boot_read_image_size(struct boot_loader_state *state, int slot, uint32_t *size)
 {
     const struct flash_area *fap;
+    const struct flash_area *img_fap;
     struct image_tlv_info info;
     uint32_t off;
     uint32_t protect_tlv_size;
@@ -127,10 +128,11 @@ boot_read_image_size(struct boot_loader_state *state, int slot, uint32_t *size)
         rc = BOOT_EFLASH;
         goto done;
     }
+    img_fap = boot_img_area_view(state, slot, fap);
 
     off = BOOT_TLV_OFF(boot_img_hdr(state, slot));
 
-    if (flash_area_read(fap, off, &info, sizeof(info))) {
+    if (flash_area_read(img_fap, off, &info, sizeof(info))) {
         rc = BOOT_EFLASH;
         goto done;
     }
@@ -142,7 +144,8 @@ boot_read_image_size(struct boot_loader_state *state, int slot, uint32_t *size)
             goto done;
         }
 
-        if (flash_area_read(fap, off + info.it_tlv_tot, &info, sizeof(info))) {
+        if (flash_area_read(img_fap, off + info.it_tlv_tot, &info,
+                            sizeof(info))) {
             rc = BOOT_EFLASH;
             goto done;
         }
@@ -343,12 +346,16 @@ int
 boot_write_status(const struct boot_loader_state *state, struct boot_status *bs)
 {
     const struct flash_area *fap;
+#ifndef MCUBOOT_TRAILER_COMPACT
     uint32_t off;
+#endif
     int area_id;
     int rc;
+#ifndef MCUBOOT_TRAILER_COMPACT
     uint8_t buf[BOOT_MAX_ALIGN];
     uint8_t align;
     uint8_t erased_val;
+#endif
 
     /* NOTE: The first sector copied (that is the last sector on slot) contains
      *       the trailer. Since in the last step the primary slot is erased, the
@@ -374,6 +381,14 @@ boot_write_status(const struct boot_loader_state *state, struct boot_status *bs)
         goto done;
     }
 
+#ifdef MCUBOOT_TRAILER_COMPACT
+    /* Entries are bits: the offset of an entry of size 1 is its index. */
+    rc = boot_write_status_bit(fap, boot_status_internal_off(bs, 1));
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+#else
     off = boot_status_off(fap) +
           boot_status_internal_off(bs, BOOT_WRITE_SZ(state));
     align = flash_area_align(fap);
@@ -386,6 +401,7 @@ boot_write_status(const struct boot_loader_state *state, struct boot_status *bs)
         rc = BOOT_EFLASH;
         goto done;
     }
+#endif
 
     rc = 0;
 
@@ -405,15 +421,10 @@ static fih_int
 boot_image_check(struct boot_loader_state *state, struct image_header *hdr,
                  const struct flash_area *fap, struct boot_status *bs)
 {
-    TARGET_STATIC uint8_t tmpbuf[BOOT_TMPBUF_SZ];
     uint8_t image_index;
     int rc;
     fih_int fih_rc = FIH_FAILURE;
 
-#if (BOOT_IMAGE_NUMBER == 1)
-    (void)state;
-#endif
-
     (void)bs;
     (void)rc;
 
@@ -432,7 +443,7 @@ boot_image_check(struct boot_loader_state *state, struct image_header *hdr,
 #endif
 
     FIH_CALL(bootutil_img_validate, fih_rc, BOOT_CURR_ENC(state), image_index,
-             hdr, fap, tmpbuf, BOOT_TMPBUF_SZ, NULL, 0, NULL);
+             hdr, fap, BOOT_IO_BUF(state), BOOT_IO_BUF_SZ, NULL, 0, NULL);
 
     FIH_RET(fih_rc);
 }
@@ -594,6 +605,7 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
                    struct boot_status *bs)
 {
     const struct flash_area *fap;
+    const struct flash_area *img_fap;
     struct image_header *hdr;
     int area_id;
     fih_int fih_rc = FIH_FAILURE;
@@ -609,7 +621,8 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
     if (boot_check_header_erased(state, slot) == 0 ||
         (hdr->ih_flags & IMAGE_F_NON_BOOTABLE)) {
 
-#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE)
+#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
+    defined(MCUBOOT_SWAP_USING_OFFSET)
         /*
          * This fixes an issue where an image might be erased, but a trailer
          * be left behind. It can happen if the image is in the secondary slot
@@ -648,8 +661,10 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
     }
 #endif
 
-    FIH_CALL(boot_image_check, fih_rc, state, hdr, fap, bs);
-    if (!boot_is_header_valid(hdr, fap) || fih_not_eq(fih_rc, FIH_SUCCESS)) {
+    img_fap = boot_img_area_view(state, slot, fap);
+    FIH_CALL(boot_image_check, fih_rc, state, hdr, img_fap, bs);
+    if (!boot_is_header_valid(hdr, img_fap) ||
+        fih_not_eq(fih_rc, FIH_SUCCESS)) {
         if ((slot != BOOT_PRIMARY_SLOT) || ARE_SLOTS_EQUIVALENT()) {
             flash_area_erase(fap, 0, fap->fa_size);
             /* Image is invalid, erase it to prevent further unnecessary
@@ -674,7 +689,8 @@ out:
 /**
  * Updates the stored security counter value with the image's security counter
  * value which resides in the given slot, only if it's greater than the stored
- * value.
+ * value. The update is staged in the security counter cache and written to
+ * the NV storage by boot_commit_security_counters().
  *
  * @param image_index   Index of the image to determine which security
  *                      counter to update.
@@ -704,7 +720,7 @@ boot_update_security_counter(uint8_t image_index, int slot,
         goto done;
     }
 
-    rc = boot_nv_security_counter_update(image_index, img_security_cnt);
+    rc = boot_security_cnt_cache_update(image_index, img_security_cnt);
     if (rc != 0) {
         goto done;
     }
@@ -713,6 +729,40 @@ done:
     flash_area_close(fap);
     return rc;
 }
+
+/**
+ * Loads the security counter cache at the start of the boot. If it fails,
+ * every access goes to the NV counters directly, as without the cache.
+ */
+static void
+boot_load_security_counters(void)
+{
+    fih_int fih_rc = FIH_FAILURE;
+
+    FIH_CALL(boot_security_cnt_cache_init, fih_rc);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        BOOT_LOG_WRN("Failed to cache the security counters.");
+    }
+}
+
+/**
+ * Writes all the security counter updates staged during the boot to the NV
+ * storage.
+ *
+ * @return              0 on success; nonzero on failure.
+ */
+static int
+boot_commit_security_counters(void)
+{
+    int rc;
+
+    rc = boot_security_cnt_cache_commit();
+    if (rc != 0) {
+        BOOT_LOG_ERR("Security counter update failed.");
+    }
+
+    return rc;
+}
 #endif /* MCUBOOT_HW_ROLLBACK_PROT */
 
 #if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
@@ -749,8 +799,37 @@ boot_validated_swap_type(struct boot_loader_state *state,
     return swap_type;
 }
 
+#ifdef MCUBOOT_ERASE_SKIP_ERASED
+/*
+ * Tells if a region of flash reads as erased. An erase which was interrupted
+ * can leave cells which read as erased but don't hold it, so this must only
+ * be enabled on flash where that can't happen, e.g. when the sectors were
+ * erased by boot_prestage_erase() and nothing else erases them.
+ */
+static bool
+boot_region_is_erased(const struct flash_area *fap, uint32_t off, uint32_t sz)
+{
+    uint8_t buf[64];
+    uint32_t chunk_sz;
+
+    while (sz > 0) {
+        chunk_sz = (sz < sizeof(buf)) ? sz : sizeof(buf);
+        if (flash_area_read(fap, off, buf, chunk_sz) != 0 ||
+            !bootutil_buffer_is_erased(fap, buf, chunk_sz)) {
+            return false;
+        }
+
+        off += chunk_sz;
+        sz -= chunk_sz;
+    }
+
+    return true;
+}
+#endif
+
 /**
- * Erases a region of flash.
+ * Erases a region of flash. With MCUBOOT_ERASE_SKIP_ERASED, a region which
+ * already reads as erased is left as it is.
  *
  * @param flash_area           The flash_area containing the region to erase.
  * @param off                   The offset within the flash area to start the
@@ -762,7 +841,18 @@ boot_validated_swap_type(struct boot_loader_state *state,
 int
 boot_erase_region(const struct flash_area *fap, uint32_t off, uint32_t sz)
 {
-    return flash_area_erase(fap, off, sz);
+    int rc;
+
+#ifdef MCUBOOT_ERASE_SKIP_ERASED
+    if (boot_region_is_erased(fap, off, sz)) {
+        boot_wdt_poll();
+        return 0;
+    }
+#endif
+
+    rc = flash_area_erase(fap, off, sz);
+    boot_wdt_poll();
+    return rc;
 }
 
 /**
@@ -798,16 +888,12 @@ boot_copy_region(struct boot_loader_state *state,
     uint8_t image_index;
 #endif
 
-    TARGET_STATIC uint8_t buf[1024];
-
-#if !defined(MCUBOOT_ENC_IMAGES)
-    (void)state;
-#endif
+    uint8_t *buf = BOOT_IO_BUF(state);
 
     bytes_copied = 0;
     while (bytes_copied < sz) {
-        if (sz - bytes_copied > sizeof buf) {
-            chunk_sz = sizeof buf;
+        if (sz - bytes_copied > BOOT_IO_BUF_SZ) {
+            chunk_sz = BOOT_IO_BUF_SZ;
         } else {
             chunk_sz = sz - bytes_copied;
         }
@@ -825,17 +911,26 @@ boot_copy_region(struct boot_loader_state *state,
               fap_dst->fa_id == FLASH_AREA_IMAGE_SECONDARY(image_index))) {
             /* assume the secondary slot as src, needs decryption */
             hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
-#if !defined(MCUBOOT_SWAP_USING_MOVE)
-            off = off_src;
+#if defined(MCUBOOT_SWAP_USING_MOVE)
+            off = off_dst;
             if (fap_dst->fa_id == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
-                /* might need encryption (metadata from the primary slot) */
                 hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
-                off = off_dst;
             }
-#else
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+            /* Images start at the start of the primary slot, but not always
+             * of the secondary slot, so use the offset in the primary slot.
+             */
             off = off_dst;
             if (fap_dst->fa_id == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
                 hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+                off = off_src;
+            }
+#else
+            off = off_src;
+            if (fap_dst->fa_id == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
+                /* might need encryption (metadata from the primary slot) */
+                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+                off = off_dst;
             }
 #endif
             if (IS_ENCRYPTED(hdr)) {
@@ -855,7 +950,7 @@ boot_copy_region(struct boot_loader_state *state,
                     if (off + bytes_copied >= tlv_off) {
                         blk_sz = 0;
                     } else {
-                        blk_sz = tlv_off - (off + bytes_copied);
+                        blk_sz = tlv_off - (off + bytes_copied) - idx;
                     }
                 }
                 boot_encrypt(BOOT_CURR_ENC(state), image_index, fap_src,
@@ -872,7 +967,7 @@ boot_copy_region(struct boot_loader_state *state,
 
         bytes_copied += chunk_sz;
 
-        MCUBOOT_WATCHDOG_FEED();
+        boot_wdt_poll();
     }
 
     return 0;
@@ -903,6 +998,7 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     size_t last_sector;
     const struct flash_area *fap_primary_slot;
     const struct flash_area *fap_secondary_slot;
+    const struct flash_area *fap_secondary_img;
     uint8_t image_index;
 
 #if defined(MCUBOOT_OVERWRITE_ONLY_FAST)
@@ -932,6 +1028,8 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index),
             &fap_secondary_slot);
     assert (rc == 0);
+    fap_secondary_img = boot_img_area_view(state, BOOT_SECONDARY_SLOT,
+                                           fap_secondary_slot);
 
     sect_count = boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
     for (sect = 0, size = 0; sect < sect_count; sect++) {
@@ -968,7 +1066,7 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     if (IS_ENCRYPTED(boot_img_hdr(state, BOOT_SECONDARY_SLOT))) {
         rc = boot_enc_load(BOOT_CURR_ENC(state), image_index,
                 boot_img_hdr(state, BOOT_SECONDARY_SLOT),
-                fap_secondary_slot, bs);
+                fap_secondary_img, bs);
 
         if (rc < 0) {
             return BOOT_EBADIMAGE;
@@ -981,7 +1079,8 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
 
     BOOT_LOG_INF("Copying the secondary slot to the primary slot: 0x%zx bytes",
                  size);
-    rc = boot_copy_region(state, fap_secondary_slot, fap_primary_slot, 0, 0, size);
+    rc = boot_copy_region(state, fap_secondary_img, fap_primary_slot, 0, 0,
+                          size);
     if (rc != 0) {
         return rc;
     }
@@ -1013,7 +1112,7 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
      * trailer that was left might trigger a new upgrade.
      */
     BOOT_LOG_DBG("erasing secondary header");
-    rc = boot_erase_region(fap_secondary_slot,
+    rc = boot_erase_region(fap_secondary_img,
                            boot_img_sector_off(state, BOOT_SECONDARY_SLOT, 0),
                            boot_img_sector_size(state, BOOT_SECONDARY_SLOT, 0));
     assert(rc == 0);
@@ -1104,7 +1203,8 @@ boot_swap_image(struct boot_loader_state *state, struct boot_status *bs)
 #ifdef MCUBOOT_ENC_IMAGES
         hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
         if (IS_ENCRYPTED(hdr)) {
-            fap = BOOT_IMG_AREA(state, BOOT_SECONDARY_SLOT);
+            fap = boot_img_area_view(state, BOOT_SECONDARY_SLOT,
+                    BOOT_IMG_AREA(state, BOOT_SECONDARY_SLOT));
             rc = boot_enc_load(BOOT_CURR_ENC(state), image_index, hdr, fap, bs);
             assert(rc >= 0);
 
@@ -1230,6 +1330,7 @@ static int
 boot_verify_slot_dependencies(struct boot_loader_state *state, uint32_t slot)
 {
     const struct flash_area *fap;
+    const struct flash_area *img_fap;
     struct image_tlv_iter it;
     struct image_dependency dep;
     uint32_t off;
@@ -1244,7 +1345,9 @@ boot_verify_slot_dependencies(struct boot_loader_state *state, uint32_t slot)
         goto done;
     }
 
-    rc = bootutil_tlv_iter_begin(&it, boot_img_hdr(state, slot), fap,
+    img_fap = boot_img_area_view(state, slot, fap);
+
+    rc = bootutil_tlv_iter_begin(&it, boot_img_hdr(state, slot), img_fap,
             IMAGE_TLV_DEPENDENCY, true);
     if (rc != 0) {
         goto done;
@@ -1264,7 +1367,7 @@ boot_verify_slot_dependencies(struct boot_loader_state *state, uint32_t slot)
             goto done;
         }
 
-        rc = flash_area_read(fap, off, &dep, len);
+        rc = flash_area_read(img_fap, off, &dep, len);
         if (rc != 0) {
             rc = BOOT_EFLASH;
             goto done;
@@ -1324,6 +1427,80 @@ boot_verify_dependencies(struct boot_loader_state *state)
     }
     return rc;
 }
+
+#ifdef MCUBOOT_STAGED_BOOT
+/**
+ * Reads the dependency TLVs of the image in a slot of the current image.
+ *
+ * @param slot              Image slot number.
+ * @param images            On success, bit N is set for each dependency on
+ *                          image N.
+ *
+ * @return                  0 on success; nonzero on failure.
+ */
+static int
+boot_read_slot_dependency_images(struct boot_loader_state *state,
+                                 uint32_t slot, uint32_t *images)
+{
+    const struct flash_area *fap;
+    const struct flash_area *img_fap;
+    struct image_tlv_iter it;
+    struct image_dependency dep;
+    uint32_t off;
+    uint16_t len;
+    int area_id;
+    int rc;
+
+    *images = 0;
+
+    area_id = flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state), slot);
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    img_fap = boot_img_area_view(state, slot, fap);
+
+    rc = bootutil_tlv_iter_begin(&it, boot_img_hdr(state, slot), img_fap,
+            IMAGE_TLV_DEPENDENCY, true);
+    if (rc != 0) {
+        goto done;
+    }
+
+    while (true) {
+        rc = bootutil_tlv_iter_next(&it, &off, &len, NULL);
+        if (rc < 0) {
+            rc = BOOT_EBADIMAGE;
+            goto done;
+        } else if (rc > 0) {
+            rc = 0;
+            break;
+        }
+
+        if (len != sizeof(dep)) {
+            rc = BOOT_EBADIMAGE;
+            goto done;
+        }
+
+        rc = flash_area_read(img_fap, off, &dep, len);
+        if (rc != 0) {
+            rc = BOOT_EFLASH;
+            goto done;
+        }
+
+        if (dep.image_id >= BOOT_IMAGE_NUMBER) {
+            rc = BOOT_EBADARGS;
+            goto done;
+        }
+
+        *images |= 1u << dep.image_id;
+    }
+
+done:
+    flash_area_close(fap);
+    return rc;
+}
+#endif /* MCUBOOT_STAGED_BOOT */
 #endif /* (BOOT_IMAGE_NUMBER > 1) */
 
 /**
@@ -1575,7 +1752,7 @@ boot_prepare_image_for_update(struct boot_loader_state *state,
         }
 #endif
 
-#ifdef MCUBOOT_SWAP_USING_MOVE
+#if defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_OFFSET)
         /*
          * Must re-read image headers because the boot status might
          * have been updated in the previous function call.
@@ -1680,6 +1857,310 @@ boot_prepare_image_for_update(struct boot_loader_state *state,
     }
 }
 
+#if defined(MCUBOOT_MEASURED_BOOT) || defined(MCUBOOT_DATA_SHARING)
+/**
+ * Adds the measurements and the data of the image in the primary slot of the
+ * current image to the memory area shared with the runtime software.
+ *
+ * @param  state        Boot loader status information.
+ *
+ * @return              0 on success; nonzero on failure.
+ */
+static int
+boot_share_primary_data(struct boot_loader_state *state)
+{
+    int rc = 0;
+
+#ifdef MCUBOOT_MEASURED_BOOT
+    rc = boot_save_boot_status(BOOT_CURR_IMG(state),
+                               boot_img_hdr(state, BOOT_PRIMARY_SLOT),
+                               BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
+    if (rc != 0) {
+        BOOT_LOG_ERR("Failed to add Image %u data to shared memory area",
+                     BOOT_CURR_IMG(state));
+        return rc;
+    }
+#endif /* MCUBOOT_MEASURED_BOOT */
+
+#ifdef MCUBOOT_DATA_SHARING
+    rc = boot_save_shared_data(boot_img_hdr(state, BOOT_PRIMARY_SLOT),
+                               BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
+    if (rc != 0) {
+        BOOT_LOG_ERR("Failed to add data to shared memory area.");
+        return rc;
+    }
+#endif /* MCUBOOT_DATA_SHARING */
+
+    return rc;
+}
+#endif /* MCUBOOT_MEASURED_BOOT || MCUBOOT_DATA_SHARING */
+
+#ifdef MCUBOOT_WARM_BOOT
+/**
+ * Boots the images recorded in retained RAM by the previous boot, if the
+ * record is still valid. The image slots are only opened again to share the
+ * data of the images with the runtime software.
+ *
+ * @param  state        Boot loader status information.
+ * @param  rsp          On success, the response for the image to boot.
+ *
+ * @return              FIH_SUCCESS if the response was filled in; otherwise
+ *                      the boot has to go the normal way.
+ */
+static fih_int
+boot_go_warm(struct boot_loader_state *state, struct boot_rsp *rsp)
+{
+    fih_int fih_rc = FIH_FAILURE;
+#if defined(MCUBOOT_MEASURED_BOOT) || defined(MCUBOOT_DATA_SHARING)
+    int rc;
+#endif
+
+    FIH_CALL(boot_warm_load, fih_rc, state, rsp);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(fih_rc);
+    }
+
+#if defined(MCUBOOT_MEASURED_BOOT) || defined(MCUBOOT_DATA_SHARING)
+    IMAGES_ITER(BOOT_CURR_IMG(state)) {
+        rc = flash_area_open(
+                flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state),
+                                                    BOOT_PRIMARY_SLOT),
+                &BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
+        if (rc == 0) {
+            rc = boot_share_primary_data(state);
+            flash_area_close(BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
+        }
+        if (rc != 0) {
+            FIH_RET(FIH_FAILURE);
+        }
+    }
+
+#if (BOOT_IMAGE_NUMBER > 1)
+    BOOT_CURR_IMG(state) = 0;
+#endif
+#endif /* MCUBOOT_MEASURED_BOOT || MCUBOOT_DATA_SHARING */
+
+    FIH_RET(fih_rc);
+}
+#endif /* MCUBOOT_WARM_BOOT */
+
+/**
+ * Checks the image in the primary slot of the current image before it is
+ * booted, updates its security counter and shares its data with the runtime
+ * software.
+ *
+ * @param  state        Boot loader status information.
+ *
+ * @return              FIH_SUCCESS if the image can be booted.
+ */
+static fih_int
+boot_check_primary_slot(struct boot_loader_state *state)
+{
+    fih_int fih_rc = FIH_FAILURE;
+#if defined(MCUBOOT_HW_ROLLBACK_PROT) || defined(MCUBOOT_MEASURED_BOOT) || \
+    defined(MCUBOOT_DATA_SHARING)
+    int rc;
+#endif
+
+#ifdef MCUBOOT_VALIDATE_PRIMARY_SLOT
+    FIH_CALL(boot_validate_slot, fih_rc, state, BOOT_PRIMARY_SLOT, NULL);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(fih_rc);
+    }
+#else
+    /* Even if we're not re-validating the primary slot, we could be booting
+     * onto an empty flash chip. At least do a basic sanity check that
+     * the magic number on the image is OK.
+     */
+    if (BOOT_IMG(state, BOOT_PRIMARY_SLOT).hdr.ih_magic != IMAGE_MAGIC) {
+        BOOT_LOG_ERR("bad image magic 0x%lx; Image=%u", (unsigned long)
+                     &boot_img_hdr(state,BOOT_PRIMARY_SLOT)->ih_magic,
+                     BOOT_CURR_IMG(state));
+        FIH_RET(fih_int_encode(BOOT_EBADIMAGE));
+    }
+    fih_rc = FIH_SUCCESS;
+#endif /* MCUBOOT_VALIDATE_PRIMARY_SLOT */
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    /* Update the stored security counter with the active image's security
+     * counter value. It will only be updated if the new security counter is
+     * greater than the stored value.
+     *
+     * In case of a successful image swapping when the swap type is TEST the
+     * security counter can be increased only after a reset, when the swap
+     * type is NONE and the image has marked itself "OK" (the image_ok flag
+     * has been set). This way a "revert" can be performed when it's
+     * necessary.
+     */
+    if (BOOT_SWAP_TYPE(state) == BOOT_SWAP_TYPE_NONE) {
+        rc = boot_update_security_counter(
+                                BOOT_CURR_IMG(state),
+                                BOOT_PRIMARY_SLOT,
+                                boot_img_hdr(state, BOOT_PRIMARY_SLOT));
+        if (rc != 0) {
+            BOOT_LOG_ERR("Security counter update failed after image "
+                         "validation.");
+            FIH_RET(fih_int_encode(rc));
+        }
+    }
+#endif /* MCUBOOT_HW_ROLLBACK_PROT */
+
+#if defined(MCUBOOT_MEASURED_BOOT) || defined(MCUBOOT_DATA_SHARING)
+    rc = boot_share_primary_data(state);
+    if (rc != 0) {
+        FIH_RET(fih_int_encode(rc));
+    }
+#endif
+
+    FIH_RET(fih_rc);
+}
+
+/**
+ * Fills in the response for booting the primary slot of Image 0.
+ */
+static void
+boot_fill_rsp(struct boot_loader_state *state, struct boot_rsp *rsp)
+{
+#if (BOOT_IMAGE_NUMBER > 1)
+    BOOT_CURR_IMG(state) = 0;
+#endif
+
+    rsp->br_flash_dev_id = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT)->fa_device_id;
+    rsp->br_image_off = boot_img_slot_off(state, BOOT_PRIMARY_SLOT);
+    rsp->br_hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+}
+
+#ifdef MCUBOOT_STAGED_BOOT
+/**
+ * Selects the images whose primary slot is only checked after the handoff,
+ * by context_boot_go_deferred(): those of MCUBOOT_DEFERRED_IMAGES, except
+ * the ones an image checked before the handoff depends on, directly or
+ * through other images. The headers of the primary slots must be up to date.
+ *
+ * @param  state        Boot loader status information.
+ */
+static void
+boot_select_deferred_images(struct boot_loader_state *state)
+{
+    uint32_t deferred = MCUBOOT_DEFERRED_IMAGES;
+    uint32_t read = 0;
+    uint32_t images;
+    uint32_t bit;
+    bool promoted;
+    int rc;
+
+    do {
+        promoted = false;
+
+        IMAGES_ITER(BOOT_CURR_IMG(state)) {
+            bit = 1u << BOOT_CURR_IMG(state);
+            if ((deferred | read) & bit) {
+                continue;
+            }
+
+            rc = boot_read_slot_dependency_images(state, BOOT_PRIMARY_SLOT,
+                                                  &images);
+            if (rc != 0) {
+                /* Unknown dependencies: check everything before the handoff;
+                 * the check of this image reports the error.
+                 */
+                state->deferred = 0;
+                return;
+            }
+            read |= bit;
+
+            if (deferred & images) {
+                deferred &= ~images;
+                promoted = true;
+            }
+        }
+    } while (promoted);
+
+    state->deferred = deferred;
+}
+
+fih_int
+context_boot_go_deferred(struct boot_loader_state *state, uint32_t *failed)
+{
+    size_t slot;
+    int rc = 0;
+    fih_int fih_rc = FIH_FAILURE;
+    fih_int fih_img_rc = FIH_FAILURE;
+    int fa_id;
+#ifdef MCUBOOT_WARM_BOOT
+    struct boot_rsp rsp;
+#endif
+
+    *failed = 0;
+
+    if (!state->handoff) {
+        /* No successful boot to continue. */
+        FIH_RET(FIH_FAILURE);
+    }
+    state->handoff = false;
+
+#ifdef MCUBOOT_FLASH_CACHE
+    /* The booted image may have written to the flash since. */
+    boot_flash_cache_invalidate();
+#endif
+
+    IMAGES_ITER(BOOT_CURR_IMG(state)) {
+        for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
+            fa_id = flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state),
+                                                        slot);
+            rc = flash_area_open(fa_id, &BOOT_IMG_AREA(state, slot));
+            assert(rc == 0);
+        }
+    }
+
+    IMAGES_ITER(BOOT_CURR_IMG(state)) {
+        if (!(state->deferred & (1u << BOOT_CURR_IMG(state)))) {
+            continue;
+        }
+
+        FIH_CALL(boot_check_primary_slot, fih_img_rc, state);
+        if (fih_not_eq(fih_img_rc, FIH_SUCCESS)) {
+            BOOT_LOG_ERR("Image %u: deferred check failed",
+                         BOOT_CURR_IMG(state));
+            *failed |= 1u << BOOT_CURR_IMG(state);
+        }
+    }
+
+    state->deferred = 0;
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    rc = boot_commit_security_counters();
+    if (rc != 0) {
+        goto out;
+    }
+#endif
+
+    if (*failed != 0) {
+        goto out;
+    }
+
+#ifdef MCUBOOT_WARM_BOOT
+    /* Only now were all the images checked. */
+    boot_fill_rsp(state, &rsp);
+    boot_warm_save(state, &rsp);
+#endif
+
+    fih_rc = FIH_SUCCESS;
+out:
+    IMAGES_ITER(BOOT_CURR_IMG(state)) {
+        for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
+            flash_area_close(BOOT_IMG_AREA(state, BOOT_NUM_SLOTS - 1 - slot));
+        }
+    }
+
+    if (rc) {
+        fih_rc = fih_int_encode(rc);
+    }
+
+    FIH_RET(fih_rc);
+}
+#endif /* MCUBOOT_STAGED_BOOT */
+
 fih_int
 context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 {
@@ -1706,8 +2187,28 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 #endif
 
     memset(state, 0, sizeof(struct boot_loader_state));
+
+#ifdef MCUBOOT_FLASH_CACHE
+    /* The flash may have been modified since the cache was last used. */
+    boot_flash_cache_invalidate();
+#endif
     has_upgrade = false;
 
+#ifdef MCUBOOT_WARM_BOOT
+    FIH_CALL(boot_go_warm, fih_rc, state, rsp);
+    if (fih_eq(fih_rc, FIH_SUCCESS)) {
+#ifdef MCUBOOT_STAGED_BOOT
+        /* All the images were checked by the recorded boot. */
+        state->handoff = true;
+#endif
+        FIH_RET(fih_rc);
+    }
+#endif
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    boot_load_security_counters();
+#endif
+
 #if (BOOT_IMAGE_NUMBER == 1)
     (void)has_upgrade;
 #endif
@@ -1840,8 +2341,8 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
     }
 
     /* Iterate over all the images. At this point all required update operations
-     * have finished. By the end of the loop each image in the primary slot will
-     * have been re-validated.
+     * have finished. By the end of the loop the headers of the images in the
+     * primary slots are up to date.
      */
     IMAGES_ITER(BOOT_CURR_IMG(state)) {
         if (BOOT_SWAP_TYPE(state) != BOOT_SWAP_TYPE_NONE) {
@@ -1858,76 +2359,29 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
              * secondary slot, was updated to primary slot.
              */
         }
+    }
 
-#ifdef MCUBOOT_VALIDATE_PRIMARY_SLOT
-        FIH_CALL(boot_validate_slot, fih_rc, state, BOOT_PRIMARY_SLOT, NULL);
-        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
-            goto out;
-        }
-#else
-        /* Even if we're not re-validating the primary slot, we could be booting
-         * onto an empty flash chip. At least do a basic sanity check that
-         * the magic number on the image is OK.
-         */
-        if (BOOT_IMG(state, BOOT_PRIMARY_SLOT).hdr.ih_magic != IMAGE_MAGIC) {
-            BOOT_LOG_ERR("bad image magic 0x%lx; Image=%u", (unsigned long)
-                         &boot_img_hdr(state,BOOT_PRIMARY_SLOT)->ih_magic,
-                         BOOT_CURR_IMG(state));
-            rc = BOOT_EBADIMAGE;
-            goto out;
-        }
-#endif /* MCUBOOT_VALIDATE_PRIMARY_SLOT */
-
-#ifdef MCUBOOT_HW_ROLLBACK_PROT
-        /* Update the stored security counter with the active image's security
-         * counter value. It will only be updated if the new security counter is
-         * greater than the stored value.
-         *
-         * In case of a successful image swapping when the swap type is TEST the
-         * security counter can be increased only after a reset, when the swap
-         * type is NONE and the image has marked itself "OK" (the image_ok flag
-         * has been set). This way a "revert" can be performed when it's
-         * necessary.
-         */
-        if (BOOT_SWAP_TYPE(state) == BOOT_SWAP_TYPE_NONE) {
-            rc = boot_update_security_counter(
-                                    BOOT_CURR_IMG(state),
-                                    BOOT_PRIMARY_SLOT,
-                                    boot_img_hdr(state, BOOT_PRIMARY_SLOT));
-            if (rc != 0) {
-                BOOT_LOG_ERR("Security counter update failed after image "
-                             "validation.");
-                goto out;
-            }
-        }
-#endif /* MCUBOOT_HW_ROLLBACK_PROT */
+#ifdef MCUBOOT_STAGED_BOOT
+    boot_select_deferred_images(state);
+#endif
 
-#ifdef MCUBOOT_MEASURED_BOOT
-        rc = boot_save_boot_status(BOOT_CURR_IMG(state),
-                                   boot_img_hdr(state, BOOT_PRIMARY_SLOT),
-                                   BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
-        if (rc != 0) {
-            BOOT_LOG_ERR("Failed to add Image %u data to shared memory area",
-                         BOOT_CURR_IMG(state));
-            goto out;
+    /* Iterate over all the images. By the end of the loop each image in the
+     * primary slot will have been re-validated, except the deferred ones.
+     */
+    IMAGES_ITER(BOOT_CURR_IMG(state)) {
+#ifdef MCUBOOT_STAGED_BOOT
+        if (state->deferred & (1u << BOOT_CURR_IMG(state))) {
+            BOOT_LOG_INF("Image %u: check deferred", BOOT_CURR_IMG(state));
+            continue;
         }
-#endif /* MCUBOOT_MEASURED_BOOT */
+#endif
 
-#ifdef MCUBOOT_DATA_SHARING
-        rc = boot_save_shared_data(boot_img_hdr(state, BOOT_PRIMARY_SLOT),
-                                   BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT));
-        if (rc != 0) {
-            BOOT_LOG_ERR("Failed to add data to shared memory area.");
+        FIH_CALL(boot_check_primary_slot, fih_rc, state);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
             goto out;
         }
-#endif /* MCUBOOT_DATA_SHARING */
     }
 
-#if (BOOT_IMAGE_NUMBER > 1)
-    /* Always boot from the primary slot of Image 0. */
-    BOOT_CURR_IMG(state) = 0;
-#endif
-
     /*
      * Since the boot_status struct stores plaintext encryption keys, reset
      * them here to avoid the possibility of jumping into an image that could
@@ -1935,9 +2389,22 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
      */
     memset(&bs, 0, sizeof(struct boot_status));
 
-    rsp->br_flash_dev_id = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT)->fa_device_id;
-    rsp->br_image_off = boot_img_slot_off(state, BOOT_PRIMARY_SLOT);
-    rsp->br_hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    rc = boot_commit_security_counters();
+    if (rc != 0) {
+        goto out;
+    }
+#endif
+
+    /* Always boot from the primary slot of Image 0. */
+    boot_fill_rsp(state, rsp);
+
+#ifdef MCUBOOT_STAGED_BOOT
+    state->handoff = true;
+#elif defined(MCUBOOT_WARM_BOOT)
+    /* With a staged boot, recorded once the deferred images were checked. */
+    boot_warm_save(state, rsp);
+#endif
 
     fih_rc = FIH_SUCCESS;
 out:
@@ -2028,57 +2495,93 @@ done:
 #else /* MCUBOOT_DIRECT_XIP || MCUBOOT_RAM_LOAD */
 
 /**
- * Iterates over all slots and determines which contain a firmware image.
+ * Iterates over all slots of the current image and marks the ones that
+ * contain a firmware image as boot candidates.
  *
  * @param state          Boot loader status information.
- * @param slot_usage     Pointer to an array, which aim is to carry information
- *                       about slots that contain an image. After return the
- *                       corresponding array elements are set to a non-zero
- *                       value if the given slots are in use (contain a firmware
- *                       image), otherwise they are set to zero.
- * @param slot_cnt       The number of slots, which can contain firmware images.
- *                       (Equal to or smaller than the size of the
- *                       slot_usage array.)
  *
  * @return               The number of found images.
  */
 static uint32_t
-boot_get_slot_usage(struct boot_loader_state *state, uint8_t slot_usage[],
-                    uint32_t slot_cnt)
+boot_find_candidates(struct boot_loader_state *state)
 {
     struct image_header *hdr = NULL;
     uint32_t image_cnt = 0;
     uint32_t slot;
 
-    memset(slot_usage, 0, slot_cnt);
+    state->candidates = 0;
 
-    for (slot = 0; slot < slot_cnt; slot++) {
+    for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
         hdr = boot_img_hdr(state, slot);
 
         if (boot_is_header_valid(hdr, BOOT_IMG_AREA(state, slot))) {
-            slot_usage[slot] = 1;
+            state->candidates |= 1u << slot;
             image_cnt++;
             BOOT_LOG_IMAGE_INFO(slot, hdr);
         } else {
-            BOOT_LOG_INF("%s slot: Image not found", (slot == BOOT_PRIMARY_SLOT)
-                         ? "Primary" : "Secondary");
+            BOOT_LOG_INF("%s slot %u: Image not found", BOOT_SLOT_NAME(slot),
+                         (unsigned)slot);
         }
     }
 
     return image_cnt;
 }
 
+/**
+ * Looks up the candidate slot which holds the newest image.  When several
+ * candidates hold the same version, the one in the lowest slot is returned.
+ *
+ * @param state          Boot loader status information.
+ *
+ * @return               The slot number of the newest candidate;
+ *                       BOOT_NUM_SLOTS if there are no candidates left.
+ */
+static uint32_t
+boot_find_newest_slot(struct boot_loader_state *state)
+{
+    struct image_header *hdr;
+    struct image_header *selected_hdr = NULL;
+    uint32_t selected_slot = BOOT_NUM_SLOTS;
+    uint32_t slot;
+
+    for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
+        if (!(state->candidates & (1u << slot))) {
+            continue;
+        }
+
+        hdr = boot_img_hdr(state, slot);
+        if (selected_hdr != NULL &&
+            boot_version_cmp(&hdr->ih_ver, &selected_hdr->ih_ver) < 1) {
+            /* The version of the image being examined isn't greater than
+             * the currently selected image's version.
+             */
+            continue;
+        }
+
+        selected_slot = slot;
+        selected_hdr = hdr;
+    }
+
+    return selected_slot;
+}
+
 #ifdef MCUBOOT_DIRECT_XIP_REVERT
 /**
  * Checks whether the image in the given slot was previously selected to run.
  * Erases the image if it was selected but its execution failed, otherwise marks
  * it as selected if it has not been before.
  *
- * @param state     Image metadata from the image trailer. This function fills
- *                  this struct with the data read from the image trailer.
- * @param slot      Image slot number.
+ * With MCUBOOT_BOOT_ATTEMPTS, an image that has not been confirmed is booted
+ * up to that many times, each attempt being recorded in its trailer. Once the
+ * attempts are used up the image is rejected but left intact, so rolling back
+ * to the previous image costs no erase at all.
  *
- * @return          0 on success; nonzero on failure.
+ * @param state       Image metadata from the image trailer. This function
+ *                    fills this struct with the data read from the image
+ *                    trailer.
+ * @param slot        Image slot number.
+ *
+ * @return            0 on success; nonzero on failure.
  */
 static int
 boot_select_or_erase(struct boot_swap_state *state, uint32_t slot)
@@ -2086,6 +2589,9 @@ boot_select_or_erase(struct boot_swap_state *state, uint32_t slot)
     const struct flash_area *fap;
     int fa_id;
     int rc;
+#ifdef MCUBOOT_BOOT_ATTEMPTS
+    uint8_t attempts = 0;
+#endif
 
     fa_id = flash_area_id_from_image_slot(slot);
     rc = flash_area_open(fa_id, &fap);
@@ -2095,16 +2601,37 @@ boot_select_or_erase(struct boot_swap_state *state, uint32_t slot)
     rc = boot_read_swap_state(fap, state);
     assert(rc == 0);
 
-    if (state->magic != BOOT_MAGIC_GOOD ||
-        (state->copy_done == BOOT_FLAG_SET &&
-         state->image_ok  != BOOT_FLAG_SET)) {
+#ifdef MCUBOOT_BOOT_ATTEMPTS
+    if (state->magic == BOOT_MAGIC_GOOD && state->image_ok != BOOT_FLAG_SET) {
+        rc = boot_read_boot_attempts(fap, &attempts);
+        if (rc == 0 && attempts < MCUBOOT_BOOT_ATTEMPTS) {
+            /* Consume an attempt before booting the image. If it can't be
+             * recorded the image could be retried forever, so reject it.
+             */
+            rc = boot_write_boot_attempt(fap, attempts);
+        }
+        if (rc != 0 || attempts >= MCUBOOT_BOOT_ATTEMPTS) {
+            BOOT_LOG_INF("Image in slot %u was not confirmed after %u boot "
+                         "attempts, rejecting it.", (unsigned)slot,
+                         (unsigned)attempts);
+            flash_area_close(fap);
+            return -1;
+        }
+    }
+#endif
+
+    if (state->magic != BOOT_MAGIC_GOOD
+#ifndef MCUBOOT_BOOT_ATTEMPTS
+        || (state->copy_done == BOOT_FLAG_SET &&
+            state->image_ok  != BOOT_FLAG_SET)
+#endif
+        ) {
         /*
          * A reboot happened without the image being confirmed at
          * runtime or its trailer is corrupted/invalid. Erase the image
          * to prevent it from being selected again on the next reboot.
          */
-        BOOT_LOG_DBG("Erasing faulty image in the %s slot.",
-                     (slot == BOOT_PRIMARY_SLOT) ? "primary" : "secondary");
+        BOOT_LOG_DBG("Erasing faulty image in slot %u.", (unsigned)slot);
         rc = flash_area_erase(fap, 0, fap->fa_size);
         assert(rc == 0);
 
@@ -2125,8 +2652,7 @@ boot_select_or_erase(struct boot_swap_state *state, uint32_t slot)
             rc = boot_write_copy_done(fap);
             if (rc != 0) {
                 BOOT_LOG_WRN("Failed to set copy_done flag of the image in "
-                             "the %s slot.", (slot == BOOT_PRIMARY_SLOT) ?
-                             "primary" : "secondary");
+                             "slot %u.", (unsigned)slot);
                 rc = 0;
             }
         }
@@ -2283,13 +2809,10 @@ boot_remove_image_from_sram(uint32_t img_dst, uint32_t img_sz)
 fih_int
 context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 {
-    struct image_header *hdr = NULL;
     struct image_header *selected_image_header = NULL;
-    uint8_t slot_usage[BOOT_NUM_SLOTS];
     uint32_t selected_slot;
     uint32_t slot;
     uint32_t img_cnt;
-    uint32_t i;
     int fa_id;
     int rc;
 #ifdef MCUBOOT_RAM_LOAD
@@ -2304,9 +2827,16 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 
     memset(state, 0, sizeof(struct boot_loader_state));
 
-    /* Open primary and secondary image areas for the duration
-     * of this call.
-     */
+#ifdef MCUBOOT_FLASH_CACHE
+    /* The flash may have been modified since the cache was last used. */
+    boot_flash_cache_invalidate();
+#endif
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    boot_load_security_counters();
+#endif
+
+    /* Open all the image areas for the duration of this call. */
     for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
         fa_id = flash_area_id_from_image_slot(slot);
         rc = flash_area_open(fa_id, &BOOT_IMG_AREA(state, slot));
@@ -2320,42 +2850,22 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
         goto out;
     }
 
-    img_cnt = boot_get_slot_usage(state, slot_usage,
-                                  sizeof(slot_usage)/sizeof(slot_usage[0]));
+    img_cnt = boot_find_candidates(state);
 
     if (img_cnt) {
-        /* Select the newest and valid image. */
-        for (i = 0; i < img_cnt; i++) {
-            selected_slot = 0;
-
-            /* Iterate over all the slots that are in use (contain an image)
-             * and select the one that holds the newest image.
-             */
-            for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
-                if (slot_usage[slot]) {
-                    hdr = boot_img_hdr(state, slot);
-                    if (selected_image_header != NULL) {
-                        rc = boot_version_cmp(&hdr->ih_ver,
-                                              &selected_image_header->ih_ver);
-                        if (rc < 1) {
-                            /* The version of the image being examined wasn't
-                             * greater than the currently selected image's
-                             * version.
-                             */
-                            continue;
-                        }
-                    }
-                    selected_slot = slot;
-                    selected_image_header = hdr;
-                }
-            }
+        /* Select the newest and valid image. Every candidate that is
+         * rejected drops out of the candidates, so each slot is tried at
+         * most once.
+         */
+        while ((selected_slot = boot_find_newest_slot(state)) !=
+               BOOT_NUM_SLOTS) {
+            selected_image_header = boot_img_hdr(state, selected_slot);
 
 #ifdef MCUBOOT_DIRECT_XIP_REVERT
             rc = boot_select_or_erase(&slot_state, selected_slot);
             if (rc != 0) {
-                /* The selected image slot has been erased. */
-                slot_usage[selected_slot] = 0;
-                selected_image_header = NULL;
+                /* The selected image slot has been erased or rejected. */
+                state->candidates &= ~(1u << selected_slot);
                 continue;
             }
 #endif /* MCUBOOT_DIRECT_XIP_REVERT */
@@ -2371,8 +2881,7 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
                                          &img_sz);
             if (rc != 0 ) {
                 /* Image loading failed try the next one. */
-                slot_usage[selected_slot] = 0;
-                selected_image_header = NULL;
+                state->candidates &= ~(1u << selected_slot);
                 continue;
             } else {
                 img_loaded = 1;
@@ -2395,14 +2904,14 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
                 img_loaded = 0;
             }
 #endif /* MCUBOOT_RAM_LOAD */
-            /* The selected image is invalid, mark its slot as "unused"
+            /* The selected image is invalid, drop it from the candidates
              * and start over.
              */
-            slot_usage[selected_slot] = 0;
-            selected_image_header = NULL;
+            state->candidates &= ~(1u << selected_slot);
         }
 
-        if (fih_not_eq(fih_rc, FIH_SUCCESS) || (selected_image_header == NULL)) {
+        if (fih_not_eq(fih_rc, FIH_SUCCESS) ||
+            (selected_slot == BOOT_NUM_SLOTS)) {
             /* If there was no valid image at all */
             goto out;
         }
@@ -2429,6 +2938,11 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 #ifdef MCUBOOT_DIRECT_XIP_REVERT
         }
 #endif
+
+        rc = boot_commit_security_counters();
+        if (rc != 0) {
+            goto out;
+        }
 #endif /* MCUBOOT_HW_ROLLBACK_PROT */
 
 #ifdef MCUBOOT_MEASURED_BOOT
@@ -2447,9 +2961,7 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
         }
 #endif /* MCUBOOT_DATA_SHARING */
 
-        BOOT_LOG_INF("Booting image from the %s slot",
-                     (selected_slot == BOOT_PRIMARY_SLOT) ?
-                     "primary" : "secondary");
+        BOOT_LOG_INF("Booting image from slot %u", (unsigned)selected_slot);
 
         rsp->br_flash_dev_id =
             BOOT_IMG_AREA(state, selected_slot)->fa_device_id;
@@ -2489,3 +3001,22 @@ boot_go(struct boot_rsp *rsp)
     FIH_CALL(context_boot_go, fih_rc, &boot_data, rsp);
     FIH_RET(fih_rc);
 }
+
+#ifdef MCUBOOT_STAGED_BOOT
+/**
+ * Checks the images deferred by the last boot_go(), once the image it
+ * returned was started.
+ *
+ * @param failed                On return, bit N is set if image N failed its
+ *                              check and must not be started.
+ *
+ * @return                      FIH_SUCCESS if all of them can be started.
+ */
+fih_int
+boot_go_deferred(uint32_t *failed)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    FIH_CALL(context_boot_go_deferred, fih_rc, &boot_data, failed);
+    FIH_RET(fih_rc);
+}
+#endif /* MCUBOOT_STAGED_BOOT */
@@ -0,0 +1,473 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Preparation of an upgrade by the running image.
+ *
+ * The swap erases every sector before writing to it. Those which hold no
+ * image and no trailer when the upgrade is marked pending, the end of both
+ * slots past their images and the scratch area, can be erased by the image
+ * beforehand, and a boot loader built with MCUBOOT_ERASE_SKIP_ERASED only
+ * reads them back. The check of the new image is done here too, so that an
+ * image which the boot loader would refuse is never marked pending.
+ *
+ * This runs without the state of the boot loader: the slots are read
+ * through the flash map, the same way as boot_set_pending() does.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
+
+#include "sysflash/sysflash.h"
+#include "flash_map_backend/flash_map_backend.h"
+
+#include "bootutil/image.h"
+#include "bootutil/bootutil.h"
+#include "bootutil/prestage.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil_priv.h"
+
+MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
+
+static boot_sector_t boot_prestage_sectors[BOOT_MAX_IMG_SECTORS];
+
+/*
+ * Reads the sectors of a flash area into boot_prestage_sectors.
+ */
+static int
+boot_prestage_read_sectors(int area_id, size_t *num_sectors)
+{
+#ifdef MCUBOOT_USE_FLASH_AREA_GET_SECTORS
+    uint32_t count = BOOT_MAX_IMG_SECTORS;
+    int rc;
+
+    rc = flash_area_get_sectors(area_id, &count, boot_prestage_sectors);
+#else
+    int count = BOOT_MAX_IMG_SECTORS;
+    int rc;
+
+    rc = flash_area_to_sectors(area_id, &count, boot_prestage_sectors);
+#endif
+    if (rc != 0 || count <= 0) {
+        return BOOT_EFLASH;
+    }
+
+    *num_sectors = (size_t)count;
+    return 0;
+}
+
+#ifdef MCUBOOT_USE_FLASH_AREA_GET_SECTORS
+static inline uint32_t
+boot_prestage_sector_off(size_t sector)
+{
+    return boot_prestage_sectors[sector].fs_off -
+           boot_prestage_sectors[0].fs_off;
+}
+
+static inline uint32_t
+boot_prestage_sector_size(size_t sector)
+{
+    return boot_prestage_sectors[sector].fs_size;
+}
+#else
+static inline uint32_t
+boot_prestage_sector_off(size_t sector)
+{
+    return boot_prestage_sectors[sector].fa_off -
+           boot_prestage_sectors[0].fa_off;
+}
+
+static inline uint32_t
+boot_prestage_sector_size(size_t sector)
+{
+    return boot_prestage_sectors[sector].fa_size;
+}
+#endif
+
+/*
+ * Reads the header of the image in a slot. With swap using offset, the
+ * image in the secondary slot starts one sector into it when there is one
+ * there; img_off is set to where the image starts.
+ */
+static int
+boot_prestage_read_header(int image_index, int slot, uint32_t *img_off,
+                          struct image_header *hdr)
+{
+    const struct flash_area *fap;
+    int area_id;
+    int rc;
+
+    area_id = flash_area_id_from_multi_image_slot(image_index, slot);
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    *img_off = 0;
+
+#if MCUBOOT_SWAP_USING_OFFSET
+    if (slot == BOOT_SECONDARY_SLOT) {
+        size_t num_sectors;
+
+        rc = boot_prestage_read_sectors(area_id, &num_sectors);
+        if (rc == 0) {
+            rc = flash_area_read(fap, boot_prestage_sector_size(0), hdr,
+                                 sizeof(*hdr));
+        }
+        if (rc != 0) {
+            rc = BOOT_EFLASH;
+            goto done;
+        }
+
+        if (hdr->ih_magic == IMAGE_MAGIC) {
+            *img_off = boot_prestage_sector_size(0);
+        }
+    }
+#endif
+
+    rc = flash_area_read(fap, *img_off, hdr, sizeof(*hdr));
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+
+    if (hdr->ih_magic != IMAGE_MAGIC) {
+        rc = BOOT_EBADIMAGE;
+    }
+
+done:
+    flash_area_close(fap);
+    return rc;
+}
+
+/*
+ * Computes the size of the image of hdr, TLVs included, which fap is a view
+ * of, as boot_read_image_size() does.
+ */
+static int
+boot_prestage_image_size(const struct flash_area *fap,
+                         const struct image_header *hdr, uint32_t *size)
+{
+    struct image_tlv_info info;
+    uint32_t off;
+    uint32_t protect_tlv_size;
+
+    off = BOOT_TLV_OFF(hdr);
+    if (flash_area_read(fap, off, &info, sizeof(info)) != 0) {
+        return BOOT_EFLASH;
+    }
+
+    protect_tlv_size = hdr->ih_protect_tlv_size;
+    if (info.it_magic == IMAGE_TLV_PROT_INFO_MAGIC) {
+        if (protect_tlv_size != info.it_tlv_tot) {
+            return BOOT_EBADIMAGE;
+        }
+
+        if (flash_area_read(fap, off + info.it_tlv_tot, &info,
+                            sizeof(info)) != 0) {
+            return BOOT_EFLASH;
+        }
+    } else if (protect_tlv_size != 0) {
+        return BOOT_EBADIMAGE;
+    }
+
+    if (info.it_magic != IMAGE_TLV_INFO_MAGIC) {
+        return BOOT_EBADIMAGE;
+    }
+
+    *size = off + protect_tlv_size + info.it_tlv_tot;
+    return 0;
+}
+
+/*
+ * Finds the image in a slot: where it starts and where it ends, both from
+ * the start of the slot.
+ */
+static int
+boot_prestage_find_image(int image_index, int slot, uint32_t *img_off,
+                         uint32_t *img_end)
+{
+    const struct flash_area *fap;
+    struct flash_area view;
+    struct image_header hdr;
+    uint32_t size;
+    int rc;
+
+    rc = boot_prestage_read_header(image_index, slot, img_off, &hdr);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_open(flash_area_id_from_multi_image_slot(image_index,
+                                                             slot), &fap);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    view = *fap;
+    view.fa_off += *img_off;
+    view.fa_size -= *img_off;
+
+    if (!boot_u32_safe_add(&size, hdr.ih_img_size, hdr.ih_hdr_size) ||
+        size >= view.fa_size) {
+        rc = BOOT_EBADIMAGE;
+    } else {
+        rc = boot_prestage_image_size(&view, &hdr, &size);
+    }
+
+    if (rc == 0) {
+        if (size > view.fa_size) {
+            rc = BOOT_EBADIMAGE;
+        } else {
+            *img_end = *img_off + size;
+        }
+    }
+
+    flash_area_close(fap);
+    return rc;
+}
+
+/*
+ * The write size used by the boot loader for the trailers of an image, as
+ * boot_write_sz() computes it.
+ */
+static uint32_t
+boot_prestage_write_sz(int image_index)
+{
+    const struct flash_area *fap;
+    uint32_t elem_sz = 0;
+    int area_ids[3];
+    int count = 0;
+    int i;
+
+    area_ids[count++] = FLASH_AREA_IMAGE_PRIMARY(image_index);
+    area_ids[count++] = FLASH_AREA_IMAGE_SECONDARY(image_index);
+#if MCUBOOT_SWAP_USING_SCRATCH
+    area_ids[count++] = FLASH_AREA_IMAGE_SCRATCH;
+#endif
+
+    for (i = 0; i < count; i++) {
+        if (flash_area_open(area_ids[i], &fap) == 0) {
+            if (flash_area_align(fap) > elem_sz) {
+                elem_sz = flash_area_align(fap);
+            }
+            flash_area_close(fap);
+        }
+    }
+
+    return elem_sz;
+}
+
+/*
+ * Erases the whole sectors of a flash area which lie in [start, end).
+ */
+static int
+boot_prestage_erase_range(int area_id, uint32_t start, uint32_t end)
+{
+    const struct flash_area *fap;
+    size_t num_sectors;
+    size_t sector;
+    uint32_t off;
+    uint32_t sz;
+    int rc;
+
+    rc = boot_prestage_read_sectors(area_id, &num_sectors);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    for (sector = 0; sector < num_sectors; sector++) {
+        off = boot_prestage_sector_off(sector);
+        sz = boot_prestage_sector_size(sector);
+        if (off < start || off + sz > end) {
+            continue;
+        }
+
+        rc = flash_area_erase(fap, off, sz);
+        if (rc != 0) {
+            rc = BOOT_EFLASH;
+            break;
+        }
+    }
+
+    flash_area_close(fap);
+    return rc;
+}
+
+/*
+ * Erases the sectors of a slot outside of the image in it, short of the
+ * trailer.
+ */
+static int
+boot_prestage_erase_slot(int image_index, int slot, uint32_t trailer_sz,
+                         uint32_t img_off, uint32_t img_end)
+{
+    const struct flash_area *fap;
+    uint32_t trailer_off;
+    int area_id;
+    int rc;
+
+    area_id = flash_area_id_from_multi_image_slot(image_index, slot);
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+    trailer_off = (trailer_sz < fap->fa_size) ? fap->fa_size - trailer_sz : 0;
+    flash_area_close(fap);
+
+    rc = boot_prestage_erase_range(area_id, 0, img_off);
+    if (rc == 0) {
+        rc = boot_prestage_erase_range(area_id, img_end, trailer_off);
+    }
+
+    return rc;
+}
+
+fih_int
+boot_prestage_validate(int image_index, uint8_t *tmp_buf, uint32_t tmp_buf_sz)
+{
+    const struct flash_area *fap;
+    struct flash_area view;
+    struct image_header hdr;
+    uint32_t img_off;
+    uint32_t size;
+    fih_int fih_rc = FIH_FAILURE;
+    int rc;
+
+    rc = boot_prestage_read_header(image_index, BOOT_SECONDARY_SLOT, &img_off,
+                                   &hdr);
+    if (rc != 0 || (hdr.ih_flags & IMAGE_F_NON_BOOTABLE) ||
+        IS_ENCRYPTED(&hdr)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap);
+    if (rc != 0) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    view = *fap;
+    view.fa_off += img_off;
+    view.fa_size -= img_off;
+
+    if (boot_u32_safe_add(&size, hdr.ih_img_size, hdr.ih_hdr_size) &&
+        size < view.fa_size) {
+        FIH_CALL(bootutil_img_validate, fih_rc, NULL, image_index, &hdr,
+                 &view, tmp_buf, tmp_buf_sz, NULL, 0, NULL);
+    }
+
+    flash_area_close(fap);
+
+    FIH_RET(fih_rc);
+}
+
+int
+boot_prestage_erase(int image_index)
+{
+    uint32_t trailer_sz;
+    uint32_t img_off;
+    uint32_t img_end;
+    int rc;
+
+    trailer_sz = boot_trailer_sz(boot_prestage_write_sz(image_index));
+
+    /* The new image must be there, or its sectors could be taken as free. */
+    rc = boot_prestage_find_image(image_index, BOOT_SECONDARY_SLOT, &img_off,
+                                  &img_end);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = boot_prestage_erase_slot(image_index, BOOT_SECONDARY_SLOT,
+                                  trailer_sz, img_off, img_end);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* Without an image in the primary slot, there is nothing to swap. */
+    rc = boot_prestage_find_image(image_index, BOOT_PRIMARY_SLOT, &img_off,
+                                  &img_end);
+    if (rc == 0) {
+        rc = boot_prestage_erase_slot(image_index, BOOT_PRIMARY_SLOT,
+                                      trailer_sz, img_off, img_end);
+    } else if (rc == BOOT_EBADIMAGE) {
+        rc = 0;
+    }
+
+#if MCUBOOT_SWAP_USING_SCRATCH
+    if (rc == 0) {
+        rc = boot_prestage_erase_range(FLASH_AREA_IMAGE_SCRATCH, 0,
+                                       UINT32_MAX);
+    }
+#endif
+
+    return rc;
+}
+
+int
+boot_prestage(int image_index, int permanent, uint8_t *tmp_buf,
+              uint32_t tmp_buf_sz)
+{
+    struct image_header hdr;
+    uint32_t img_off;
+    fih_int fih_rc = FIH_FAILURE;
+    int swap_type;
+    int rc;
+
+    /* A test image must be confirmed before it can be upgraded. */
+    swap_type = boot_swap_type_multi(image_index);
+    if (swap_type == BOOT_SWAP_TYPE_REVERT ||
+        swap_type == BOOT_SWAP_TYPE_FAIL ||
+        swap_type == BOOT_SWAP_TYPE_PANIC) {
+        return BOOT_EBADSTATUS;
+    }
+
+    rc = boot_prestage_read_header(image_index, BOOT_SECONDARY_SLOT, &img_off,
+                                   &hdr);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* Encrypted images are decrypted by the swap only. */
+    if (!IS_ENCRYPTED(&hdr)) {
+        FIH_CALL(boot_prestage_validate, fih_rc, image_index, tmp_buf,
+                 tmp_buf_sz);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            BOOT_LOG_ERR("Image in the secondary slot is not valid!");
+            return BOOT_EBADIMAGE;
+        }
+    }
+
+    rc = boot_prestage_erase(image_index);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return boot_set_pending_multi(image_index, permanent);
+}
+
+#endif /* !MCUBOOT_DIRECT_XIP && !MCUBOOT_RAM_LOAD */
@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * RAM cache of the NV security counters.
+ *
+ * The stored counters are read once when the boot starts; the image
+ * validation then compares against the cached values and the counter updates
+ * are only staged in RAM. All the staged updates are written back to the NV
+ * storage in a single operation at the end of the boot. Until the cache is
+ * loaded every call goes straight to the platform's NV counter interface.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+
+#include "bootutil/security_cnt.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil_priv.h"
+
+MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#if (BOOT_IMAGE_NUMBER > 32)
+#error "The security counter cache supports at most 32 images."
+#endif
+
+static struct {
+    fih_int value[BOOT_IMAGE_NUMBER];
+    uint32_t pending;   /* Bit i is set if counter i has a staged update. */
+    bool loaded;
+} boot_security_cnt_cache;
+
+fih_int
+boot_security_cnt_cache_init(void)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    uint32_t image_id;
+
+    boot_security_cnt_cache.loaded = false;
+    boot_security_cnt_cache.pending = 0;
+
+    for (image_id = 0; image_id < BOOT_IMAGE_NUMBER; image_id++) {
+        FIH_CALL(boot_nv_security_counter_get, fih_rc, image_id,
+                 &boot_security_cnt_cache.value[image_id]);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(fih_rc);
+        }
+    }
+
+    boot_security_cnt_cache.loaded = true;
+
+    FIH_RET(FIH_SUCCESS);
+}
+
+fih_int
+boot_security_cnt_cache_get(uint32_t image_id, fih_int *security_cnt)
+{
+    fih_int fih_rc = FIH_FAILURE;
+
+    if (!boot_security_cnt_cache.loaded || image_id >= BOOT_IMAGE_NUMBER) {
+        FIH_CALL(boot_nv_security_counter_get, fih_rc, image_id, security_cnt);
+        FIH_RET(fih_rc);
+    }
+
+    *security_cnt = boot_security_cnt_cache.value[image_id];
+
+    FIH_RET(FIH_SUCCESS);
+}
+
+int
+boot_security_cnt_cache_update(uint32_t image_id, uint32_t img_security_cnt)
+{
+    if (!boot_security_cnt_cache.loaded || image_id >= BOOT_IMAGE_NUMBER) {
+        return boot_nv_security_counter_update(image_id, img_security_cnt);
+    }
+
+    if (img_security_cnt >
+        (uint32_t)fih_int_decode(boot_security_cnt_cache.value[image_id])) {
+        boot_security_cnt_cache.value[image_id] =
+            fih_int_encode(img_security_cnt);
+        boot_security_cnt_cache.pending |= 1u << image_id;
+    }
+
+    return 0;
+}
+
+int
+boot_security_cnt_cache_commit(void)
+{
+    uint32_t image_id;
+    int32_t rc = 0;
+#ifdef MCUBOOT_NV_SECURITY_COUNTER_BATCH
+    uint32_t cnt[BOOT_IMAGE_NUMBER];
+#endif
+
+    if (!boot_security_cnt_cache.loaded ||
+        boot_security_cnt_cache.pending == 0) {
+        return 0;
+    }
+
+#ifdef MCUBOOT_NV_SECURITY_COUNTER_BATCH
+    for (image_id = 0; image_id < BOOT_IMAGE_NUMBER; image_id++) {
+        cnt[image_id] =
+            (uint32_t)fih_int_decode(boot_security_cnt_cache.value[image_id]);
+    }
+
+    rc = boot_nv_security_counter_update_batch(cnt, BOOT_IMAGE_NUMBER,
+                                               boot_security_cnt_cache.pending);
+    if (rc == 0) {
+        boot_security_cnt_cache.pending = 0;
+    }
+#else
+    for (image_id = 0; image_id < BOOT_IMAGE_NUMBER; image_id++) {
+        if (!(boot_security_cnt_cache.pending & (1u << image_id))) {
+            continue;
+        }
+
+        rc = boot_nv_security_counter_update(image_id,
+            (uint32_t)fih_int_decode(boot_security_cnt_cache.value[image_id]));
+        if (rc != 0) {
+            break;
+        }
+        boot_security_cnt_cache.pending &= ~(1u << image_id);
+    }
+#endif /* MCUBOOT_NV_SECURITY_COUNTER_BATCH */
+
+    if (rc != 0) {
+        BOOT_LOG_ERR("Failed to commit the security counter updates: %d",
+                     (int)rc);
+    }
+
+    return (int)rc;
+}
+
+#endif /* MCUBOOT_HW_ROLLBACK_PROT */
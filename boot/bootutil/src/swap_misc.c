@@ -30,7 +30,8 @@
 
 MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
 
-#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE)
+#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
+    defined(MCUBOOT_SWAP_USING_OFFSET)
 int
 swap_erase_trailer_sectors(const struct boot_loader_state *state,
                            const struct flash_area *fap)
@@ -79,6 +80,86 @@ swap_erase_trailer_sectors(const struct boot_loader_state *state,
     return rc;
 }
 
+int
+swap_scan_status(const struct flash_area *fap,
+                 struct boot_loader_state *state,
+                 uint32_t first, uint32_t last, uint32_t *end)
+{
+    uint8_t *buf = BOOT_IO_BUF(state);
+#ifdef MCUBOOT_TRAILER_COMPACT
+    uint8_t erased_val;
+#else
+    uint32_t write_sz;
+#endif
+    uint32_t per_read;
+    uint32_t off;
+    uint32_t len;
+    uint32_t i;
+    uint32_t j;
+    uint32_t n;
+    bool written;
+    bool in_run;
+    bool after_run;
+    int rc;
+
+#ifdef MCUBOOT_TRAILER_COMPACT
+    /* One bit per entry; a read may start in the middle of a byte. */
+    erased_val = flash_area_erased_val(fap);
+    per_read = (BOOT_IO_BUF_SZ - 1) * 8;
+#else
+    write_sz = BOOT_WRITE_SZ(state);
+    per_read = BOOT_IO_BUF_SZ / write_sz;
+#endif
+    off = boot_status_off(fap);
+    in_run = false;
+    after_run = false;
+    *end = first;
+
+    for (i = first; i < last; i += n) {
+        n = last - i;
+        if (n > per_read) {
+            n = per_read;
+        }
+
+#ifdef MCUBOOT_TRAILER_COMPACT
+        len = (i + n + 7) / 8 - i / 8;
+        rc = flash_area_read(fap, off + i / 8, buf, len);
+#else
+        len = n * write_sz;
+        rc = flash_area_read(fap, off + i * write_sz, buf, len);
+#endif
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+
+        /* Most of the status area is erased; skip it a chunk at a time. */
+        if (bootutil_buffer_is_erased(fap, buf, len)) {
+            after_run = after_run || in_run;
+            in_run = false;
+            continue;
+        }
+
+        for (j = 0; j < n; j++) {
+#ifdef MCUBOOT_TRAILER_COMPACT
+            written = boot_status_bit_is_set(erased_val, buf, i % 8 + j);
+#else
+            written = !bootutil_buffer_is_erased(fap, &buf[j * write_sz], 1);
+#endif
+            if (!written) {
+                after_run = after_run || in_run;
+                in_run = false;
+            } else if (after_run) {
+                return 1;
+            } else {
+                in_run = true;
+                *end = i + j + 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 int
 swap_status_init(const struct boot_loader_state *state,
                  const struct flash_area *fap,
@@ -182,10 +263,10 @@ swap_read_status(struct boot_loader_state *state, struct boot_status *bs)
 
     return rc;
 }
-#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) */
+#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_OFFSET) */
 
 #if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
-        defined(MCUBOOT_SWAP_USING_STATUS)
+        defined(MCUBOOT_SWAP_USING_OFFSET) || defined(MCUBOOT_SWAP_USING_STATUS)
 
 int
 swap_set_copy_done(uint8_t image_index)
@@ -233,4 +314,4 @@ out:
 }
 
 
-#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_STATUS) */
+#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_OFFSET) || defined(MCUBOOT_SWAP_USING_STATUS) */
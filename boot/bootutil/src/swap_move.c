@@ -119,47 +119,34 @@ int
 swap_read_status_bytes(const struct flash_area *fap,
         struct boot_loader_state *state, struct boot_status *bs)
 {
-    uint32_t off;
-    uint8_t status;
     int max_entries;
-    int found_idx;
-    uint8_t write_sz;
-    int move_entries;
+    uint32_t move_entries;
+    uint32_t move_end;
+    uint32_t swap_end;
     int rc;
-    int last_rc;
-    int erased_sections;
-    int i;
+    int swap_rc;
 
     max_entries = boot_status_entries(BOOT_CURR_IMG(state), fap);
     if (max_entries < 0) {
         return BOOT_EBADARGS;
     }
 
-    erased_sections = 0;
-    found_idx = -1;
-    /* skip erased sectors at the end */
-    last_rc = 1;
-    write_sz = BOOT_WRITE_SZ(state);
-    off = boot_status_off(fap);
-    for (i = max_entries; i > 0; i--) {
-        rc = flash_area_read(fap, off + (i - 1) * write_sz, &status, 1);
-        if (rc < 0) {
-            return BOOT_EFLASH;
-        }
-
-        if (bootutil_buffer_is_erased(fap, &status, 1)) {
-            if (rc != last_rc) {
-                erased_sections++;
-            }
-        } else {
-            if (found_idx == -1) {
-                found_idx = i;
-            }
-        }
-        last_rc = rc;
+    /*
+     * The entries of the move and the swap are written in order, each from
+     * the start of their own part of the status area.
+     */
+    move_entries = BOOT_MAX_IMG_SECTORS * BOOT_STATUS_MOVE_STATE_COUNT;
+    rc = swap_scan_status(fap, state, 0, move_entries, &move_end);
+    if (rc < 0) {
+        return rc;
+    }
+    swap_rc = swap_scan_status(fap, state, move_entries, max_entries,
+                               &swap_end);
+    if (swap_rc < 0) {
+        return swap_rc;
     }
 
-    if (erased_sections > 1) {
+    if (rc == 1 || swap_rc == 1) {
         /* This means there was an error writing status on the last
          * swap. Tell user and move on to validation!
          */
@@ -175,17 +162,19 @@ swap_read_status_bytes(const struct flash_area *fap,
 #endif
     }
 
-    move_entries = BOOT_MAX_IMG_SECTORS * BOOT_STATUS_MOVE_STATE_COUNT;
-    if (found_idx == -1) {
-        /* no swap status found; nothing to do */
-    } else if (found_idx < move_entries) {
-        bs->op = BOOT_STATUS_OP_MOVE;
-        bs->idx = (found_idx  / BOOT_STATUS_MOVE_STATE_COUNT) + BOOT_STATUS_IDX_0;
-        bs->state = (found_idx % BOOT_STATUS_MOVE_STATE_COUNT) + BOOT_STATUS_STATE_0;;
-    } else {
+    if (swap_end > move_entries) {
         bs->op = BOOT_STATUS_OP_SWAP;
-        bs->idx = ((found_idx - move_entries) / BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_IDX_0;
-        bs->state = ((found_idx - move_entries) % BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_STATE_0;
+        bs->idx = ((swap_end - move_entries) / BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_IDX_0;
+        bs->state = ((swap_end - move_entries) % BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_STATE_0;
+    } else if (move_end == move_entries) {
+        /* The move is complete but no sector was swapped yet. */
+        bs->op = BOOT_STATUS_OP_SWAP;
+        bs->idx = BOOT_STATUS_IDX_0;
+        bs->state = BOOT_STATUS_STATE_0;
+    } else if (move_end > 0) {
+        bs->op = BOOT_STATUS_OP_MOVE;
+        bs->idx = (move_end / BOOT_STATUS_MOVE_STATE_COUNT) + BOOT_STATUS_IDX_0;
+        bs->state = (move_end % BOOT_STATUS_MOVE_STATE_COUNT) + BOOT_STATUS_STATE_0;
     }
 
     return 0;
@@ -0,0 +1,588 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Swap using offset: the upgrade image is written one sector into the
+ * secondary slot, so that the first sector of the slot is free. The swap
+ * then copies each sector of the primary slot to the same index in the
+ * secondary slot, which frees the sector of the upgrade image that goes to
+ * that index in the primary slot. Each sector is written once per slot,
+ * instead of twice in the primary slot as with swap using move.
+ *
+ * The swap leaves the previous image at the start of the secondary slot.
+ * A revert therefore swaps the other way round, from the last sector down,
+ * copying each sector of the primary slot one sector up in the secondary
+ * slot before restoring the sector of the previous image in its place.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bootutil/bootutil.h"
+#include "bootutil_priv.h"
+#include "swap_priv.h"
+#include "bootutil/bootutil_log.h"
+
+#include "mcuboot_config/mcuboot_config.h"
+
+MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#ifdef MCUBOOT_SWAP_USING_OFFSET
+
+#if defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
+/*
+ * FIXME: this might have to be updated for threaded sim
+ */
+int boot_status_fails = 0;
+#define BOOT_STATUS_ASSERT(x)                \
+    do {                                     \
+        if (!(x)) {                          \
+            boot_status_fails++;             \
+        }                                    \
+    } while (0)
+#else
+#define BOOT_STATUS_ASSERT(x) ASSERT(x)
+#endif
+
+/*
+ * Number of sectors swapped for images of up to copy_size bytes.
+ */
+static uint32_t
+swap_sector_count(const struct boot_loader_state *state, uint32_t copy_size)
+{
+    uint32_t sector_sz;
+
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+    if (copy_size == 0) {
+        return 1;
+    }
+
+    return (copy_size + sector_sz - 1) / sector_sz;
+}
+
+const struct flash_area *
+boot_img_area_view(struct boot_loader_state *state, int slot,
+                   const struct flash_area *fap)
+{
+    struct flash_area *view;
+    uint32_t off;
+
+    if (slot != BOOT_SECONDARY_SLOT) {
+        return fap;
+    }
+
+    off = state->secondary[BOOT_CURR_IMG(state)].off;
+    if (off == 0) {
+        return fap;
+    }
+
+    view = &state->secondary[BOOT_CURR_IMG(state)].area;
+    *view = *fap;
+    view->fa_off += off;
+    view->fa_size -= off;
+
+    return view;
+}
+
+int
+boot_read_image_header(struct boot_loader_state *state, int slot,
+                       struct image_header *out_hdr, struct boot_status *bs)
+{
+    const struct flash_area *fap;
+    uint32_t swap_size;
+    uint32_t last_idx;
+    uint32_t off;
+    uint32_t sz;
+    bool detect;
+    int area_id;
+    int rc;
+
+    off = 0;
+    sz = boot_img_sector_size(state, BOOT_SECONDARY_SLOT, 0);
+    detect = (slot == BOOT_SECONDARY_SLOT);
+
+    if (bs != NULL && !boot_status_is_reset(bs)) {
+        rc = boot_read_swap_size(BOOT_CURR_IMG(state), &swap_size);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+        last_idx = swap_sector_count(state, swap_size);
+
+        /*
+         * While a swap is under way, return the headers of the images as
+         * they were before it, wherever they are now. Once it is finished
+         * the images are where they belong.
+         */
+        if (bs->idx <= last_idx) {
+            detect = false;
+            if (bs->swap_type == BOOT_SWAP_TYPE_REVERT) {
+                /* Sector 0 is swapped last; the image of the primary slot
+                 * has its header one sector into the secondary slot once
+                 * sector 0 was copied there.
+                 */
+                if (slot == BOOT_PRIMARY_SLOT && bs->idx == last_idx &&
+                        bs->state == BOOT_STATUS_STATE_1) {
+                    slot = BOOT_SECONDARY_SLOT;
+                    off = sz;
+                }
+            } else if (bs->idx == BOOT_STATUS_IDX_0) {
+                /* Once sector 0 of the primary slot was copied to the
+                 * secondary slot, it may already be erased.
+                 */
+                if (slot == BOOT_SECONDARY_SLOT) {
+                    off = sz;
+                } else if (bs->state == BOOT_STATUS_STATE_1) {
+                    slot = BOOT_SECONDARY_SLOT;
+                }
+            } else {
+                slot = (slot == BOOT_PRIMARY_SLOT) ?
+                       BOOT_SECONDARY_SLOT : BOOT_PRIMARY_SLOT;
+            }
+        }
+    }
+
+    area_id = flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state), slot);
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+
+    if (detect) {
+        /*
+         * An upgrade image starts one sector into the secondary slot, the
+         * image left by a swap at its start.
+         */
+        rc = flash_area_read(fap, sz, out_hdr, sizeof *out_hdr);
+        if (rc != 0) {
+            rc = BOOT_EFLASH;
+            goto done;
+        }
+
+        if (out_hdr->ih_magic == IMAGE_MAGIC) {
+            off = sz;
+        }
+        state->secondary[BOOT_CURR_IMG(state)].off = off;
+    }
+
+    rc = flash_area_read(fap, off, out_hdr, sizeof *out_hdr);
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+
+    /* We only know where the headers are located when bs is valid */
+    if (bs != NULL && out_hdr->ih_magic != IMAGE_MAGIC) {
+        rc = -1;
+        goto done;
+    }
+
+    rc = 0;
+
+done:
+    flash_area_close(fap);
+    return rc;
+}
+
+int
+swap_read_status_bytes(const struct flash_area *fap,
+        struct boot_loader_state *state, struct boot_status *bs)
+{
+    int max_entries;
+    uint32_t end;
+    int rc;
+
+    max_entries = boot_status_entries(BOOT_CURR_IMG(state), fap);
+    if (max_entries < 0) {
+        return BOOT_EBADARGS;
+    }
+
+    rc = swap_scan_status(fap, state, 0, max_entries, &end);
+    if (rc < 0) {
+        return rc;
+    }
+
+    if (rc == 1) {
+        /* This means there was an error writing status on the last
+         * swap. Tell user and move on to validation!
+         */
+#if !defined(__BOOTSIM__)
+        BOOT_LOG_ERR("Detected inconsistent status!");
+#endif
+
+#if !defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
+        /* With validation of the primary slot disabled, there is no way
+         * to be sure the swapped primary slot is OK, so abort!
+         */
+        assert(0);
+#endif
+    }
+
+    if (end > 0) {
+        bs->op = BOOT_STATUS_OP_SWAP;
+        bs->idx = (end / BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_IDX_0;
+        bs->state = (end % BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_STATE_0;
+    }
+
+    return 0;
+}
+
+uint32_t
+boot_status_internal_off(const struct boot_status *bs, int elem_sz)
+{
+    return (bs->idx - BOOT_STATUS_IDX_0) * BOOT_STATUS_SWAP_STATE_COUNT *
+               elem_sz +
+           (bs->state - BOOT_STATUS_STATE_0) * elem_sz;
+}
+
+int
+boot_slots_compatible(struct boot_loader_state *state)
+{
+    size_t num_sectors_pri;
+    size_t num_sectors_sec;
+    size_t sector_sz;
+    size_t i;
+
+    num_sectors_pri = boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+    num_sectors_sec = boot_img_num_sectors(state, BOOT_SECONDARY_SLOT);
+    if ((num_sectors_sec != num_sectors_pri) &&
+            (num_sectors_sec != (num_sectors_pri + 1))) {
+        BOOT_LOG_WRN("Cannot upgrade: not a compatible amount of sectors");
+        return 0;
+    }
+
+    if (num_sectors_sec > BOOT_MAX_IMG_SECTORS) {
+        BOOT_LOG_WRN("Cannot upgrade: more sectors than allowed");
+        return 0;
+    }
+
+    /* Sector i of the primary slot pairs up with sectors i and i + 1 of the
+     * secondary slot, so all of them must be the same size.
+     */
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+    for (i = 0; i < num_sectors_sec; i++) {
+        if ((i < num_sectors_pri &&
+             boot_img_sector_size(state, BOOT_PRIMARY_SLOT, i) != sector_sz) ||
+            boot_img_sector_size(state, BOOT_SECONDARY_SLOT, i) != sector_sz) {
+            BOOT_LOG_WRN("Cannot upgrade: not same sector layout");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#define BOOT_LOG_SWAP_STATE(area, state)                            \
+    BOOT_LOG_INF("%s: magic=%s, swap_type=0x%x, copy_done=0x%x, "   \
+                 "image_ok=0x%x",                                   \
+                 (area),                                            \
+                 ((state)->magic == BOOT_MAGIC_GOOD ? "good" :      \
+                  (state)->magic == BOOT_MAGIC_UNSET ? "unset" :    \
+                  "bad"),                                           \
+                 (state)->swap_type,                                \
+                 (state)->copy_done,                                \
+                 (state)->image_ok)
+
+int
+swap_status_source(struct boot_loader_state *state)
+{
+    struct boot_swap_state state_primary_slot;
+    struct boot_swap_state state_secondary_slot;
+    int rc;
+    uint8_t image_index;
+
+#if (BOOT_IMAGE_NUMBER == 1)
+    (void)state;
+#endif
+
+    image_index = BOOT_CURR_IMG(state);
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_PRIMARY(image_index),
+            &state_primary_slot);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Primary image", &state_primary_slot);
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
+            &state_secondary_slot);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Secondary image", &state_secondary_slot);
+
+    if (state_primary_slot.magic == BOOT_MAGIC_GOOD &&
+            state_primary_slot.copy_done == BOOT_FLAG_UNSET &&
+            state_secondary_slot.magic != BOOT_MAGIC_GOOD) {
+
+        BOOT_LOG_INF("Boot source: primary slot");
+        return BOOT_STATUS_SOURCE_PRIMARY_SLOT;
+    }
+
+    BOOT_LOG_INF("Boot source: none");
+    return BOOT_STATUS_SOURCE_NONE;
+}
+
+/*
+ * Swaps sector idx of the primary slot with the sector after it in the
+ * secondary slot, for an upgrade.
+ */
+static void
+boot_swap_sectors(uint32_t idx, uint32_t sz, struct boot_loader_state *state,
+        struct boot_status *bs, const struct flash_area *fap_pri,
+        const struct flash_area *fap_sec)
+{
+    uint32_t pri_off;
+    uint32_t sec_off;
+    uint32_t sec_up_off;
+    int rc;
+
+    pri_off = boot_img_sector_off(state, BOOT_PRIMARY_SLOT, idx);
+    sec_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx);
+    sec_up_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx + 1);
+
+    if (bs->state == BOOT_STATUS_STATE_0) {
+        /* The sector of the upgrade image here was already swapped. */
+        rc = boot_erase_region(fap_sec, sec_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_pri, fap_sec, pri_off, sec_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->state = BOOT_STATUS_STATE_1;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+
+    if (bs->state == BOOT_STATUS_STATE_1) {
+        rc = boot_erase_region(fap_pri, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_sec, fap_pri, sec_up_off, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->idx++;
+        bs->state = BOOT_STATUS_STATE_0;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+}
+
+/*
+ * Swaps sector idx of the primary slot with the same sector of the
+ * secondary slot, for a revert.
+ */
+static void
+boot_swap_sectors_revert(uint32_t idx, uint32_t sz,
+        struct boot_loader_state *state, struct boot_status *bs,
+        const struct flash_area *fap_pri, const struct flash_area *fap_sec)
+{
+    uint32_t pri_off;
+    uint32_t sec_off;
+    uint32_t sec_up_off;
+    int rc;
+
+    pri_off = boot_img_sector_off(state, BOOT_PRIMARY_SLOT, idx);
+    sec_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx);
+    sec_up_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx + 1);
+
+    if (bs->state == BOOT_STATUS_STATE_0) {
+        /* The sector of the previous image here was already swapped. */
+        rc = boot_erase_region(fap_sec, sec_up_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_pri, fap_sec, pri_off, sec_up_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->state = BOOT_STATUS_STATE_1;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+
+    if (bs->state == BOOT_STATUS_STATE_1) {
+        rc = boot_erase_region(fap_pri, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_sec, fap_pri, sec_off, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->idx++;
+        bs->state = BOOT_STATUS_STATE_0;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+}
+
+/*
+ * When starting a revert the swap status exists in the primary slot, and
+ * the status in the secondary slot is erased. To start the swap, the status
+ * area in the primary slot must be re-initialized; if during the small
+ * window of time between re-initializing it and writing the first metadata
+ * a reset happens, the swap process is broken and cannot be resumed.
+ *
+ * This function handles the issue by making the revert look like a permanent
+ * upgrade (by initializing the secondary slot).
+ */
+static void
+fixup_revert(const struct boot_loader_state *state, struct boot_status *bs,
+        const struct flash_area *fap_sec, uint8_t sec_id)
+{
+    struct boot_swap_state swap_state;
+    int rc;
+
+#if (BOOT_IMAGE_NUMBER == 1)
+    (void)state;
+#endif
+
+    /* No fixup required */
+    if (bs->swap_type != BOOT_SWAP_TYPE_REVERT ||
+        bs->idx != BOOT_STATUS_IDX_0 ||
+        bs->state != BOOT_STATUS_STATE_0) {
+        return;
+    }
+
+    rc = boot_read_swap_state_by_id(sec_id, &swap_state);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Secondary image", &swap_state);
+
+    if (swap_state.magic == BOOT_MAGIC_UNSET) {
+        rc = swap_erase_trailer_sectors(state, fap_sec);
+        assert(rc == 0);
+
+        rc = boot_write_image_ok(fap_sec);
+        assert(rc == 0);
+
+        rc = boot_write_swap_size(fap_sec, bs->swap_size);
+        assert(rc == 0);
+
+        rc = boot_write_magic(fap_sec);
+        assert(rc == 0);
+    }
+}
+
+void
+swap_run(struct boot_loader_state *state, struct boot_status *bs,
+         uint32_t copy_size)
+{
+    uint32_t sector_sz;
+    uint32_t trailer_sz;
+    uint32_t trailer_sectors;
+    uint32_t last_idx;
+    uint32_t step;
+    uint32_t idx;
+    uint8_t image_index;
+    const struct flash_area *fap_pri;
+    const struct flash_area *fap_sec;
+    int rc;
+
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+    last_idx = swap_sector_count(state, copy_size);
+
+    /*
+     * When starting a new swap upgrade, check that there is enough space:
+     * the swapped sectors must stay clear of the trailers, in the secondary
+     * slot including the sector after them.
+     */
+    if (boot_status_is_reset(bs)) {
+        trailer_sz = boot_trailer_sz(BOOT_WRITE_SZ(state));
+        trailer_sectors = (trailer_sz + sector_sz - 1) / sector_sz;
+
+        if (last_idx + trailer_sectors >
+                boot_img_num_sectors(state, BOOT_PRIMARY_SLOT) ||
+            last_idx + 1 + trailer_sectors >
+                boot_img_num_sectors(state, BOOT_SECONDARY_SLOT)) {
+            BOOT_LOG_WRN("Not enough free space to run swap upgrade");
+            bs->swap_type = BOOT_SWAP_TYPE_NONE;
+            return;
+        }
+
+        /*
+         * An image at the start of the secondary slot is swapped the way of
+         * a revert. Besides a revert, this is a permanent upgrade which
+         * fixup_revert() left behind when a reset happened before the swap
+         * status was written; it is recorded as a revert, which completes
+         * the same way, so that a resumed swap keeps going the same way.
+         */
+        if (state->secondary[BOOT_CURR_IMG(state)].off == 0 &&
+                bs->swap_type != BOOT_SWAP_TYPE_REVERT) {
+            if (bs->swap_type != BOOT_SWAP_TYPE_PERM) {
+                BOOT_LOG_WRN("Cannot upgrade: image not at the slot offset");
+                bs->swap_type = BOOT_SWAP_TYPE_NONE;
+                return;
+            }
+            bs->swap_type = BOOT_SWAP_TYPE_REVERT;
+        }
+    }
+
+    image_index = BOOT_CURR_IMG(state);
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_index), &fap_pri);
+    assert (rc == 0);
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap_sec);
+    assert (rc == 0);
+
+    fixup_revert(state, bs, fap_sec, FLASH_AREA_IMAGE_SECONDARY(image_index));
+
+    if (bs->idx == BOOT_STATUS_IDX_0 && bs->state == BOOT_STATUS_STATE_0) {
+        if (bs->source != BOOT_STATUS_SOURCE_PRIMARY_SLOT) {
+            rc = swap_erase_trailer_sectors(state, fap_pri);
+            assert(rc == 0);
+
+            rc = swap_status_init(state, fap_pri, bs);
+            assert(rc == 0);
+        }
+
+        rc = swap_erase_trailer_sectors(state, fap_sec);
+        assert(rc == 0);
+    }
+
+    bs->op = BOOT_STATUS_OP_SWAP;
+
+    if (bs->swap_type == BOOT_SWAP_TYPE_REVERT) {
+        idx = last_idx;
+        for (step = BOOT_STATUS_IDX_0; idx > 0; step++) {
+            idx--;
+            if (step >= bs->idx) {
+                boot_swap_sectors_revert(idx, sector_sz, state, bs, fap_pri,
+                                         fap_sec);
+            }
+        }
+    } else {
+        for (idx = 0; idx < last_idx; idx++) {
+            if (idx + BOOT_STATUS_IDX_0 >= bs->idx) {
+                boot_swap_sectors(idx, sector_sz, state, bs, fap_pri, fap_sec);
+            }
+        }
+
+        if (last_idx == 1) {
+            /* With a single sector swapped, the header of the upgrade image
+             * is still in place one sector into the secondary slot; erase
+             * it so that it isn't taken for another upgrade image.
+             */
+            rc = boot_erase_region(fap_sec,
+                    boot_img_sector_off(state, BOOT_SECONDARY_SLOT, 1),
+                    sector_sz);
+            assert(rc == 0);
+        }
+    }
+
+    flash_area_close(fap_pri);
+    flash_area_close(fap_sec);
+}
+
+#endif
@@ -22,7 +22,7 @@
 #include "mcuboot_config/mcuboot_config.h"
 
 #if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
-    defined(MCUBOOT_SWAP_USING_STATUS)
+    defined(MCUBOOT_SWAP_USING_OFFSET) || defined(MCUBOOT_SWAP_USING_STATUS)
 
 /**
  * Calculates the amount of space required to store the trailer, and erases
@@ -67,6 +67,18 @@ int swap_read_status_bytes(const struct flash_area *fap,
                            struct boot_loader_state *state,
                            struct boot_status *bs);
 
+/**
+ * Finds the written status entries among the entries [first, last) of the
+ * given flash_area, reading them in large chunks through the I/O buffer.
+ * Entries are written in order, so the written ones form a single run, and
+ * end is set to the index after it, or to first if there is none. Returns 1
+ * if an entry after the run is written too, which means a status write was
+ * lost, BOOT_EFLASH if reading fails and 0 otherwise.
+ */
+int swap_scan_status(const struct flash_area *fap,
+                     struct boot_loader_state *state,
+                     uint32_t first, uint32_t last, uint32_t *end);
+
 /**
  * Marks the image in the primary slot as fully copied.
  */
@@ -100,6 +112,6 @@ static inline size_t boot_scratch_area_size(const struct boot_loader_state *stat
 }
 #endif
 
-#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) */
+#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_OFFSET) */
 
 #endif /* H_SWAP_PRIV_ */
@@ -30,7 +30,8 @@
 
 MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
 
-#if (!defined(MCUBOOT_SWAP_USING_MOVE) && !defined(MCUBOOT_SWAP_USING_STATUS))
+#if (!defined(MCUBOOT_SWAP_USING_MOVE) && !defined(MCUBOOT_SWAP_USING_OFFSET) && \
+     !defined(MCUBOOT_SWAP_USING_STATUS))
 
 #if defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
 /*
@@ -82,6 +83,7 @@ done:
 }
 
 #if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
+#ifndef MCUBOOT_OVERWRITE_ONLY
 /**
  * Reads the status of a partially-completed swap, if any.  This is necessary
  * to recover in case the boot lodaer was reset in the middle of a swap
@@ -91,44 +93,21 @@ int
 swap_read_status_bytes(const struct flash_area *fap,
         struct boot_loader_state *state, struct boot_status *bs)
 {
-    uint32_t off;
-    uint8_t status;
     int max_entries;
-    int found;
-    int found_idx;
-    int invalid;
+    uint32_t found_idx;
     int rc;
-    int i;
 
-    off = boot_status_off(fap);
     max_entries = boot_status_entries(BOOT_CURR_IMG(state), fap);
     if (max_entries < 0) {
         return BOOT_EBADARGS;
     }
 
-    found = 0;
-    found_idx = 0;
-    invalid = 0;
-    for (i = 0; i < max_entries; i++) {
-        rc = flash_area_read(fap, off + i * BOOT_WRITE_SZ(state),
-                &status, 1);
-        if (rc < 0) {
-            return BOOT_EFLASH;
-        }
-
-        if (bootutil_buffer_is_erased(fap, &status, 1)) {
-            if (found && !found_idx) {
-                found_idx = i;
-            }
-        } else if (!found) {
-            found = 1;
-        } else if (found_idx) {
-            invalid = 1;
-            break;
-        }
+    rc = swap_scan_status(fap, state, 0, max_entries, &found_idx);
+    if (rc < 0) {
+        return rc;
     }
 
-    if (invalid) {
+    if (rc == 1) {
         /* This means there was an error writing status on the last
          * swap. Tell user and move on to validation!
          */
@@ -144,16 +123,14 @@ swap_read_status_bytes(const struct flash_area *fap,
 #endif
     }
 
-    if (found) {
-        if (!found_idx) {
-            found_idx = i;
-        }
+    if (found_idx > 0) {
         bs->idx = (found_idx / BOOT_STATUS_STATE_COUNT) + 1;
         bs->state = (found_idx % BOOT_STATUS_STATE_COUNT) + 1;
     }
 
     return 0;
 }
+#endif /* !MCUBOOT_OVERWRITE_ONLY */
 
 uint32_t
 boot_status_internal_off(const struct boot_status *bs, int elem_sz)
@@ -609,7 +586,8 @@ boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
             /* copy current status that is being maintained in scratch */
             rc = boot_copy_region(state, fap_scratch, fap_primary_slot,
                         scratch_trailer_off, img_off + copy_sz,
-                        (BOOT_STATUS_STATE_COUNT - 1) * BOOT_WRITE_SZ(state));
+                        BOOT_STATUS_ENTRIES_SZ(BOOT_STATUS_STATE_COUNT - 1,
+                                               BOOT_WRITE_SZ(state)));
             BOOT_STATUS_ASSERT(rc == 0);
 
             rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SCRATCH,
@@ -725,4 +703,4 @@ swap_run(struct boot_loader_state *state, struct boot_status *bs,
 
 #endif /* !MCUBOOT_DIRECT_XIP && !MCUBOOT_RAM_LOAD */
 
-#endif /* !MCUBOOT_SWAP_USING_MOVE */
+#endif /* !MCUBOOT_SWAP_USING_MOVE && !MCUBOOT_SWAP_USING_OFFSET */
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Boot state in retained RAM.
+ *
+ * At handoff the boot loader records the headers of the primary images, the
+ * trailers of their slots and its response in a retained block, with a MAC
+ * and a CRC. After a warm reset, if the flash generation is the one
+ * recorded, the trailers call for no swap and the MAC matches, the boot
+ * returns the recorded response: the slots are neither read nor validated
+ * again, as nothing in them changed since they were. Any other block is
+ * cleared, and the boot goes the normal way.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_WARM_BOOT
+
+#include "bootutil/warm_boot.h"
+#include "bootutil/crypto/hmac_sha256.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil_priv.h"
+#include "crc32c.h"
+
+MCUBOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#if (BOOT_IMAGE_NUMBER != BOOT_WARM_IMAGES)
+#error "BOOT_WARM_IMAGES must match BOOT_IMAGE_NUMBER."
+#endif
+
+/**
+ * Computes the MAC of a boot state.
+ *
+ * @returns 0 on success, != 0 if there is no key.
+ */
+static int
+boot_warm_mac(const struct boot_warm_state *ws, uint8_t *mac)
+{
+    bootutil_hmac_sha256_context hmac;
+    const uint8_t *key;
+    uint32_t key_len = 0;
+    int rc;
+
+    key = boot_warm_key(&key_len);
+
+    bootutil_hmac_sha256_init(&hmac);
+    rc = bootutil_hmac_sha256_set_key(&hmac, key, key_len);
+    if (rc != 0) {
+        goto out;
+    }
+
+    rc = bootutil_hmac_sha256_update(&hmac, ws,
+                                     offsetof(struct boot_warm_state, mac));
+    if (rc != 0) {
+        goto out;
+    }
+
+    rc = bootutil_hmac_sha256_finish(&hmac, mac, BOOT_WARM_MAC_SZ);
+
+out:
+    bootutil_hmac_sha256_drop(&hmac);
+    return rc;
+}
+
+static uint32_t
+boot_warm_crc(const struct boot_warm_state *ws)
+{
+    return crc32c_checksum((const uint8_t *)ws,
+                           offsetof(struct boot_warm_state, crc));
+}
+
+static void
+boot_warm_to_swap_state(const struct boot_warm_trailer *trailer,
+                        struct boot_swap_state *swap_state)
+{
+    swap_state->magic = trailer->magic;
+    swap_state->swap_type = trailer->swap_type;
+    swap_state->copy_done = trailer->copy_done;
+    swap_state->image_ok = trailer->image_ok;
+    swap_state->image_num = 0;
+}
+
+fih_int
+boot_warm_load(struct boot_loader_state *state, struct boot_rsp *rsp)
+{
+    struct boot_warm_state *ws;
+    struct boot_warm_image *image;
+    struct boot_swap_state primary_slot;
+    struct boot_swap_state secondary_slot;
+    uint8_t mac[BOOT_WARM_MAC_SZ];
+    fih_int fih_rc = FIH_FAILURE;
+    int image_index;
+
+    ws = boot_warm_retained_state();
+    if (ws == NULL) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    /* The cheap checks first: after a power-up the block holds garbage. */
+    if (!boot_warm_reset() ||
+        ws->crc != boot_warm_crc(ws) ||
+        ws->magic != BOOT_WARM_MAGIC ||
+        ws->generation != boot_warm_flash_generation() ||
+        boot_warm_mac(ws, mac) != 0) {
+        goto out;
+    }
+
+    FIH_CALL(boot_fih_memequal, fih_rc, mac, ws->mac, sizeof(mac));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        goto out;
+    }
+
+    for (image_index = 0; image_index < BOOT_IMAGE_NUMBER; image_index++) {
+        image = &ws->images[image_index];
+
+        /* A test image which was not confirmed is reverted by a reset. */
+        boot_warm_to_swap_state(&image->trailer[BOOT_PRIMARY_SLOT],
+                                &primary_slot);
+        boot_warm_to_swap_state(&image->trailer[BOOT_SECONDARY_SLOT],
+                                &secondary_slot);
+        if (boot_swap_type_from_states(&primary_slot, &secondary_slot) !=
+                BOOT_SWAP_TYPE_NONE) {
+            fih_rc = FIH_FAILURE;
+            goto out;
+        }
+
+        memcpy(&state->imgs[image_index][BOOT_PRIMARY_SLOT].hdr, &image->hdr,
+               sizeof(struct image_header));
+    }
+
+    rsp->br_flash_dev_id = ws->flash_dev_id;
+    rsp->br_image_off = ws->image_off;
+    rsp->br_hdr = &state->imgs[0][BOOT_PRIMARY_SLOT].hdr;
+
+    BOOT_LOG_INF("Warm reset: booting the image of the previous boot");
+
+out:
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        memset(ws, 0, sizeof(*ws));
+    }
+
+    FIH_RET(fih_rc);
+}
+
+void
+boot_warm_save(struct boot_loader_state *state, const struct boot_rsp *rsp)
+{
+    struct boot_warm_state *ws;
+    struct boot_warm_trailer *trailer;
+    struct boot_swap_state swap_state;
+    int image_index;
+    int slot;
+    int rc;
+
+    ws = boot_warm_retained_state();
+    if (ws == NULL) {
+        return;
+    }
+
+    memset(ws, 0, sizeof(*ws));
+
+    for (image_index = 0; image_index < BOOT_IMAGE_NUMBER; image_index++) {
+        memcpy(&ws->images[image_index].hdr,
+               &state->imgs[image_index][BOOT_PRIMARY_SLOT].hdr,
+               sizeof(struct image_header));
+
+        for (slot = 0; slot < BOOT_NUM_SLOTS; slot++) {
+            rc = boot_read_swap_state(state->imgs[image_index][slot].area,
+                                      &swap_state);
+            if (rc != 0) {
+                goto fail;
+            }
+
+            trailer = &ws->images[image_index].trailer[slot];
+            trailer->magic = swap_state.magic;
+            trailer->swap_type = swap_state.swap_type;
+            trailer->copy_done = swap_state.copy_done;
+            trailer->image_ok = swap_state.image_ok;
+        }
+    }
+
+    ws->magic = BOOT_WARM_MAGIC;
+    ws->generation = boot_warm_flash_generation();
+    ws->image_off = rsp->br_image_off;
+    ws->flash_dev_id = rsp->br_flash_dev_id;
+
+    rc = boot_warm_mac(ws, ws->mac);
+    if (rc != 0) {
+        goto fail;
+    }
+
+    ws->crc = boot_warm_crc(ws);
+    return;
+
+fail:
+    BOOT_LOG_WRN("Failed to record the boot state for a warm reset");
+    memset(ws, 0, sizeof(*ws));
+}
+
+#endif /* MCUBOOT_WARM_BOOT */
@@ -58,6 +58,14 @@ endif
 
 ifeq ($(USE_EXTERNAL_FLASH), 1)
 DEFINES_APP += -DCY_BOOT_USE_EXTERNAL_FLASH
+# Internal flash row which keeps the SFDP parameters of the external memory
+# between boots. No row is free by default: the work flash belongs to the
+# em_eeprom region of the linker scripts. Left empty, the SFDP discovery runs
+# on every boot.
+SFDP_CACHE_ADDR ?=
+ifneq ($(SFDP_CACHE_ADDR),)
+DEFINES_APP += -DCY_BOOT_SFDP_CACHE_ADDR=$(SFDP_CACHE_ADDR)
+endif
 ifeq ($(USE_OVERWRITE), 1)
 # slot size w External Memory is 0xC0000, so 1536 sectors
 MAX_IMG_SECTORS = 1536
@@ -147,4 +147,9 @@
         /* TODO: to be implemented */   \
     } while (0)
 
+/* Kicks the WDT from the copy, hash and erase loops once half of its timeout
+ * has passed, if it was started with cy_wdg_init(). */
+#include "watchdog.h"
+#define MCUBOOT_WATCHDOG_POLL()         cy_wdg_poll()
+
 #endif /* MCUBOOT_CONFIG_H */
@@ -42,3 +42,18 @@ boot_nv_security_counter_update(uint32_t image_id, uint32_t img_security_cnt)
     /* Do nothing. */
     return 0;
 }
+
+#ifdef MCUBOOT_NV_SECURITY_COUNTER_BATCH
+int32_t
+boot_nv_security_counter_update_batch(const uint32_t *img_security_cnt,
+                                      uint32_t image_cnt,
+                                      uint32_t update_mask)
+{
+    (void)img_security_cnt;
+    (void)image_cnt;
+    (void)update_mask;
+
+    /* Do nothing: all the counters would be programmed in one pass. */
+    return 0;
+}
+#endif
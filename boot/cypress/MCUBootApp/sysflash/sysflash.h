@@ -13,6 +13,17 @@
 #define FLASH_AREA_IMAGE_3 6
 #define FLASH_AREA_IMAGE_SWAP_STATUS 7
 
+/*
+ * Slots 2 and up of image 0, if MCUBOOT_NUM_SLOTS configures more than two
+ * slots per image (direct-xip and ram-load modes only). Their flash area
+ * descriptors are supplied by the platform with CY_FLASH_MAP_EXT_DESC.
+ */
+#if defined(MCUBOOT_NUM_SLOTS) && (MCUBOOT_NUM_SLOTS > 2)
+#define FLASH_AREA_IMAGE_ADDITIONAL_BASE 8
+#define FLASH_AREA_IMAGE_ADDITIONAL(slot) \
+                                (FLASH_AREA_IMAGE_ADDITIONAL_BASE + (slot) - 2)
+#endif
+
 /* Uncomment if external flash is being used */
 /* #define CY_BOOT_USE_EXTERNAL_FLASH */
 
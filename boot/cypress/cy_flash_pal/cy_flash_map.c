@@ -476,6 +476,12 @@ int     flash_area_to_sectors(int idx, int *cnt, struct flash_area *fa)
  */
 int flash_area_id_from_multi_image_slot(int image_index, int slot)
 {
+#if defined(MCUBOOT_NUM_SLOTS) && (MCUBOOT_NUM_SLOTS > 2)
+    if (image_index == 0 && slot >= 2 && slot < MCUBOOT_NUM_SLOTS) {
+        return FLASH_AREA_IMAGE_ADDITIONAL(slot);
+    }
+#endif
+
     switch (slot) {
     case 0: return FLASH_AREA_IMAGE_PRIMARY(image_index);
     case 1: return FLASH_AREA_IMAGE_SECONDARY(image_index);
@@ -498,6 +504,13 @@ int flash_area_id_to_multi_image_slot(int image_index, int area_id)
     if (area_id == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
         return 1;
     }
+#if defined(MCUBOOT_NUM_SLOTS) && (MCUBOOT_NUM_SLOTS > 2)
+    if (image_index == 0 &&
+        area_id >= FLASH_AREA_IMAGE_ADDITIONAL(2) &&
+        area_id < FLASH_AREA_IMAGE_ADDITIONAL(MCUBOOT_NUM_SLOTS)) {
+        return area_id - FLASH_AREA_IMAGE_ADDITIONAL_BASE + 2;
+    }
+#endif
 
     return -1;
 }
@@ -113,29 +113,77 @@ int psoc6_smif_write(const struct flash_area *fap,
     return rc;
 }
 
+/*
+ * Erases the blocks covering [addr, addr + size) with as few commands as
+ * possible. Each step uses the largest erase type which is aligned at the
+ * current address and fits in what is left, so the smaller blocks are only
+ * used at the edges, and a range covering the whole memory uses the chip
+ * erase. The range is rounded out to the smallest erase type.
+ *
+ * There is no power-safe way to erase flash partially, which is why the
+ * upgrade slots have to be at least an erase block far from each other.
+ */
 int psoc6_smif_erase(off_t addr, size_t size)
 {
     int rc = -1;
-    cy_en_smif_status_t st;
-    uint32_t address;
-
-    /* It is erase sector-only
-     *
-     * There is no power-safe way to erase flash partially
-     * this leads upgrade slots have to be at least
-     * eraseSectorSize far from each other;
-     */
+    cy_en_smif_status_t st = CY_SMIF_SUCCESS;
     cy_stc_smif_mem_config_t *memCfg = qspi_get_memory_config(0);
+    const struct qspi_erase_type *types;
+    cy_stc_smif_mem_config_t cfg;
+    cy_stc_smif_mem_device_cfg_t dev;
+    cy_stc_smif_mem_cmd_t cmd;
+    uint32_t count;
+    uint32_t min;
+    uint32_t address;
+    uint32_t end;
+    uint32_t i;
 
-    address = (addr - CY_SMIF_BASE_MEM_OFFSET ) & ~((uint32_t)(memCfg->deviceCfg->eraseSize - 1u));
+    count = qspi_get_erase_types(&types);
+    if (count == 0u) {
+        return rc;
+    }
 
-    (void)size;
+    min = types[count - 1u].size;
+    address = (uint32_t)(addr - CY_SMIF_BASE_MEM_OFFSET);
+    end = (address + size + min - 1u) & ~(min - 1u);
+    address &= ~(min - 1u);
 
-    st = Cy_SMIF_MemEraseSector(qspi_get_device(),
+    if (address == 0u && end >= memCfg->deviceCfg->memSize) {
+        st = Cy_SMIF_MemEraseChip(qspi_get_device(),
                                     memCfg,
-                                    address,
-                                    memCfg->deviceCfg->eraseSize,
                                     qspi_get_context());
+    } else {
+        /*
+         * The PDL erases with the command of the device configuration, so a
+         * copy of it is pointed at the erase type of each step.
+         */
+        cfg = *memCfg;
+        dev = *memCfg->deviceCfg;
+        cmd = *dev.eraseCmd;
+        cfg.deviceCfg = &dev;
+        dev.eraseCmd = &cmd;
+
+        while (address < end && st == CY_SMIF_SUCCESS) {
+            for (i = 0; i < count - 1u; i++) {
+                if ((address & (types[i].size - 1u)) == 0u &&
+                    end - address >= types[i].size) {
+                    break;
+                }
+            }
+
+            cmd.command = types[i].cmd;
+            dev.eraseSize = types[i].size;
+            dev.eraseTime = types[i].time;
+
+            st = Cy_SMIF_MemEraseSector(qspi_get_device(),
+                                            &cfg,
+                                            address,
+                                            types[i].size,
+                                            qspi_get_context());
+            address += types[i].size;
+        }
+    }
+
     if (st == CY_SMIF_SUCCESS) {
         rc = 0;
     }
@@ -64,7 +64,10 @@
 *
 ******************************************************************************/
 #include "cy_pdl.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 #include "flash_qspi.h"
 
 #define CY_SMIF_SYSCLK_HFCLK_DIVIDER     CY_SYSCLK_CLKHF_DIVIDE_BY_4
@@ -408,6 +411,412 @@ cy_en_smif_status_t qspi_init(cy_stc_smif_block_config_t *blk_config)
     return st;
 }
 
+/*
+ * The PDL keeps a single erase command, so the block erase commands of the
+ * memory are read from the basic flash parameter table (BFPT) of its SFDP.
+ * They are sorted by size, largest first.
+ */
+#define QSPI_SFDP_CMD               0x5AU
+#define QSPI_SFDP_SIGNATURE         0x50444653U /* "SFDP" */
+#define QSPI_SFDP_MAX_HEADERS       8U
+#define QSPI_SFDP_BFPT_ID           0xFF00U
+#define QSPI_SFDP_SECTOR_MAP_ID     0xFF81U
+#define QSPI_SFDP_4BAIT_ID          0xFF84U
+#define QSPI_SFDP_BFPT_DWORDS       10U
+
+static struct qspi_erase_type qspi_erase_types[QSPI_ERASE_TYPES_MAX];
+static uint32_t qspi_erase_type_count;
+
+static cy_en_smif_status_t qspi_read_sfdp(cy_stc_smif_mem_config_t *memCfg,
+                                          uint32_t addr, uint8_t *buf,
+                                          uint32_t len)
+{
+    uint8_t param[3];
+    cy_en_smif_status_t st;
+
+    param[0] = (uint8_t)(addr >> 16);
+    param[1] = (uint8_t)(addr >> 8);
+    param[2] = (uint8_t)addr;
+
+    st = Cy_SMIF_TransmitCommand(QSPIPort, QSPI_SFDP_CMD,
+                                 CY_SMIF_WIDTH_SINGLE, param, sizeof(param),
+                                 CY_SMIF_WIDTH_SINGLE, memCfg->slaveSelect,
+                                 CY_SMIF_TX_NOT_LAST_BYTE, &QSPI_context);
+    if (st == CY_SMIF_SUCCESS)
+    {
+        st = Cy_SMIF_SendDummyCycles(QSPIPort, sfdpcmd.dummyCycles);
+    }
+    if (st == CY_SMIF_SUCCESS)
+    {
+        st = Cy_SMIF_ReceiveDataBlocking(QSPIPort, buf, len,
+                                         CY_SMIF_WIDTH_SINGLE, &QSPI_context);
+    }
+    return st;
+}
+
+static uint32_t qspi_sfdp_dword(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void qspi_add_erase_type(uint32_t size, uint32_t cmd, uint32_t time)
+{
+    uint32_t i;
+
+    for (i = 0; i < qspi_erase_type_count; i++)
+    {
+        if (qspi_erase_types[i].size == size)
+        {
+            return;
+        }
+        if (qspi_erase_types[i].size < size)
+        {
+            break;
+        }
+    }
+    if (qspi_erase_type_count == QSPI_ERASE_TYPES_MAX)
+    {
+        return;
+    }
+
+    memmove(&qspi_erase_types[i + 1], &qspi_erase_types[i],
+            (qspi_erase_type_count - i) * sizeof(qspi_erase_types[0]));
+    qspi_erase_types[i].size = size;
+    qspi_erase_types[i].cmd = cmd;
+    qspi_erase_types[i].time = time;
+    qspi_erase_type_count++;
+}
+
+static void qspi_sfdp_erase_types(cy_stc_smif_mem_config_t *memCfg)
+{
+    static const uint32_t time_units[4] = { 1U, 16U, 128U, 1000U };
+    cy_stc_smif_mem_device_cfg_t *dev = memCfg->deviceCfg;
+    uint8_t hdr[8];
+    uint8_t bfpt[QSPI_SFDP_BFPT_DWORDS * 4U];
+    uint8_t bait[8];
+    uint32_t bfpt_addr = 0;
+    uint32_t bfpt_len = 0;
+    uint32_t bait_addr = 0;
+    uint32_t bait_len = 0;
+    bool sector_map = false;
+    bool addr4 = (dev->numOfAddrBytes == 4U);
+    uint32_t times = 0;
+    uint32_t nph;
+    uint32_t id;
+    uint32_t i;
+    uint32_t size;
+    uint32_t cmd;
+    uint32_t time;
+    uint32_t field;
+
+    /* The command the PDL found is always usable */
+    qspi_erase_type_count = 0;
+    qspi_add_erase_type(dev->eraseSize, dev->eraseCmd->command, dev->eraseTime);
+
+    if (qspi_read_sfdp(memCfg, 0U, hdr, sizeof(hdr)) != CY_SMIF_SUCCESS ||
+        qspi_sfdp_dword(hdr) != QSPI_SFDP_SIGNATURE)
+    {
+        return;
+    }
+
+    nph = (uint32_t)hdr[6] + 1U;
+    if (nph > QSPI_SFDP_MAX_HEADERS)
+    {
+        nph = QSPI_SFDP_MAX_HEADERS;
+    }
+    for (i = 0; i < nph; i++)
+    {
+        if (qspi_read_sfdp(memCfg, 8U + 8U * i, hdr, sizeof(hdr)) != CY_SMIF_SUCCESS)
+        {
+            return;
+        }
+        id = (uint32_t)hdr[0] | ((uint32_t)hdr[7] << 8);
+        if (id == QSPI_SFDP_BFPT_ID && bfpt_len == 0U)
+        {
+            bfpt_len = hdr[3];
+            bfpt_addr = qspi_sfdp_dword(&hdr[4]) & 0xFFFFFFU;
+        }
+        else if (id == QSPI_SFDP_SECTOR_MAP_ID)
+        {
+            sector_map = true;
+        }
+        else if (id == QSPI_SFDP_4BAIT_ID)
+        {
+            bait_len = hdr[3];
+            bait_addr = qspi_sfdp_dword(&hdr[4]) & 0xFFFFFFU;
+        }
+    }
+
+    /*
+     * A sector map describes blocks of several sizes, where the smaller erase
+     * types only work in some places. The erase types are in DWORDs 8 and 9.
+     */
+    if (sector_map || bfpt_len < 9U)
+    {
+        return;
+    }
+    if (bfpt_len > QSPI_SFDP_BFPT_DWORDS)
+    {
+        bfpt_len = QSPI_SFDP_BFPT_DWORDS;
+    }
+    if (qspi_read_sfdp(memCfg, bfpt_addr, bfpt, bfpt_len * 4U) != CY_SMIF_SUCCESS)
+    {
+        return;
+    }
+    if (bfpt_len >= 10U)
+    {
+        times = qspi_sfdp_dword(&bfpt[36]);
+    }
+
+    /* With 4-byte addresses the opcodes are in the 4-byte address table */
+    if (addr4 && (bait_len < 2U ||
+        qspi_read_sfdp(memCfg, bait_addr, bait, sizeof(bait)) != CY_SMIF_SUCCESS))
+    {
+        return;
+    }
+
+    for (i = 0; i < 4U; i++)
+    {
+        if (bfpt[28U + 2U * i] == 0U || bfpt[28U + 2U * i] > 31U)
+        {
+            continue;
+        }
+        size = 1UL << bfpt[28U + 2U * i];
+        cmd = bfpt[29U + 2U * i];
+
+        /* The 4 KB erase may only work in some places, unless DWORD 1 says otherwise */
+        if (size == 4096U && (bfpt[0] & 0x03U) != 0x01U)
+        {
+            continue;
+        }
+        if (addr4)
+        {
+            if ((qspi_sfdp_dword(bait) & (1UL << (9U + i))) == 0U)
+            {
+                continue;
+            }
+            cmd = bait[4U + i];
+        }
+
+        /* DWORD 10: typical times, and the multiplier to the maximum */
+        if (times != 0U)
+        {
+            field = times >> (4U + 7U * i);
+            time = ((field & 0x1FU) + 1U) * time_units[(field >> 5) & 0x03U];
+            time *= 2U * ((times & 0x0FU) + 1U);
+        }
+        else
+        {
+            time = dev->eraseTime;
+        }
+        qspi_add_erase_type(size, cmd, time);
+    }
+}
+
+#ifdef CY_BOOT_SFDP_CACHE_ADDR
+/*
+ * The SFDP discovery reads and parses several tables from the memory on every
+ * boot. What it finds only depends on the part, so it is saved in a row of
+ * internal flash at CY_BOOT_SFDP_CACHE_ADDR together with the JEDEC ID of the
+ * part. On the next boots the JEDEC ID is read first and, while it matches,
+ * the saved parameters are used instead of running the discovery again.
+ */
+#define QSPI_JEDEC_ID_CMD       0x9FU
+#define QSPI_JEDEC_ID_SIZE      3U
+#define QSPI_SFDP_CACHE_MAGIC   0x50444653U /* "SFDP" */
+
+struct qspi_sfdp_cache
+{
+    uint32_t magic;
+    /* Changes with the layout of the PDL command structure */
+    uint32_t size;
+    uint8_t jedec_id[4];
+    uint32_t numOfAddrBytes;
+    uint32_t memSize;
+    uint32_t eraseSize;
+    uint32_t programSize;
+    uint32_t stsRegBusyMask;
+    uint32_t stsRegQuadEnableMask;
+    uint32_t eraseTime;
+    uint32_t chipEraseTime;
+    uint32_t programTime;
+    cy_stc_smif_mem_cmd_t readCmd;
+    cy_stc_smif_mem_cmd_t writeEnCmd;
+    cy_stc_smif_mem_cmd_t writeDisCmd;
+    cy_stc_smif_mem_cmd_t eraseCmd;
+    cy_stc_smif_mem_cmd_t chipEraseCmd;
+    cy_stc_smif_mem_cmd_t programCmd;
+    cy_stc_smif_mem_cmd_t readStsRegWipCmd;
+    cy_stc_smif_mem_cmd_t readStsRegQeCmd;
+    cy_stc_smif_mem_cmd_t writeStsRegQeCmd;
+    uint32_t eraseTypeCount;
+    struct qspi_erase_type eraseTypes[QSPI_ERASE_TYPES_MAX];
+    uint32_t crc;
+};
+
+static uint32_t qspi_sfdp_cache_crc(const struct qspi_sfdp_cache *cache)
+{
+    const uint8_t *p = (const uint8_t *)cache;
+    uint32_t len = offsetof(struct qspi_sfdp_cache, crc);
+    uint32_t crc = 0xFFFFFFFFU;
+    int bit;
+
+    while (len-- > 0U)
+    {
+        crc ^= *p++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+static cy_en_smif_status_t qspi_read_jedec_id(cy_stc_smif_mem_config_t *memCfg,
+                                              uint8_t *id)
+{
+    cy_en_smif_status_t st;
+
+    Cy_SMIF_SetDataSelect(QSPIPort, memCfg->slaveSelect, memCfg->dataSelect);
+
+    st = Cy_SMIF_TransmitCommand(QSPIPort, QSPI_JEDEC_ID_CMD,
+                                 CY_SMIF_WIDTH_SINGLE, NULL, 0U,
+                                 CY_SMIF_WIDTH_SINGLE, memCfg->slaveSelect,
+                                 CY_SMIF_TX_NOT_LAST_BYTE, &QSPI_context);
+    if (st == CY_SMIF_SUCCESS)
+    {
+        st = Cy_SMIF_ReceiveDataBlocking(QSPIPort, id, QSPI_JEDEC_ID_SIZE,
+                                         CY_SMIF_WIDTH_SINGLE, &QSPI_context);
+    }
+    return st;
+}
+
+/* Returns true if the device parameters were restored from the cache */
+static bool qspi_sfdp_cache_load(const uint8_t *id,
+                                 cy_stc_smif_mem_device_cfg_t *dev)
+{
+    struct qspi_sfdp_cache cache;
+
+    memcpy(&cache, (const void *)CY_BOOT_SFDP_CACHE_ADDR, sizeof(cache));
+
+    if (cache.magic != QSPI_SFDP_CACHE_MAGIC ||
+        cache.size != sizeof(cache) ||
+        memcmp(cache.jedec_id, id, QSPI_JEDEC_ID_SIZE) != 0 ||
+        cache.eraseTypeCount > QSPI_ERASE_TYPES_MAX ||
+        cache.crc != qspi_sfdp_cache_crc(&cache))
+    {
+        return false;
+    }
+
+    dev->numOfAddrBytes = cache.numOfAddrBytes;
+    dev->memSize = cache.memSize;
+    dev->eraseSize = cache.eraseSize;
+    dev->programSize = cache.programSize;
+    dev->stsRegBusyMask = cache.stsRegBusyMask;
+    dev->stsRegQuadEnableMask = cache.stsRegQuadEnableMask;
+    dev->eraseTime = cache.eraseTime;
+    dev->chipEraseTime = cache.chipEraseTime;
+    dev->programTime = cache.programTime;
+    *dev->readCmd = cache.readCmd;
+    *dev->writeEnCmd = cache.writeEnCmd;
+    *dev->writeDisCmd = cache.writeDisCmd;
+    *dev->eraseCmd = cache.eraseCmd;
+    *dev->chipEraseCmd = cache.chipEraseCmd;
+    *dev->programCmd = cache.programCmd;
+    *dev->readStsRegWipCmd = cache.readStsRegWipCmd;
+    *dev->readStsRegQeCmd = cache.readStsRegQeCmd;
+    *dev->writeStsRegQeCmd = cache.writeStsRegQeCmd;
+    qspi_erase_type_count = cache.eraseTypeCount;
+    memcpy(qspi_erase_types, cache.eraseTypes, sizeof(qspi_erase_types));
+
+    return true;
+}
+
+static void qspi_sfdp_cache_save(const uint8_t *id,
+                                 const cy_stc_smif_mem_device_cfg_t *dev)
+{
+    uint32_t row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+    struct qspi_sfdp_cache *cache = (struct qspi_sfdp_cache *)row;
+
+    memset(row, 0, sizeof(row));
+
+    cache->magic = QSPI_SFDP_CACHE_MAGIC;
+    cache->size = sizeof(*cache);
+    memcpy(cache->jedec_id, id, QSPI_JEDEC_ID_SIZE);
+    cache->numOfAddrBytes = dev->numOfAddrBytes;
+    cache->memSize = dev->memSize;
+    cache->eraseSize = dev->eraseSize;
+    cache->programSize = dev->programSize;
+    cache->stsRegBusyMask = dev->stsRegBusyMask;
+    cache->stsRegQuadEnableMask = dev->stsRegQuadEnableMask;
+    cache->eraseTime = dev->eraseTime;
+    cache->chipEraseTime = dev->chipEraseTime;
+    cache->programTime = dev->programTime;
+    cache->readCmd = *dev->readCmd;
+    cache->writeEnCmd = *dev->writeEnCmd;
+    cache->writeDisCmd = *dev->writeDisCmd;
+    cache->eraseCmd = *dev->eraseCmd;
+    cache->chipEraseCmd = *dev->chipEraseCmd;
+    cache->programCmd = *dev->programCmd;
+    cache->readStsRegWipCmd = *dev->readStsRegWipCmd;
+    cache->readStsRegQeCmd = *dev->readStsRegQeCmd;
+    cache->writeStsRegQeCmd = *dev->writeStsRegQeCmd;
+    cache->eraseTypeCount = qspi_erase_type_count;
+    memcpy(cache->eraseTypes, qspi_erase_types, sizeof(qspi_erase_types));
+    cache->crc = qspi_sfdp_cache_crc(cache);
+
+    /* A failed write only costs a discovery on the next boot */
+    (void)Cy_Flash_WriteRow((uint32_t)CY_BOOT_SFDP_CACHE_ADDR, row);
+}
+
+static cy_en_smif_status_t qspi_init_sfdp_cached(cy_stc_smif_block_config_t *blk_config)
+{
+    cy_stc_smif_mem_config_t *memCfg = blk_config->memConfig[0];
+    uint8_t id[QSPI_JEDEC_ID_SIZE];
+    bool id_valid;
+    bool cached = false;
+    cy_en_smif_status_t st;
+
+    st = qspi_init_hardware();
+    if (st != CY_SMIF_SUCCESS)
+    {
+        return st;
+    }
+
+    st = qspi_read_jedec_id(memCfg, id);
+    if (st != CY_SMIF_SUCCESS)
+    {
+        return st;
+    }
+
+    /* All zeros or all ones: nothing answered, leave it to the discovery */
+    id_valid = (id[0] != 0x00U && id[0] != 0xFFU);
+
+    if (id_valid && qspi_sfdp_cache_load(id, memCfg->deviceCfg))
+    {
+        cached = true;
+        memCfg->flags &= ~CY_SMIF_FLAG_DETECT_SFDP;
+    }
+    else
+    {
+        memCfg->flags |= CY_SMIF_FLAG_DETECT_SFDP;
+    }
+
+    smif_blk_config = blk_config;
+    st = Cy_SMIF_MemInit(QSPIPort, smif_blk_config, &QSPI_context);
+    if (st == CY_SMIF_SUCCESS && !cached)
+    {
+        qspi_sfdp_erase_types(memCfg);
+        if (id_valid)
+        {
+            qspi_sfdp_cache_save(id, memCfg->deviceCfg);
+        }
+    }
+    return st;
+}
+#endif /* CY_BOOT_SFDP_CACHE_ADDR */
+
 cy_en_smif_status_t qspi_init_sfdp(uint32_t smif_id)
 {
     cy_en_smif_status_t stat = CY_SMIF_SUCCESS;
@@ -450,7 +859,15 @@ cy_en_smif_status_t qspi_init_sfdp(uint32_t smif_id)
         Cy_GPIO_Pin_Init(SS_Port, SS_Pin, &QSPI_SS_config);
         Cy_GPIO_SetHSIOM(SS_Port, SS_Pin, SS_MuxPort);
 
+#ifdef CY_BOOT_SFDP_CACHE_ADDR
+        stat = qspi_init_sfdp_cached(&smifBlockConfig_sfdp);
+#else
         stat = qspi_init(&smifBlockConfig_sfdp);
+        if (stat == CY_SMIF_SUCCESS)
+        {
+            qspi_sfdp_erase_types(*memCfg);
+        }
+#endif
     }
     return stat;
 }
@@ -473,6 +890,12 @@ uint32_t qspi_get_mem_size(void)
     return (*memCfg)->deviceCfg->memSize;
 }
 
+uint32_t qspi_get_erase_types(const struct qspi_erase_type **types)
+{
+    *types = qspi_erase_types;
+    return qspi_erase_type_count;
+}
+
 void qspi_deinit(uint32_t smif_id)
 {
     Cy_SMIF_MemDeInit(QSPIPort);
@@ -53,12 +53,24 @@
 /* make it exported if used in TOC (cy_serial_flash_prog.c) */
 /* cy_stc_smif_block_config_t smifBlockConfig_sfdp; */
 
+/* The PDL erase command and up to four SFDP erase types */
+#define QSPI_ERASE_TYPES_MAX    5
+
+/* A block erase command of the external memory */
+struct qspi_erase_type
+{
+    uint32_t size;          /* Block size in bytes, a power of two */
+    uint32_t cmd;           /* Opcode for the address width in use */
+    uint32_t time;          /* Maximum erase time in ms */
+};
+
 cy_en_smif_status_t qspi_init_sfdp(uint32_t smif_id);
 cy_en_smif_status_t qspi_init(cy_stc_smif_block_config_t *blk_config);
 cy_en_smif_status_t qspi_init_hardware(void);
 uint32_t qspi_get_prog_size(void);
 uint32_t qspi_get_erase_size(void);
 uint32_t qspi_get_mem_size(void);
+uint32_t qspi_get_erase_types(const struct qspi_erase_type **types);
 
 SMIF_Type *qspi_get_device(void);
 cy_stc_smif_context_t *qspi_get_context(void);
@@ -80,6 +80,10 @@ static bool _cy_wdg_initialized = false;
 static bool _cy_wdg_pdl_initialized = false;
 static uint16_t _cy_wdg_initial_timeout_ms = 0;
 static uint8_t _cy_wdg_initial_ignore_bits = 0;
+// ILO ticks between kicks in cy_wdg_poll(): half the timeout, but at most half
+// of the range of the 16-bit counter, so that the elapsed time is unambiguous.
+static uint16_t _cy_wdg_poll_ticks = 0;
+static uint16_t _cy_wdg_last_kick = 0;
 
 static __INLINE uint32_t _cy_wdg_timeout_to_ignore_bits(uint32_t *timeout_ms) {
     for (uint32_t i = 0; i <= _cy_wdg_MAX_IGNORE_BITS; i++)
@@ -133,6 +137,10 @@ cy_rslt_t cy_wdg_init(uint32_t timeout_ms)
 
     Cy_WDT_SetMatch(_cy_wdg_timeout_to_match(timeout_ms, ignore_bits));
 
+    uint32_t poll_ticks = (uint32_t)(timeout_ms / .030518) / 2;
+    _cy_wdg_poll_ticks = (poll_ticks > 0x8000) ? 0x8000 : (uint16_t)poll_ticks;
+    _cy_wdg_last_kick = (uint16_t)Cy_WDT_GetCount();
+
     cy_wdg_start();
 
     return CY_RSLT_SUCCESS;
@@ -153,6 +161,17 @@ void cy_wdg_kick()
     _cy_wdg_unlock();
     Cy_WDT_SetMatch(_cy_wdg_timeout_to_match(_cy_wdg_initial_timeout_ms, _cy_wdg_initial_ignore_bits));
     _cy_wdg_lock();
+
+    _cy_wdg_last_kick = (uint16_t)Cy_WDT_GetCount();
+}
+
+void cy_wdg_poll(void)
+{
+    if (_cy_wdg_initialized &&
+        (uint16_t)(Cy_WDT_GetCount() - _cy_wdg_last_kick) >= _cy_wdg_poll_ticks)
+    {
+        cy_wdg_kick();
+    }
 }
 
 void cy_wdg_start()
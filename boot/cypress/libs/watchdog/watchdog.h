@@ -60,6 +60,14 @@ void cy_wdg_free();
 */
 void cy_wdg_kick();
 
+/** Resets the WDT if half of its timeout has passed
+*
+* Only reads the WDT counter otherwise, so it is cheap enough to be called from
+* loops. It must be called at least once a second, as the counter wraps every
+* two seconds.
+*/
+void cy_wdg_poll(void);
+
 /** Start (enable) the WDT
 *
 * @return The status of the start request
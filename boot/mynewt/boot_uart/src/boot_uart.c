@@ -19,19 +19,25 @@
 #include <assert.h>
 #include <stddef.h>
 #include <inttypes.h>
+#include <string.h>
 #include "os/mynewt.h"
 #include <uart/uart.h>
 
 /*
- * RX is a ring buffer, which gets drained constantly.
+ * RX is a ring buffer, which is filled from the UART interrupt and drained
+ * by boot_uart_read(). The interrupt handler only moves the head and the
+ * reader only moves the tail, so the reader copies the data out without
+ * blocking interrupts.
+ * When the ring is full the driver stops receiving, which deasserts RTS if
+ * flow control is enabled, until the reader has made room again.
  * TX blocks until buffer has been completely transmitted.
  */
-#define CONSOLE_HEAD_INC(cr) (((cr)->head + 1) & (sizeof((cr)->buf) - 1))
-#define CONSOLE_TAIL_INC(cr) (((cr)->tail + 1) & (sizeof((cr)->buf) - 1))
+#define CONSOLE_RX_MASK (sizeof(bs_uart_rx.buf) - 1)
 
 struct {
-    uint16_t head;
-    uint16_t tail;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint8_t stalled;
     uint8_t buf[MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE)];
 } bs_uart_rx;
 
@@ -72,62 +78,77 @@ boot_uart_close(void)
     os_dev_close(&bs_uart->ud_dev);
     bs_uart_rx.head = 0;
     bs_uart_rx.tail = 0;
+    bs_uart_rx.stalled = 0;
     bs_uart_tx.cnt = 0;
 }
 
 static int
 bs_rx_char(void *arg, uint8_t byte)
 {
-    if (CONSOLE_HEAD_INC(&bs_uart_rx) == bs_uart_rx.tail) {
+    uint16_t head = bs_uart_rx.head;
+
+    if (((head + 1) & CONSOLE_RX_MASK) == bs_uart_rx.tail) {
         /*
-         * RX queue full. Reader must drain this.
+         * RX queue full. The driver keeps the byte and delivers it again
+         * once the reader has drained some of the queue and restarted RX.
          */
+        bs_uart_rx.stalled = 1;
         return -1;
     }
-    bs_uart_rx.buf[bs_uart_rx.head] = byte;
-    bs_uart_rx.head = CONSOLE_HEAD_INC(&bs_uart_rx);
+    bs_uart_rx.buf[head] = byte;
+    bs_uart_rx.head = (head + 1) & CONSOLE_RX_MASK;
     return 0;
 }
 
-static uint8_t
-bs_pull_char(void)
-{
-    uint8_t ch;
-
-    ch = bs_uart_rx.buf[bs_uart_rx.tail];
-    bs_uart_rx.tail = CONSOLE_TAIL_INC(&bs_uart_rx);
-    return ch;
-}
-
 int
 boot_uart_read(char *str, int cnt, int *newline)
 {
+    uint16_t head;
+    uint16_t tail;
+    uint8_t *nl;
+    int len;
     int i;
     int sr;
-    uint8_t ch;
 
     *newline = 0;
     OS_ENTER_CRITICAL(sr);
-    for (i = 0; i < cnt; i++) {
-        if (bs_uart_rx.head == bs_uart_rx.tail) {
-            break;
-        }
+    head = bs_uart_rx.head;
+    OS_EXIT_CRITICAL(sr);
 
-        ch = bs_pull_char();
-        if (ch == '\n') {
-            *str = '\0';
+    /*
+     * Copy out at most two contiguous runs, up to the end of the buffer and
+     * from its start, stopping at the end of the line.
+     */
+    tail = bs_uart_rx.tail;
+    i = 0;
+    while (i < cnt && tail != head && !*newline) {
+        len = (head > tail ? head : sizeof(bs_uart_rx.buf)) - tail;
+        if (len > cnt - i) {
+            len = cnt - i;
+        }
+        nl = memchr(&bs_uart_rx.buf[tail], '\n', len);
+        if (nl) {
+            len = nl - &bs_uart_rx.buf[tail];
             *newline = 1;
-            break;
         }
-        /*
-         * Unblock interrupts allowing more incoming data.
-         */
-        OS_EXIT_CRITICAL(sr);
-        OS_ENTER_CRITICAL(sr);
-        *str++ = ch;
+        memcpy(str + i, &bs_uart_rx.buf[tail], len);
+        i += len;
+        tail = (tail + len + *newline) & CONSOLE_RX_MASK;
+    }
+    if (*newline) {
+        str[i] = '\0';
     }
+
+    OS_ENTER_CRITICAL(sr);
+    bs_uart_rx.tail = tail;
     OS_EXIT_CRITICAL(sr);
-    if (i > 0 || *newline) {
+
+    /*
+     * The tail is published before the flag is checked, so a byte the driver
+     * stalled on after this sees the room that was made.
+     */
+    if (bs_uart_rx.stalled) {
+        bs_uart_rx.stalled = 0;
         uart_start_rx(bs_uart);
     }
     return i;
@@ -29,6 +29,16 @@
 #if MYNEWT_VAL(BOOT_SERIAL)
 #define MCUBOOT_SERIAL 1
 #endif
+#if MYNEWT_VAL(BOOT_SERIAL_MAX_RECEIVE_SIZE)
+#define MCUBOOT_SERIAL_MAX_RECEIVE_SIZE MYNEWT_VAL(BOOT_SERIAL_MAX_RECEIVE_SIZE)
+#endif
+#if MYNEWT_VAL(BOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+#define MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL \
+    MYNEWT_VAL(BOOT_SERIAL_UPLOAD_RESUME_INTERVAL)
+#endif
+#if MYNEWT_VAL(BOOT_SERIAL_UPLOAD_LZ4_MAX)
+#define MCUBOOT_SERIAL_UPLOAD_LZ4_MAX MYNEWT_VAL(BOOT_SERIAL_UPLOAD_LZ4_MAX)
+#endif
 #if MYNEWT_VAL(BOOTUTIL_VALIDATE_SLOT0)
 #define MCUBOOT_VALIDATE_PRIMARY_SLOT 1
 #endif
@@ -70,9 +80,28 @@
     MYNEWT_VAL(BOOTUTIL_ENCRYPT_EC256) || MYNEWT_VAL(BOOTUTIL_ENCRYPT_X25519)
 #define MCUBOOT_ENC_IMAGES 1
 #endif
+#if MYNEWT_VAL(BOOTUTIL_ENCRYPT_AEAD)
+#define MCUBOOT_ENC_AEAD 1
+#endif
 #if MYNEWT_VAL(BOOTUTIL_SWAP_USING_MOVE)
 #define MCUBOOT_SWAP_USING_MOVE 1
 #endif
+#if MYNEWT_VAL(BOOTUTIL_SWAP_USING_OFFSET)
+#define MCUBOOT_SWAP_USING_OFFSET 1
+#endif
+#if MYNEWT_VAL(BOOTUTIL_TRAILER_COMPACT)
+#define MCUBOOT_TRAILER_COMPACT 1
+#endif
+#if MYNEWT_VAL(BOOTUTIL_WARM_BOOT)
+#define MCUBOOT_WARM_BOOT 1
+#endif
+#if MYNEWT_VAL(BOOTUTIL_STAGED_BOOT)
+#define MCUBOOT_STAGED_BOOT 1
+#define MCUBOOT_DEFERRED_IMAGES MYNEWT_VAL(BOOTUTIL_DEFERRED_IMAGES)
+#endif
+#if MYNEWT_VAL(BOOTUTIL_ERASE_SKIP_ERASED)
+#define MCUBOOT_ERASE_SKIP_ERASED 1
+#endif
 #if MYNEWT_VAL(BOOTUTIL_SWAP_SAVE_ENCTLV)
 #define MCUBOOT_SWAP_SAVE_ENCTLV 1
 #endif
@@ -90,6 +119,7 @@
 #endif
 
 #define MCUBOOT_MAX_IMG_SECTORS       MYNEWT_VAL(BOOTUTIL_MAX_IMG_SECTORS)
+#define MCUBOOT_IO_BUF_SIZE           MYNEWT_VAL(BOOTUTIL_IO_BUF_SIZE)
 
 #if MYNEWT_VAL(BOOTUTIL_FEED_WATCHDOG) && MYNEWT_VAL(WATCHDOG_INTERVAL)
 #include <hal/hal_watchdog.h>
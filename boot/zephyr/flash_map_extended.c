@@ -59,7 +59,8 @@ int flash_area_id_from_multi_image_slot(int image_index, int slot)
     case 0: return FLASH_AREA_IMAGE_PRIMARY(image_index);
 #if !defined(CONFIG_SINGLE_APPLICATION_SLOT)
     case 1: return FLASH_AREA_IMAGE_SECONDARY(image_index);
-#if !defined(CONFIG_BOOT_SWAP_USING_MOVE)
+#if !defined(CONFIG_BOOT_SWAP_USING_MOVE) && \
+    !defined(CONFIG_BOOT_SWAP_USING_OFFSET)
     case 2: return FLASH_AREA_IMAGE_SCRATCH;
 #endif
 #endif
@@ -66,6 +66,14 @@
 #define MCUBOOT_SWAP_USING_MOVE 1
 #endif
 
+#ifdef CONFIG_BOOT_SWAP_USING_OFFSET
+#define MCUBOOT_SWAP_USING_OFFSET 1
+#endif
+
+#ifdef CONFIG_BOOT_TRAILER_COMPACT
+#define MCUBOOT_TRAILER_COMPACT 1
+#endif
+
 #ifdef CONFIG_BOOT_DIRECT_XIP
 #define MCUBOOT_DIRECT_XIP
 #endif
@@ -105,6 +113,10 @@
 #define MCUBOOT_ENCRYPT_X25519
 #endif
 
+#ifdef CONFIG_BOOT_ENCRYPT_AEAD
+#define MCUBOOT_ENC_AEAD
+#endif
+
 #ifdef CONFIG_BOOT_BOOTSTRAP
 #define MCUBOOT_BOOTSTRAP 1
 #endif
@@ -129,6 +141,32 @@
 #define MCUBOOT_DATA_SHARING
 #endif
 
+#ifdef CONFIG_BOOT_WARM_BOOT
+#define MCUBOOT_WARM_BOOT
+#endif
+
+#ifdef CONFIG_BOOT_STAGED_BOOT
+#define MCUBOOT_STAGED_BOOT
+#define MCUBOOT_DEFERRED_IMAGES CONFIG_BOOT_DEFERRED_IMAGES
+#endif
+
+#ifdef CONFIG_BOOT_ERASE_SKIP_ERASED
+#define MCUBOOT_ERASE_SKIP_ERASED
+#endif
+
+#ifdef CONFIG_BOOT_SERIAL_MAX_RECEIVE_SIZE
+#define MCUBOOT_SERIAL_MAX_RECEIVE_SIZE CONFIG_BOOT_SERIAL_MAX_RECEIVE_SIZE
+#endif
+
+#ifdef CONFIG_BOOT_SERIAL_UPLOAD_RESUME
+#define MCUBOOT_SERIAL_UPLOAD_RESUME_INTERVAL \
+    CONFIG_BOOT_SERIAL_UPLOAD_RESUME_INTERVAL
+#endif
+
+#ifdef CONFIG_BOOT_SERIAL_UPLOAD_LZ4
+#define MCUBOOT_SERIAL_UPLOAD_LZ4_MAX CONFIG_BOOT_SERIAL_UPLOAD_LZ4_MAX
+#endif
+
 #ifdef CONFIG_BOOT_FIH_PROFILE_OFF
 #define MCUBOOT_FIH_PROFILE_OFF
 #endif
@@ -156,6 +194,8 @@
 
 #define MCUBOOT_MAX_IMG_SECTORS       CONFIG_BOOT_MAX_IMG_SECTORS
 
+#define MCUBOOT_IO_BUF_SIZE           CONFIG_BOOT_IO_BUF_SIZE
+
 #endif /* !__BOOTSIM__ */
 
 #if CONFIG_BOOT_WATCHDOG_FEED
@@ -184,6 +224,13 @@
 #error "No NRFX WDT instances enabled"
 #endif /* defined(CONFIG_NRFX_WDT0) && defined(CONFIG_NRFX_WDT1) */
 
+#if CONFIG_BOOT_WATCHDOG_FEED_INTERVAL_MS > 0
+#include <kernel.h>
+
+#define MCUBOOT_WATCHDOG_TICKS()    k_uptime_get_32()
+#define MCUBOOT_WATCHDOG_FEED_TICKS CONFIG_BOOT_WATCHDOG_FEED_INTERVAL_MS
+#endif
+
 #else /* CONFIG_NRFX_WDT */
 #warning "MCUBOOT_WATCHDOG_FEED() is no-op"
 /* No vendor implementation, no-op for historical reasons */
@@ -39,7 +39,8 @@
 #error "Image slot and flash area mapping is not defined"
 #endif
 
-#if !defined(CONFIG_BOOT_SWAP_USING_MOVE)
+#if !defined(CONFIG_BOOT_SWAP_USING_MOVE) && \
+    !defined(CONFIG_BOOT_SWAP_USING_OFFSET)
 #define FLASH_AREA_IMAGE_SCRATCH    FLASH_AREA_ID(image_scratch)
 #endif
 
@@ -0,0 +1,115 @@
+/*
+ * Multiplication and squaring for the Cortex-M3/M4/M33, replacing the ones in
+ * curve25519_32.h.
+ *
+ * The generated code computes all the partial products before adding them up,
+ * which needs many more registers than these cores have, so most of them end
+ * up spilled to the stack, and it is fully unrolled, which costs several
+ * kilobytes of flash. These versions compute one output limb at a time: each
+ * limb is a single chain of UMLAL into one register pair, with the operands
+ * loaded as they are needed. The carries are the ones of the generated code,
+ * so the input and output bounds are the same.
+ */
+
+#include <stdint.h>
+
+/*
+ * Carry the column sums into a tight field element, as the end of the
+ * generated fiat_25519_carry_mul does.
+ */
+static void fiat_25519_cortex_m_carry(uint32_t out1[10], const uint64_t arg1[10]) {
+  uint64_t x1 = (arg1[0]);
+  uint64_t x2;
+  uint32_t x3;
+  unsigned i;
+
+  // The even limbs have 26 bits, the odd ones 25.
+  for (i = 0; i < 9; i++) {
+    out1[i] = (uint32_t)x1 & ((i & 1) ? UINT32_C(0x1ffffff) : UINT32_C(0x3ffffff));
+    x1 = (x1 >> ((i & 1) ? 25 : 26)) + arg1[i + 1];
+  }
+  out1[9] = (uint32_t)x1 & UINT32_C(0x1ffffff);
+  x2 = (out1[0] + ((x1 >> 25) * UINT8_C(0x13)));
+  out1[0] = (uint32_t)x2 & UINT32_C(0x3ffffff);
+  x3 = ((uint32_t)(x2 >> 26) + out1[1]);
+  out1[1] = x3 & UINT32_C(0x1ffffff);
+  out1[2] += (x3 >> 25);
+}
+
+/*
+ * Input Bounds:
+ *   arg1: [[0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999]]
+ *   arg2: [[0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999]]
+ * Output Bounds:
+ *   out1: [[0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333]]
+ */
+static void fiat_25519_carry_mul(uint32_t out1[10], const uint32_t arg1[10], const uint32_t arg2[10]) {
+  // The odd limbs are half a bit short of their position, so the product of
+  // two odd limbs, which only lands in the even columns, is doubled: f2 holds
+  // arg1 with its odd limbs doubled. The products which wrap around 2^255 are
+  // multiplied by 19: g19 holds arg2 multiplied by 19.
+  uint32_t f2[10];
+  uint32_t g19[10];
+  uint64_t x1[10];
+  unsigned i;
+  unsigned k;
+
+  for (i = 0; i < 10; i++) {
+    f2[i] = arg1[i] << (i & 1);
+    g19[i] = arg2[i] * UINT8_C(0x13);
+  }
+
+  for (k = 0; k < 10; k++) {
+    const uint32_t *f = (k & 1) ? arg1 : f2;
+    uint64_t acc = 0;
+    for (i = 0; i <= k; i++) {
+      acc += (uint64_t)f[i] * arg2[k - i];
+    }
+    for (; i < 10; i++) {
+      acc += (uint64_t)f[i] * g19[k + 10 - i];
+    }
+    x1[k] = acc;
+  }
+
+  fiat_25519_cortex_m_carry(out1, x1);
+}
+
+/*
+ * Input Bounds:
+ *   arg1: [[0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999], [0x0 ~> 0xd333332], [0x0 ~> 0x6999999]]
+ * Output Bounds:
+ *   out1: [[0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333], [0x0 ~> 0x4666666], [0x0 ~> 0x2333333]]
+ */
+static void fiat_25519_carry_square(uint32_t out1[10], const uint32_t arg1[10]) {
+  // As in the multiplication, but each product of two different limbs
+  // appears twice in a column, so it is computed once and doubled.
+  uint32_t f2[10];
+  uint32_t f19[10];
+  uint64_t x1[10];
+  unsigned i;
+  unsigned k;
+
+  for (i = 0; i < 10; i++) {
+    f2[i] = arg1[i] << (i & 1);
+    f19[i] = arg1[i] * UINT8_C(0x13);
+  }
+
+  for (k = 0; k < 10; k++) {
+    const uint32_t *f = (k & 1) ? arg1 : f2;
+    uint64_t acc = 0;
+    for (i = 0; 2 * i < k; i++) {
+      acc += (uint64_t)f[i] * arg1[k - i];
+    }
+    for (i = k + 1; 2 * i < k + 10; i++) {
+      acc += (uint64_t)f[i] * f19[k + 10 - i];
+    }
+    acc <<= 1;
+    if ((k & 1) == 0) {
+      acc += (uint64_t)f[k / 2] * arg1[k / 2];
+      acc += (uint64_t)f[k / 2 + 5] * f19[k / 2 + 5];
+    }
+    x1[k] = acc;
+  }
+
+  fiat_25519_cortex_m_carry(out1, x1);
+}
@@ -11,6 +11,8 @@ CC:=gcc
 CFLAGS:=-Os -std=c99 -Wall -Wextra -D_ISOC99_SOURCE -MMD -I../lib/include/ -I../lib/source/ -I../tests/include/
 vpath %.c ../lib/source/
 ENABLE_TESTS=true
+# Unrolled p-256 field arithmetic (uECC_OPTIMIZE_P256 in ecc.h):
+ENABLE_P256_UNROLLED=false
 
 # override MinGW built-in recipe
 %.o: %.c
@@ -26,10 +28,14 @@ CFLAGS += -DENABLE_TESTS
 else
 CFLAGS += -DDISABLE_TESTS
 endif
+ifeq ($(ENABLE_P256_UNROLLED), true)
+CFLAGS += -DuECC_OPTIMIZE_P256=1
+endif
 
 export CC
 export CFLAGS
 export VPATH
 export ENABLE_TESTS
+export ENABLE_P256_UNROLLED
 
 ################################################################################
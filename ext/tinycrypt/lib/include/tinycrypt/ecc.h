@@ -85,6 +85,20 @@ extern "C" {
 #define uECC_RNG_MAX_TRIES 64
 #endif
 
+/* Use fully unrolled multiply, square and reduction for curve p-256 instead
+ * of the generic word loops: faster ECDSA and ECDH, for more code size: */
+#ifndef uECC_OPTIMIZE_P256
+#define uECC_OPTIMIZE_P256 0
+#endif
+
+/* Inline assembly for the multiply steps of the unrolled p-256 kernels: */
+#define uECC_asm_none 0
+#define uECC_asm_thumb 1  /* Cortex-M0/M0+/M23: 32x32->64 bit multiply. */
+#define uECC_asm_thumb2 2 /* Cortex-M3/M4/M7/M33: multiply-accumulate. */
+#ifndef uECC_ASM
+#define uECC_ASM uECC_asm_none
+#endif
+
 /* defining data types to store word and bit counts: */
 typedef int8_t wordcount_t;
 typedef int16_t bitcount_t;
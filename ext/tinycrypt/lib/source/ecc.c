@@ -255,6 +255,288 @@ static void muladd(uECC_word_t a, uECC_word_t b, uECC_word_t *r0,
 
 }
 
+#if uECC_OPTIMIZE_P256
+/*
+ * Unrolled kernels for curve p-256. The multiply-accumulate steps add
+ * a * b (P256_MULADD) or 2 * a * b (P256_MULADD2) to the three word column
+ * accumulator r2:r1:r0 of the function using them, and P256_COLUMN stores the
+ * low word of a finished column and shifts the accumulator.
+ */
+#if uECC_ASM == uECC_asm_thumb2
+
+#if !defined(__thumb2__)
+#error "uECC_asm_thumb2 requires a Thumb-2 target."
+#endif
+
+#define P256_MULADD(a, b)						\
+	do {								\
+		uECC_word_t lo_, hi_;					\
+		__asm__ ("umull %[lo], %[hi], %[a_], %[b_]\n\t"	\
+			 "adds %[r0_], %[r0_], %[lo]\n\t"		\
+			 "adcs %[r1_], %[r1_], %[hi]\n\t"		\
+			 "adc %[r2_], %[r2_], #0"			\
+			 : [r0_] "+r" (r0), [r1_] "+r" (r1),		\
+			   [r2_] "+r" (r2), [lo] "=&r" (lo_),		\
+			   [hi] "=&r" (hi_)				\
+			 : [a_] "r" (a), [b_] "r" (b)			\
+			 : "cc");					\
+	} while (0)
+
+#define P256_MULADD2(a, b)						\
+	do {								\
+		uECC_word_t lo_, hi_;					\
+		__asm__ ("umull %[lo], %[hi], %[a_], %[b_]\n\t"	\
+			 "adds %[lo], %[lo], %[lo]\n\t"			\
+			 "adcs %[hi], %[hi], %[hi]\n\t"			\
+			 "adc %[r2_], %[r2_], #0\n\t"			\
+			 "adds %[r0_], %[r0_], %[lo]\n\t"		\
+			 "adcs %[r1_], %[r1_], %[hi]\n\t"		\
+			 "adc %[r2_], %[r2_], #0"			\
+			 : [r0_] "+r" (r0), [r1_] "+r" (r1),		\
+			   [r2_] "+r" (r2), [lo] "=&r" (lo_),		\
+			   [hi] "=&r" (hi_)				\
+			 : [a_] "r" (a), [b_] "r" (b)			\
+			 : "cc");					\
+	} while (0)
+
+#else /* uECC_ASM != uECC_asm_thumb2 */
+
+#if uECC_ASM == uECC_asm_thumb
+
+#if !defined(__thumb__)
+#error "uECC_asm_thumb requires a Thumb target."
+#endif
+
+/*
+ * hi:lo = a * b from the four 16x16 bit products, as Thumb-1 only has a
+ * 32x32->32 bit multiply.
+ */
+#define P256_MUL(a, b, lo, hi)						\
+	do {								\
+		uECC_word_t a_ = (a), b_ = (b), t_;			\
+		__asm__ (".syntax unified\n\t"				\
+			 "uxth %[lo_], %[x]\n\t"			\
+			 "lsrs %[x], %[x], #16\n\t"			\
+			 "uxth %[t], %[y]\n\t"				\
+			 "lsrs %[y], %[y], #16\n\t"			\
+			 "mov %[hi_], %[x]\n\t"				\
+			 "muls %[hi_], %[y], %[hi_]\n\t"		\
+			 "muls %[y], %[lo_], %[y]\n\t"			\
+			 "muls %[x], %[t], %[x]\n\t"			\
+			 "muls %[lo_], %[t], %[lo_]\n\t"		\
+			 "adds %[x], %[x], %[y]\n\t"			\
+			 "movs %[t], #0\n\t"				\
+			 "adcs %[t], %[t], %[t]\n\t"			\
+			 "lsls %[t], %[t], #16\n\t"			\
+			 "adds %[hi_], %[hi_], %[t]\n\t"		\
+			 "lsls %[t], %[x], #16\n\t"			\
+			 "lsrs %[x], %[x], #16\n\t"			\
+			 "adds %[lo_], %[lo_], %[t]\n\t"		\
+			 "adcs %[hi_], %[hi_], %[x]"			\
+			 : [x] "+l" (a_), [y] "+l" (b_),		\
+			   [lo_] "=&l" (lo), [hi_] "=&l" (hi),		\
+			   [t] "=&l" (t_)				\
+			 :						\
+			 : "cc");					\
+	} while (0)
+
+#else /* uECC_ASM == uECC_asm_none */
+
+#define P256_MUL(a, b, lo, hi)						\
+	do {								\
+		uECC_dword_t p_ = (uECC_dword_t)(a) * (b);		\
+		lo = (uECC_word_t)p_;					\
+		hi = (uECC_word_t)(p_ >> uECC_WORD_BITS);		\
+	} while (0)
+
+#endif /* uECC_ASM */
+
+/* The high word of a product is at most 0xFFFFFFFE, so it takes a carry. */
+#define P256_MULADD(a, b)						\
+	do {								\
+		uECC_word_t lo_, hi_;					\
+		P256_MUL(a, b, lo_, hi_);				\
+		r0 += lo_;						\
+		hi_ += (r0 < lo_);					\
+		r1 += hi_;						\
+		r2 += (r1 < hi_);					\
+	} while (0)
+
+#define P256_MULADD2(a, b)						\
+	do {								\
+		uECC_word_t lo_, hi_;					\
+		P256_MUL(a, b, lo_, hi_);				\
+		r2 += hi_ >> (uECC_WORD_BITS - 1);			\
+		hi_ = (hi_ << 1) | (lo_ >> (uECC_WORD_BITS - 1));	\
+		lo_ <<= 1;						\
+		r0 += lo_;						\
+		hi_ += (r0 < lo_);					\
+		r1 += hi_;						\
+		r2 += (r1 < hi_);					\
+	} while (0)
+
+#endif /* uECC_ASM == uECC_asm_thumb2 */
+
+#define P256_COLUMN(out)						\
+	do {								\
+		(out) = r0;						\
+		r0 = r1;						\
+		r1 = r2;						\
+		r2 = 0;							\
+	} while (0)
+
+/* Computes result = left * right for p-256. Result must be 16 words long. */
+static void vli_mult_p256(uECC_word_t *result, const uECC_word_t *left,
+			  const uECC_word_t *right)
+{
+	uECC_word_t r0 = 0;
+	uECC_word_t r1 = 0;
+	uECC_word_t r2 = 0;
+
+	P256_MULADD(left[0], right[0]);
+	P256_COLUMN(result[0]);
+	P256_MULADD(left[0], right[1]);
+	P256_MULADD(left[1], right[0]);
+	P256_COLUMN(result[1]);
+	P256_MULADD(left[0], right[2]);
+	P256_MULADD(left[1], right[1]);
+	P256_MULADD(left[2], right[0]);
+	P256_COLUMN(result[2]);
+	P256_MULADD(left[0], right[3]);
+	P256_MULADD(left[1], right[2]);
+	P256_MULADD(left[2], right[1]);
+	P256_MULADD(left[3], right[0]);
+	P256_COLUMN(result[3]);
+	P256_MULADD(left[0], right[4]);
+	P256_MULADD(left[1], right[3]);
+	P256_MULADD(left[2], right[2]);
+	P256_MULADD(left[3], right[1]);
+	P256_MULADD(left[4], right[0]);
+	P256_COLUMN(result[4]);
+	P256_MULADD(left[0], right[5]);
+	P256_MULADD(left[1], right[4]);
+	P256_MULADD(left[2], right[3]);
+	P256_MULADD(left[3], right[2]);
+	P256_MULADD(left[4], right[1]);
+	P256_MULADD(left[5], right[0]);
+	P256_COLUMN(result[5]);
+	P256_MULADD(left[0], right[6]);
+	P256_MULADD(left[1], right[5]);
+	P256_MULADD(left[2], right[4]);
+	P256_MULADD(left[3], right[3]);
+	P256_MULADD(left[4], right[2]);
+	P256_MULADD(left[5], right[1]);
+	P256_MULADD(left[6], right[0]);
+	P256_COLUMN(result[6]);
+	P256_MULADD(left[0], right[7]);
+	P256_MULADD(left[1], right[6]);
+	P256_MULADD(left[2], right[5]);
+	P256_MULADD(left[3], right[4]);
+	P256_MULADD(left[4], right[3]);
+	P256_MULADD(left[5], right[2]);
+	P256_MULADD(left[6], right[1]);
+	P256_MULADD(left[7], right[0]);
+	P256_COLUMN(result[7]);
+	P256_MULADD(left[1], right[7]);
+	P256_MULADD(left[2], right[6]);
+	P256_MULADD(left[3], right[5]);
+	P256_MULADD(left[4], right[4]);
+	P256_MULADD(left[5], right[3]);
+	P256_MULADD(left[6], right[2]);
+	P256_MULADD(left[7], right[1]);
+	P256_COLUMN(result[8]);
+	P256_MULADD(left[2], right[7]);
+	P256_MULADD(left[3], right[6]);
+	P256_MULADD(left[4], right[5]);
+	P256_MULADD(left[5], right[4]);
+	P256_MULADD(left[6], right[3]);
+	P256_MULADD(left[7], right[2]);
+	P256_COLUMN(result[9]);
+	P256_MULADD(left[3], right[7]);
+	P256_MULADD(left[4], right[6]);
+	P256_MULADD(left[5], right[5]);
+	P256_MULADD(left[6], right[4]);
+	P256_MULADD(left[7], right[3]);
+	P256_COLUMN(result[10]);
+	P256_MULADD(left[4], right[7]);
+	P256_MULADD(left[5], right[6]);
+	P256_MULADD(left[6], right[5]);
+	P256_MULADD(left[7], right[4]);
+	P256_COLUMN(result[11]);
+	P256_MULADD(left[5], right[7]);
+	P256_MULADD(left[6], right[6]);
+	P256_MULADD(left[7], right[5]);
+	P256_COLUMN(result[12]);
+	P256_MULADD(left[6], right[7]);
+	P256_MULADD(left[7], right[6]);
+	P256_COLUMN(result[13]);
+	P256_MULADD(left[7], right[7]);
+	result[14] = r0;
+	result[15] = r1;
+}
+
+/* Computes result = left^2 for p-256. Result must be 16 words long. */
+static void vli_square_p256(uECC_word_t *result, const uECC_word_t *left)
+{
+	uECC_word_t r0 = 0;
+	uECC_word_t r1 = 0;
+	uECC_word_t r2 = 0;
+
+	P256_MULADD(left[0], left[0]);
+	P256_COLUMN(result[0]);
+	P256_MULADD2(left[0], left[1]);
+	P256_COLUMN(result[1]);
+	P256_MULADD2(left[0], left[2]);
+	P256_MULADD(left[1], left[1]);
+	P256_COLUMN(result[2]);
+	P256_MULADD2(left[0], left[3]);
+	P256_MULADD2(left[1], left[2]);
+	P256_COLUMN(result[3]);
+	P256_MULADD2(left[0], left[4]);
+	P256_MULADD2(left[1], left[3]);
+	P256_MULADD(left[2], left[2]);
+	P256_COLUMN(result[4]);
+	P256_MULADD2(left[0], left[5]);
+	P256_MULADD2(left[1], left[4]);
+	P256_MULADD2(left[2], left[3]);
+	P256_COLUMN(result[5]);
+	P256_MULADD2(left[0], left[6]);
+	P256_MULADD2(left[1], left[5]);
+	P256_MULADD2(left[2], left[4]);
+	P256_MULADD(left[3], left[3]);
+	P256_COLUMN(result[6]);
+	P256_MULADD2(left[0], left[7]);
+	P256_MULADD2(left[1], left[6]);
+	P256_MULADD2(left[2], left[5]);
+	P256_MULADD2(left[3], left[4]);
+	P256_COLUMN(result[7]);
+	P256_MULADD2(left[1], left[7]);
+	P256_MULADD2(left[2], left[6]);
+	P256_MULADD2(left[3], left[5]);
+	P256_MULADD(left[4], left[4]);
+	P256_COLUMN(result[8]);
+	P256_MULADD2(left[2], left[7]);
+	P256_MULADD2(left[3], left[6]);
+	P256_MULADD2(left[4], left[5]);
+	P256_COLUMN(result[9]);
+	P256_MULADD2(left[3], left[7]);
+	P256_MULADD2(left[4], left[6]);
+	P256_MULADD(left[5], left[5]);
+	P256_COLUMN(result[10]);
+	P256_MULADD2(left[4], left[7]);
+	P256_MULADD2(left[5], left[6]);
+	P256_COLUMN(result[11]);
+	P256_MULADD2(left[5], left[7]);
+	P256_MULADD(left[6], left[6]);
+	P256_COLUMN(result[12]);
+	P256_MULADD2(left[6], left[7]);
+	P256_COLUMN(result[13]);
+	P256_MULADD(left[7], left[7]);
+	result[14] = r0;
+	result[15] = r1;
+}
+#endif /* uECC_OPTIMIZE_P256 */
+
 /* Computes result = left * right. Result must be 2 * num_words long. */
 static void uECC_vli_mult(uECC_word_t *result, const uECC_word_t *left,
 			  const uECC_word_t *right, wordcount_t num_words)
@@ -265,6 +547,13 @@ static void uECC_vli_mult(uECC_word_t *result, const uECC_word_t *left,
 	uECC_word_t r2 = 0;
 	wordcount_t i, k;
 
+#if uECC_OPTIMIZE_P256
+	if (num_words == NUM_ECC_WORDS) {
+		vli_mult_p256(result, left, right);
+		return;
+	}
+#endif
+
 	/* Compute each digit of result in sequence, maintaining the carries. */
 	for (k = 0; k < num_words; ++k) {
 
@@ -383,7 +672,14 @@ static void uECC_vli_modSquare_fast(uECC_word_t *result,
 				    const uECC_word_t *left,
 				    uECC_Curve curve)
 {
+#if uECC_OPTIMIZE_P256
+	uECC_word_t product[2 * NUM_ECC_WORDS];
+	vli_square_p256(product, left);
+
+	curve->mmod_fast(result, product);
+#else
 	uECC_vli_modMult_fast(result, left, left, curve);
+#endif
 }
 
 
@@ -520,8 +816,59 @@ uECC_Curve uECC_secp256r1(void)
 
 void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int*product)
 {
-	unsigned int tmp[NUM_ECC_WORDS];
 	int carry;
+#if uECC_OPTIMIZE_P256
+	/* t + 2 s1 + 2 s2 + s3 + s4 - d1 - d2 - d3 - d4, one word at a time, with
+	 * a signed carry into the next word. */
+	int64_t acc;
+
+	acc = (int64_t)product[0] + product[8] + product[9] - product[11] -
+	      product[12] - product[13] - product[14];
+	result[0] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[1] + product[9] + product[10] - product[12] -
+	       product[13] - product[14] - product[15];
+	result[1] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[2] + product[10] + product[11] - product[13] -
+	       product[14] - product[15];
+	result[2] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[3] + 2 * (int64_t)product[11] +
+	       2 * (int64_t)product[12] + product[13] - product[15] -
+	       product[8] - product[9];
+	result[3] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[4] + 2 * (int64_t)product[12] +
+	       2 * (int64_t)product[13] + product[14] - product[9] -
+	       product[10];
+	result[4] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[5] + 2 * (int64_t)product[13] +
+	       2 * (int64_t)product[14] + product[15] - product[10] -
+	       product[11];
+	result[5] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[6] + 3 * (int64_t)product[14] +
+	       2 * (int64_t)product[15] + product[13] - product[8] -
+	       product[9];
+	result[6] = (unsigned int)acc;
+	acc >>= 32;
+
+	acc += (int64_t)product[7] + 3 * (int64_t)product[15] + product[8] -
+	       product[10] - product[11] - product[12] - product[13];
+	result[7] = (unsigned int)acc;
+	acc >>= 32;
+
+	carry = (int)acc;
+#else
+	unsigned int tmp[NUM_ECC_WORDS];
 
 	/* t */
 	uECC_vli_set(result, product, NUM_ECC_WORDS);
@@ -605,6 +952,7 @@ void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int*product)
 	tmp[6] = 0;
 	tmp[7] = product[13];
 	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+#endif
 
 	if (carry < 0) {
 		do {
@@ -0,0 +1,331 @@
+/* test_ecc_bench.c - TinyCrypt p-256 field arithmetic tests and benchmarks */
+
+/*
+ *  SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  test_ecc_bench.c -- Checks the fast and the generic p-256 field
+ *  arithmetic against a plain reference, then times EC-DSA verify and
+ *  EC-DH. Build with ENABLE_P256_UNROLLED=true to check and time the
+ *  unrolled kernels.
+ */
+
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/ecc_dh.h>
+#include <tinycrypt/ecc_dsa.h>
+#include <tinycrypt/ecc_platform_specific.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_FIELD_TESTS 10000
+#define NUM_BENCH_OPS 20
+
+/* Operands which carry the most in the products and their reduction. */
+static void edge_operand(uECC_word_t *x, int i, uECC_Curve curve)
+{
+	uECC_word_t one[NUM_ECC_WORDS] = { 1 };
+
+	uECC_vli_clear(x, NUM_ECC_WORDS);
+	switch (i) {
+	case 0:
+		break;
+	case 1:
+		x[0] = 1;
+		break;
+	case 2:
+		/* p - 1 */
+		uECC_vli_sub(x, curve->p, one, NUM_ECC_WORDS);
+		break;
+	case 3:
+		/* p - 2 */
+		uECC_vli_sub(x, curve->p, one, NUM_ECC_WORDS);
+		uECC_vli_sub(x, x, one, NUM_ECC_WORDS);
+		break;
+	case 4:
+		x[NUM_ECC_WORDS - 1] = HIGH_BIT_SET;
+		break;
+	default:
+		memset(x, 0xff, (NUM_ECC_WORDS - 1) * sizeof(uECC_word_t));
+		break;
+	}
+}
+
+#define NUM_EDGE_OPERANDS 6
+
+/*
+ * Reference a * b mod p, which shares no code with the library: a product
+ * by rows, then a reduction one bit at a time.
+ */
+static void ref_modMult(uECC_word_t *result, const uECC_word_t *a,
+			const uECC_word_t *b, uECC_Curve curve)
+{
+	uECC_word_t product[2 * NUM_ECC_WORDS] = { 0 };
+	uECC_word_t r[NUM_ECC_WORDS + 1] = { 0 };
+	uECC_dword_t t;
+	int i, j, bit;
+
+	for (i = 0; i < NUM_ECC_WORDS; i++) {
+		t = 0;
+		for (j = 0; j < NUM_ECC_WORDS; j++) {
+			t += (uECC_dword_t)a[i] * b[j] + product[i + j];
+			product[i + j] = (uECC_word_t)t;
+			t >>= uECC_WORD_BITS;
+		}
+		product[i + NUM_ECC_WORDS] = (uECC_word_t)t;
+	}
+
+	for (bit = 2 * NUM_ECC_WORDS * uECC_WORD_BITS - 1; bit >= 0; bit--) {
+		/* r = 2 * r + bit, with r < p before, so r < 2 * p after. */
+		for (i = NUM_ECC_WORDS; i > 0; i--) {
+			r[i] = (r[i] << 1) | (r[i - 1] >> (uECC_WORD_BITS - 1));
+		}
+		r[0] = (r[0] << 1) |
+		       ((product[bit / uECC_WORD_BITS] >> (bit % uECC_WORD_BITS)) & 1);
+
+		/* r -= p if r >= p. */
+		for (i = NUM_ECC_WORDS - 1; i >= 0 && r[NUM_ECC_WORDS] == 0; i--) {
+			if (r[i] != curve->p[i]) {
+				break;
+			}
+		}
+		if (r[NUM_ECC_WORDS] != 0 || i < 0 || r[i] > curve->p[i]) {
+			t = 0;
+			for (i = 0; i < NUM_ECC_WORDS; i++) {
+				t = (uECC_dword_t)r[i] - curve->p[i] - t;
+				r[i] = (uECC_word_t)t;
+				t = (t >> uECC_WORD_BITS) & 1;
+			}
+			r[NUM_ECC_WORDS] -= (uECC_word_t)t;
+		}
+	}
+
+	memcpy(result, r, NUM_ECC_BYTES);
+}
+
+/*
+ * Checks one multiplication, fast and generic, and one x^3 - 3x + b, which
+ * squares, against the reference.
+ */
+static int field_check(const uECC_word_t *a, const uECC_word_t *b,
+		       uECC_Curve curve)
+{
+	uECC_word_t three[NUM_ECC_WORDS] = { 3 };
+	uECC_word_t res[NUM_ECC_WORDS];
+	uECC_word_t ref[NUM_ECC_WORDS];
+
+	ref_modMult(ref, a, b, curve);
+	uECC_vli_modMult_fast(res, a, b, curve);
+	if (uECC_vli_equal(res, ref, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("fast a * b mod p mismatch\n");
+		return TC_FAIL;
+	}
+	uECC_vli_modMult(res, a, b, curve->p, NUM_ECC_WORDS);
+	if (uECC_vli_equal(res, ref, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("generic a * b mod p mismatch\n");
+		return TC_FAIL;
+	}
+
+	x_side_default(res, a, curve);
+	ref_modMult(ref, a, a, curve);
+	uECC_vli_modSub(ref, ref, three, curve->p, NUM_ECC_WORDS);
+	ref_modMult(ref, ref, a, curve);
+	uECC_vli_modAdd(ref, ref, curve->b, curve->p, NUM_ECC_WORDS);
+	if (uECC_vli_equal(res, ref, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("a^3 - 3a + b mod p mismatch\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+/* Known answers, which check the reference itself. */
+static int ref_check(uECC_Curve curve)
+{
+	uECC_word_t one[NUM_ECC_WORDS] = { 1 };
+	uECC_word_t two[NUM_ECC_WORDS] = { 2 };
+	uECC_word_t x[NUM_ECC_WORDS];
+	uECC_word_t r[NUM_ECC_WORDS];
+	uECC_word_t expect[NUM_ECC_WORDS];
+
+	/* (p - 1)^2 = 1 */
+	uECC_vli_sub(x, curve->p, one, NUM_ECC_WORDS);
+	ref_modMult(r, x, x, curve);
+	if (uECC_vli_equal(r, one, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("reference (p - 1)^2 mod p != 1\n");
+		return TC_FAIL;
+	}
+
+	/* (p - 1) * 2 = p - 2 */
+	ref_modMult(r, x, two, curve);
+	uECC_vli_sub(expect, x, one, NUM_ECC_WORDS);
+	if (uECC_vli_equal(r, expect, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("reference 2 * (p - 1) mod p != p - 2\n");
+		return TC_FAIL;
+	}
+
+	/* 2^255 * 2 = 2^256 = 2^224 - 2^192 - 2^96 + 1 */
+	uECC_vli_clear(x, NUM_ECC_WORDS);
+	x[NUM_ECC_WORDS - 1] = HIGH_BIT_SET;
+	ref_modMult(r, x, two, curve);
+	memset(expect, 0, sizeof(expect));
+	expect[0] = 1;
+	expect[3] = 0xffffffff;
+	expect[4] = 0xffffffff;
+	expect[5] = 0xffffffff;
+	expect[6] = 0xfffffffe;
+	if (uECC_vli_equal(r, expect, NUM_ECC_WORDS) != 0) {
+		TC_ERROR("reference 2^256 mod p mismatch\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+int field_tests(void)
+{
+	uECC_word_t a[NUM_ECC_WORDS];
+	uECC_word_t b[NUM_ECC_WORDS];
+	const struct uECC_Curve_t *curve = uECC_secp256r1();
+	int i, j;
+
+	TC_PRINT("Test #1: p-256 field arithmetic (%d edge and %d random operands)\n",
+		 NUM_EDGE_OPERANDS * NUM_EDGE_OPERANDS, NUM_FIELD_TESTS);
+
+	if (ref_check(curve) == TC_FAIL) {
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < NUM_EDGE_OPERANDS; i++) {
+		for (j = 0; j < NUM_EDGE_OPERANDS; j++) {
+			edge_operand(a, i, curve);
+			edge_operand(b, j, curve);
+			if (field_check(a, b, curve) == TC_FAIL) {
+				return TC_FAIL;
+			}
+		}
+	}
+
+	for (i = 0; i < NUM_FIELD_TESTS; i++) {
+		uECC_generate_random_int(a, curve->p, NUM_ECC_WORDS);
+		uECC_generate_random_int(b, curve->p, NUM_ECC_WORDS);
+		if (field_check(a, b, curve) == TC_FAIL) {
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static double elapsed_ms(clock_t start, int ops)
+{
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / ops;
+}
+
+int bench_verify(void)
+{
+	uint8_t private[NUM_ECC_BYTES];
+	uint8_t public[2 * NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	uint8_t sig[2 * NUM_ECC_BYTES];
+	const struct uECC_Curve_t *curve = uECC_secp256r1();
+	clock_t start;
+	int i;
+
+	TC_PRINT("Test #2: EC-DSA verify benchmark (%d operations)\n",
+		 NUM_BENCH_OPS);
+
+	memset(hash, 0x5a, sizeof(hash));
+	if (!uECC_make_key(public, private, curve) ||
+	    !uECC_sign(private, hash, sizeof(hash), sig, curve)) {
+		TC_ERROR("key generation or signature failed\n");
+		return TC_FAIL;
+	}
+
+	start = clock();
+	for (i = 0; i < NUM_BENCH_OPS; i++) {
+		if (!uECC_verify(public, hash, sizeof(hash), sig, curve)) {
+			TC_ERROR("uECC_verify() failed\n");
+			return TC_FAIL;
+		}
+	}
+	TC_PRINT("  %.3f ms per verify\n", elapsed_ms(start, NUM_BENCH_OPS));
+
+	return TC_PASS;
+}
+
+int bench_ecdh(void)
+{
+	uint8_t private1[NUM_ECC_BYTES];
+	uint8_t public1[2 * NUM_ECC_BYTES];
+	uint8_t private2[NUM_ECC_BYTES];
+	uint8_t public2[2 * NUM_ECC_BYTES];
+	uint8_t secret1[NUM_ECC_BYTES];
+	uint8_t secret2[NUM_ECC_BYTES];
+	const struct uECC_Curve_t *curve = uECC_secp256r1();
+	clock_t start;
+	int i;
+
+	TC_PRINT("Test #3: EC-DH shared secret benchmark (%d operations)\n",
+		 NUM_BENCH_OPS);
+
+	if (!uECC_make_key(public1, private1, curve) ||
+	    !uECC_make_key(public2, private2, curve)) {
+		TC_ERROR("uECC_make_key() failed\n");
+		return TC_FAIL;
+	}
+
+	start = clock();
+	for (i = 0; i < NUM_BENCH_OPS; i++) {
+		if (!uECC_shared_secret(public2, private1, secret1, curve)) {
+			TC_ERROR("uECC_shared_secret() failed\n");
+			return TC_FAIL;
+		}
+	}
+	TC_PRINT("  %.3f ms per shared secret\n",
+		 elapsed_ms(start, NUM_BENCH_OPS));
+
+	if (!uECC_shared_secret(public1, private2, secret2, curve) ||
+	    memcmp(secret1, secret2, sizeof(secret1)) != 0) {
+		TC_ERROR("shared secrets differ\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+int main()
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing ECC field tests and benchmarks:");
+	/* Setup of the Cryptographically Secure PRNG. */
+	uECC_set_rng(&default_CSPRNG);
+
+	TC_PRINT("Unrolled p-256 kernels: %s\n",
+		 uECC_OPTIMIZE_P256 ? "yes" : "no");
+
+	result = field_tests();
+	if (result == TC_FAIL) {
+		TC_ERROR("field_tests test failed.\n");
+		goto exitTest;
+	}
+	result = bench_verify();
+	if (result == TC_FAIL) {
+		TC_ERROR("bench_verify test failed.\n");
+		goto exitTest;
+	}
+	result = bench_ecdh();
+	if (result == TC_FAIL) {
+		TC_ERROR("bench_ecdh test failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("\nAll ECC field tests and benchmarks succeeded.\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+}
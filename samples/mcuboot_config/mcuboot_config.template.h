@@ -33,6 +33,14 @@
 /* Uncomment for ECDSA signatures using curve P-256. */
 /* #define MCUBOOT_SIGN_EC256 */
 
+/* Uncomment for LMS (RFC 8554) hash-based signatures. */
+/* #define MCUBOOT_SIGN_LMS */
+#ifdef MCUBOOT_SIGN_LMS
+/* Largest accepted signature, the default fits LMOTS_SHA256_N32_W4 with
+ * trees up to LMS_SHA256_M32_H25. */
+/* #define MCUBOOT_SIGN_LMS_MAX_SIG_LEN 2988 */
+#endif
+
 
 /*
  * Upgrade mode
@@ -59,10 +67,17 @@
 /* #define MCUBOOT_DIRECT_XIP */
 /* Uncomment to enable the revert mechanism in direct-xip mode. */
 /* #define MCUBOOT_DIRECT_XIP_REVERT */
+/* With the revert mechanism, uncomment to boot an unconfirmed image up to
+ * this many times; it is then rejected without being erased. */
+/* #define MCUBOOT_BOOT_ATTEMPTS 3 */
 
 /* Uncomment to enable the ram-load code path. */
 /* #define MCUBOOT_RAM_LOAD */
 
+/* In direct-xip or ram-load mode, uncomment to configure more than two
+ * slots per image. */
+/* #define MCUBOOT_NUM_SLOTS 3 */
+
 /*
  * Cryptographic settings
  *
@@ -83,6 +98,14 @@
  */
 #define MCUBOOT_VALIDATE_PRIMARY_SLOT
 
+/* Uncomment to accept images hashed in blocks (imgtool --hash-block-size),
+ * and allow checking parts of them with bootutil_img_check_blocks(). */
+/* #define MCUBOOT_HASH_BLOCKS */
+
+/* Uncomment to accept encrypted images with an authenticated payload
+ * (imgtool --aead). Requires MCUBOOT_ENC_IMAGES. */
+/* #define MCUBOOT_ENC_AEAD */
+
 /*
  * Flash abstraction
  */
@@ -95,10 +118,25 @@
  * as desirable. */
 #define MCUBOOT_MAX_IMG_SECTORS 128
 
+/* Size of the RAM buffer used to copy image regions during an upgrade and to
+ * read images while validating them (default 1024). Larger buffers need fewer
+ * flash transactions. With encrypted images it must hold the image header. */
+/* #define MCUBOOT_IO_BUF_SIZE 1024 */
+
 /* Default number of separately updateable images; change in case of
  * multiple images. */
 #define MCUBOOT_IMAGE_NUMBER 1
 
+/* Uncomment to read the flash through a small LRU page cache, which mostly
+ * helps on external flash where each transaction is expensive. The page size
+ * and count can be tuned, and MCUBOOT_FLASH_CACHE_AREA_FILTER(fap) restricts
+ * the cache to some flash areas. See bootutil/flash_cache.h. */
+/* #define MCUBOOT_FLASH_CACHE */
+/* #define MCUBOOT_FLASH_CACHE_PAGE_SIZE 256 */
+/* #define MCUBOOT_FLASH_CACHE_PAGES 8 */
+/* #define MCUBOOT_FLASH_CACHE_AREA_FILTER(fap) \
+       ((fap)->fa_device_id != FLASH_DEVICE_INTERNAL_FLASH) */
+
 /*
  * Logging
  */
@@ -146,4 +184,15 @@
  *    do { do watchdog feeding here! } while (0)
  */
 
+/* The watchdog is fed for every block of an image which is copied or hashed
+ * and after every erase. To feed it less often on fast flash, either define
+ * MCUBOOT_WATCHDOG_POLL() to something which feeds the watchdog only when it
+ * is close to expiring, or provide a cheap monotonic counter with
+ * MCUBOOT_WATCHDOG_TICKS() and the number of its ticks between feeds with
+ * MCUBOOT_WATCHDOG_FEED_TICKS.
+ *
+ * #define MCUBOOT_WATCHDOG_TICKS()     read_monotonic_ms()
+ * #define MCUBOOT_WATCHDOG_FEED_TICKS  100
+ */
+
 #endif /* __MCUBOOT_CONFIG_H__ */
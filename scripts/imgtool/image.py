@@ -33,7 +33,7 @@ from cryptography.hazmat.primitives.ciphers import Cipher, algorithms, modes
 from cryptography.hazmat.primitives.kdf.hkdf import HKDF
 from cryptography.hazmat.primitives.serialization import Encoding, PublicFormat
 from cryptography.hazmat.backends import default_backend
-from cryptography.hazmat.primitives import hashes, hmac
+from cryptography.hazmat.primitives import cmac, hashes, hmac
 from cryptography.exceptions import InvalidSignature
 
 IMAGE_MAGIC = 0x96f3b83d
@@ -52,21 +52,26 @@ IMAGE_F = {
         'NON_BOOTABLE':          0x0000010,
         'RAM_LOAD':              0x0000020,
         'ENCRYPTED':             0x0000004,
+        'HASH_BLOCKS':           0x0000040,
+        'AEAD':                  0x0000080,
 }
 
 TLV_VALUES = {
         'KEYHASH': 0x01,
         'PUBKEY': 0x02,
         'SHA256': 0x10,
+        'SHA256_BLOCKS': 0x13,
         'RSA2048': 0x20,
         'ECDSA224': 0x21,
         'ECDSA256': 0x22,
         'RSA3072': 0x23,
         'ED25519': 0x24,
+        'LMS': 0x25,
         'ENCRSA2048': 0x30,
         'ENCKW128': 0x31,
         'ENCEC256': 0x32,
         'ENCX25519': 0x33,
+        'ENC_AEAD': 0x34,
         'DEPENDENCY': 0x40,
         'SEC_CNT': 0x50,
         'BOOT_RECORD': 0x60,
@@ -130,7 +135,9 @@ class Image():
                  pad_header=False, pad=False, confirm=False, align=1,
                  slot_size=0, max_sectors=DEFAULT_MAX_SECTORS,
                  overwrite_only=False, endian="little", load_addr=0,
-                 erased_val=None, save_enctlv=False, security_counter=None):
+                 erased_val=None, save_enctlv=False, security_counter=None,
+                 hash_block_size=None, slot_offset=0, compact_trailer=False,
+                 aead=False):
         self.version = version or versmod.decode_version("0")
         self.header_size = header_size
         self.pad_header = pad_header
@@ -138,6 +145,8 @@ class Image():
         self.confirm = confirm
         self.align = align
         self.slot_size = slot_size
+        self.slot_offset = slot_offset
+        self.compact_trailer = compact_trailer
         self.max_sectors = max_sectors
         self.overwrite_only = overwrite_only
         self.endian = endian
@@ -148,6 +157,8 @@ class Image():
         self.enckey = None
         self.save_enctlv = save_enctlv
         self.enctlv_len = 0
+        self.hash_block_size = hash_block_size
+        self.aead = aead
 
         if security_counter == 'auto':
             # Security counter has not been explicitly provided,
@@ -161,7 +172,8 @@ class Image():
     def __repr__(self):
         return "<Image version={}, header_size={}, security_counter={}, \
                 base_addr={}, load_addr={}, align={}, slot_size={}, \
-                max_sectors={}, overwrite_only={}, endian={} format={}, \
+                slot_offset={}, compact_trailer={}, max_sectors={}, \
+                overwrite_only={}, endian={} format={}, \
                 payloadlen=0x{:x}>".format(
                     self.version,
                     self.header_size,
@@ -170,6 +182,8 @@ class Image():
                     self.load_addr,
                     self.align,
                     self.slot_size,
+                    self.slot_offset,
+                    self.compact_trailer,
                     self.max_sectors,
                     self.overwrite_only,
                     self.endian,
@@ -211,7 +225,8 @@ class Image():
             h = IntelHex()
             if hex_addr is not None:
                 self.base_addr = hex_addr
-            h.frombytes(bytes=self.payload, offset=self.base_addr)
+            h.frombytes(bytes=self.payload,
+                        offset=self.base_addr + self.slot_offset)
             if self.pad:
                 trailer_size = self._trailer_size(self.align, self.max_sectors,
                                                   self.overwrite_only,
@@ -222,13 +237,13 @@ class Image():
                 padding = bytearray([self.erased_val] * 
                                     (trailer_size - len(boot_magic)))
                 if self.confirm and not self.overwrite_only:
-                    padding[-MAX_ALIGN] = 0x01  # image_ok = 0x01
+                    padding[self._image_ok_off()] = 0x01  # image_ok = 0x01
                 padding += boot_magic
                 h.puts(trailer_addr, bytes(padding))
             h.tofile(path, 'hex')
         else:
             if self.pad:
-                self.pad_to(self.slot_size)
+                self.pad_to(self.slot_size - self.slot_offset)
             with open(path, 'wb') as f:
                 f.write(self.payload)
 
@@ -243,11 +258,12 @@ class Image():
             tsize = self._trailer_size(self.align, self.max_sectors,
                                        self.overwrite_only, self.enckey,
                                        self.save_enctlv, self.enctlv_len)
-            padding = self.slot_size - (len(self.payload) + tsize)
+            size = self.slot_size - self.slot_offset
+            padding = size - (len(self.payload) + tsize)
             if padding < 0:
                 msg = "Image size (0x{:x}) + trailer (0x{:x}) exceeds " \
                       "requested size 0x{:x}".format(
-                          len(self.payload), tsize, self.slot_size)
+                          len(self.payload), tsize, size)
                 raise click.UsageError(msg)
 
     def ecies_hkdf(self, enckey, plainkey):
@@ -282,6 +298,10 @@ class Image():
                sw_type=None, custom_tlvs=None):
         self.enckey = enckey
 
+        if self.aead and (enckey is None or self.hash_block_size is not None):
+            raise click.UsageError("An authenticated image must be encrypted, "
+                                   "and can't be hashed in blocks")
+
         # Calculate the hash of the public key
         if key is not None:
             pub = key.get_public_bytes()
@@ -334,6 +354,10 @@ class Image():
             for value in custom_tlvs.values():
                 protected_tlv_size += TLV_SIZE + len(value)
 
+        if self.aead:
+            # Key check value, tag and SHA256 = 16 + 16 + 32 = 64 Bytes
+            protected_tlv_size += TLV_SIZE + 64
+
         if protected_tlv_size != 0:
             # Add the size of the TLV info header
             protected_tlv_size += TLV_INFO_SIZE
@@ -350,6 +374,9 @@ class Image():
         # This adds the header to the payload as well
         self.add_header(enckey, protected_tlv_size)
 
+        if enckey is not None:
+            plainkey = os.urandom(16)
+
         prot_tlv = TLV(self.endian, TLV_PROT_INFO_MAGIC)
 
         # Protected TLVs must be added first, because they are also included
@@ -382,18 +409,36 @@ class Image():
                 for tag, value in custom_tlvs.items():
                     prot_tlv.add(tag, value)
 
+            if self.aead:
+                prot_tlv.add('ENC_AEAD', self.aead_tlv(
+                    plainkey, bytes(self.payload[self.header_size:])))
+
             protected_tlv_off = len(self.payload)
             self.payload += prot_tlv.get()
 
         tlv = TLV(self.endian)
 
+        # The signed message is the image itself, or the list of block
+        # hashes for block hashed images. The payload of authenticated
+        # images is left out: the ENC_AEAD TLV stands for it.
+        if self.hash_block_size is not None:
+            signed = self.hash_blocks(self.payload, self.hash_block_size,
+                                      self.endian)
+        elif self.aead:
+            signed = bytes(self.payload[:self.header_size] +
+                           self.payload[protected_tlv_off:])
+        else:
+            signed = bytes(self.payload)
+
         # Note that ecdsa wants to do the hashing itself, which means
         # we get to hash it twice.
         sha = hashlib.sha256()
-        sha.update(self.payload)
+        sha.update(signed)
         digest = sha.digest()
 
         tlv.add('SHA256', digest)
+        if self.hash_block_size is not None:
+            tlv.add('SHA256_BLOCKS', signed)
 
         if key is not None:
             if public_key_format == 'hash':
@@ -405,7 +450,7 @@ class Image():
             # while `sign_digest` expects only the digest of the payload
 
             if hasattr(key, 'sign'):
-                sig = key.sign(bytes(self.payload))
+                sig = key.sign(signed)
             else:
                 sig = key.sign_digest(digest)
             tlv.add(key.sig_tlv(), sig)
@@ -416,8 +461,6 @@ class Image():
             self.payload = self.payload[:protected_tlv_off]
 
         if enckey is not None:
-            plainkey = os.urandom(16)
-
             if isinstance(enckey, rsa.RSAPublic):
                 cipherkey = enckey._get_public().encrypt(
                     plainkey, padding.OAEP(
@@ -449,6 +492,37 @@ class Image():
 
         self.check_trailer()
 
+    @staticmethod
+    def hash_blocks(payload, block_size, endian):
+        """Return the block size followed by the SHA256 of each block of
+        the payload, the contents of the SHA256_BLOCKS TLV."""
+        e = STRUCT_ENDIAN_DICT[endian]
+        blocks = bytearray(struct.pack(e + 'I', block_size))
+        for off in range(0, len(payload), block_size):
+            blocks += hashlib.sha256(payload[off:off+block_size]).digest()
+        return bytes(blocks)
+
+    @staticmethod
+    def aead_tlv(plainkey, img):
+        """Return the ENC_AEAD TLV of a plain payload: the key check value
+        of the image key, the AES-CMAC of the encrypted payload and the
+        SHA256 of the plain payload."""
+        def aes_cmac(key, data):
+            c = cmac.CMAC(algorithms.AES(key), backend=default_backend())
+            c.update(data)
+            return c.finalize()
+
+        nonce = bytes([0] * 16)
+        cipher = Cipher(algorithms.AES(plainkey), modes.CTR(nonce),
+                        backend=default_backend())
+        encryptor = cipher.encryptor()
+        ciphertext = encryptor.update(img) + encryptor.finalize()
+
+        mac_key = aes_cmac(plainkey, b'MCUBOOT-AEAD-MAC')
+        kcv = aes_cmac(plainkey, b'MCUBOOT-AEAD-KCV')
+        return (kcv + aes_cmac(mac_key, ciphertext) +
+                hashlib.sha256(img).digest())
+
     def add_header(self, enckey, protected_tlv_size):
         """Install the image header."""
 
@@ -459,6 +533,10 @@ class Image():
             # Indicates that this image should be loaded into RAM
             # instead of run directly from flash.
             flags |= IMAGE_F['RAM_LOAD']
+        if self.hash_block_size is not None:
+            flags |= IMAGE_F['HASH_BLOCKS']
+        if self.aead:
+            flags |= IMAGE_F['AEAD']
 
         e = STRUCT_ENDIAN_DICT[self.endian]
         fmt = (e +
@@ -499,7 +577,12 @@ class Image():
                 raise click.BadParameter("Invalid alignment: {}".format(
                     write_size))
             m = DEFAULT_MAX_SECTORS if max_sectors is None else max_sectors
-            trailer = m * 3 * write_size  # status area
+            if self.compact_trailer:
+                # One bit per status entry, in whole MAX_ALIGN units
+                bits = MAX_ALIGN * 8
+                trailer = ((m * 3 + bits - 1) // bits) * MAX_ALIGN
+            else:
+                trailer = m * 3 * write_size  # status area
             if enckey is not None:
                 if save_enctlv:
                     # TLV saved by the bootloader is aligned
@@ -507,10 +590,20 @@ class Image():
                 else:
                     keylen = 16
                 trailer += keylen * 2  # encryption keys
-            trailer += MAX_ALIGN * 4  # image_ok/copy_done/swap_info/swap_size
+            if self.compact_trailer:
+                # swap_size/swap_info/copy_done/image_ok share one unit
+                trailer += MAX_ALIGN
+            else:
+                trailer += MAX_ALIGN * 4  # image_ok/copy_done/swap_info/swap_size
             trailer += magic_size
             return trailer
 
+    def _image_ok_off(self):
+        """Offset of image_ok from the magic, in the padding before it."""
+        if self.compact_trailer and not self.overwrite_only:
+            return -MAX_ALIGN + 6
+        return -MAX_ALIGN
+
     def pad_to(self, size):
         """Pad the image to the given size, with the given flash alignment."""
         tsize = self._trailer_size(self.align, self.max_sectors,
@@ -520,7 +613,7 @@ class Image():
         pbytes = bytearray([self.erased_val] * padding)
         pbytes += bytearray([self.erased_val] * (tsize - len(boot_magic)))
         if self.confirm and not self.overwrite_only:
-            pbytes[-MAX_ALIGN] = 0x01  # image_ok = 0x01
+            pbytes[self._image_ok_off()] = 0x01  # image_ok = 0x01
         pbytes += boot_magic
         self.payload += pbytes
 
@@ -529,27 +622,58 @@ class Image():
         with open(imgfile, "rb") as f:
             b = f.read()
 
-        magic, _, header_size, _, img_size = struct.unpack('IIHHI', b[:16])
-        version = struct.unpack('BBHI', b[20:28])
-
-        if magic != IMAGE_MAGIC:
+        # The image magic tells which endianness the image was signed with.
+        for endian in STRUCT_ENDIAN_DICT:
+            e = STRUCT_ENDIAN_DICT[endian]
+            magic, = struct.unpack(e + 'I', b[:4])
+            if magic == IMAGE_MAGIC:
+                break
+        else:
             return VerifyResult.INVALID_MAGIC, None, None
 
-        tlv_info = b[header_size+img_size:header_size+img_size+TLV_INFO_SIZE]
-        magic, tlv_tot = struct.unpack('HH', tlv_info)
+        _, header_size, prot_tlv_size, img_size, flags = \
+            struct.unpack(e + 'IHHII', b[4:20])
+        version = struct.unpack(e + 'BBHI', b[20:28])
+
+        # The protected TLVs are hashed with the image, and the others
+        # follow them.
+        prot_tlv_off = header_size + img_size
+        tlv_off = prot_tlv_off + prot_tlv_size
+        tlv_info = b[tlv_off:tlv_off+TLV_INFO_SIZE]
+        magic, tlv_tot = struct.unpack(e + 'HH', tlv_info)
         if magic != TLV_INFO_MAGIC:
             return VerifyResult.INVALID_TLV_INFO_MAGIC, None, None
 
+        tlv_end = tlv_off + tlv_tot
+        tlv_off += TLV_INFO_SIZE  # skip tlv info
+
+        payload = b[:tlv_off - TLV_INFO_SIZE]
+        if flags & IMAGE_F['AEAD']:
+            # Only the header and the protected TLVs are hashed; the payload
+            # is encrypted, and authenticated by the ENC_AEAD TLV.
+            payload = b[:header_size] + b[prot_tlv_off:tlv_off-TLV_INFO_SIZE]
+        if flags & IMAGE_F['HASH_BLOCKS']:
+            # Recompute the block hashes with the stored block size.
+            off = tlv_off
+            block_size = None
+            while off < tlv_end:
+                tlv = b[off:off+TLV_SIZE]
+                tlv_type, _, tlv_len = struct.unpack(e + 'BBH', tlv)
+                if tlv_type == TLV_VALUES["SHA256_BLOCKS"] and tlv_len >= 4:
+                    block_size, = struct.unpack(
+                        e + 'I', b[off+TLV_SIZE:off+TLV_SIZE+4])
+                off += TLV_SIZE + tlv_len
+            if not block_size:
+                return VerifyResult.INVALID_HASH, None, None
+            payload = Image.hash_blocks(payload, block_size, endian)
+
         sha = hashlib.sha256()
-        sha.update(b[:header_size+img_size])
+        sha.update(payload)
         digest = sha.digest()
 
-        tlv_off = header_size + img_size
-        tlv_end = tlv_off + tlv_tot
-        tlv_off += TLV_INFO_SIZE  # skip tlv info
         while tlv_off < tlv_end:
             tlv = b[tlv_off:tlv_off+TLV_SIZE]
-            tlv_type, _, tlv_len = struct.unpack('BBH', tlv)
+            tlv_type, _, tlv_len = struct.unpack(e + 'BBH', tlv)
             if tlv_type == TLV_VALUES["SHA256"]:
                 off = tlv_off + TLV_SIZE
                 if digest == b[off:off+tlv_len]:
@@ -560,7 +684,6 @@ class Image():
             elif key is not None and tlv_type == TLV_VALUES[key.sig_tlv()]:
                 off = tlv_off + TLV_SIZE
                 tlv_sig = b[off:off+tlv_len]
-                payload = b[:header_size+img_size]
                 try:
                     if hasattr(key, 'verify'):
                         key.verify(tlv_sig, payload)
@@ -31,6 +31,8 @@ from .rsa import RSA, RSAPublic, RSAUsageError, RSA_KEY_SIZES
 from .ecdsa import ECDSA256P1, ECDSA256P1Public, ECDSAUsageError
 from .ed25519 import Ed25519, Ed25519Public, Ed25519UsageError
 from .x25519 import X25519, X25519Public, X25519UsageError
+from .lms import LMS, LMSPublic, LMSUsageError, unarmor as lms_unarmor
+from .lms import LMS_PRIV_LABEL
 
 
 class PasswordRequired(Exception):
@@ -43,6 +45,15 @@ def load(path, passwd=None):
     """Try loading a key from the given path.  Returns None if the password wasn't specified."""
     with open(path, 'rb') as f:
         raw_pem = f.read()
+
+    # LMS keys use their own format, which the crypto library doesn't know.
+    lms_key = lms_unarmor(raw_pem)
+    if lms_key is not None:
+        label, data = lms_key
+        if label == LMS_PRIV_LABEL:
+            return LMS.from_bytes(data, path)
+        return LMSPublic.from_bytes(data)
+
     try:
         pk = serialization.load_pem_private_key(
                 raw_pem,
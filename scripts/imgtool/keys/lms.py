@@ -0,0 +1,397 @@
+"""
+LMS (RFC 8554) key management
+
+LMS is a stateful hash-based signature scheme: every signature uses a new
+one-time key, whose index is stored in the private key file. The file is
+updated before a signature is returned, and a key must never be copied or
+restored from a backup, or one-time keys would be reused.
+
+The top of the Merkle tree is cached in a file next to the private key, so
+that loading a key does not compute the whole tree, and a signature only
+computes the subtree below the cached nodes which holds its one-time key.
+
+Only SHA-256 with 32-byte hashes is supported.
+"""
+
+import base64
+import hashlib
+import os
+import struct
+import tempfile
+
+from cryptography.exceptions import InvalidSignature
+
+from .general import KeyClass
+
+LMS_PUB_LABEL = "LMS PUBLIC KEY"
+LMS_PRIV_LABEL = "LMS PRIVATE KEY"
+
+# LMS type: tree height.
+LMS_TYPES = {
+    5: 5,  # LMS_SHA256_M32_H5
+    6: 10,  # LMS_SHA256_M32_H10
+    7: 15,  # LMS_SHA256_M32_H15
+    8: 20,  # LMS_SHA256_M32_H20
+    9: 25,  # LMS_SHA256_M32_H25
+}
+
+# LM-OTS type: (w, p, ls).
+LMOTS_TYPES = {
+    1: (1, 265, 7),  # LMOTS_SHA256_N32_W1
+    2: (2, 133, 6),  # LMOTS_SHA256_N32_W2
+    3: (4, 67, 4),  # LMOTS_SHA256_N32_W4
+    4: (8, 34, 0),  # LMOTS_SHA256_N32_W8
+}
+
+LMS_SHA256_M32_H10 = 6
+LMOTS_SHA256_N32_W4 = 3
+
+# The height of the subtrees computed for each signature. The tree nodes above
+# them are cached.
+SUBTREE_HEIGHT = 10
+
+N = 32
+D_PBLC = 0x8080
+D_MESG = 0x8181
+D_LEAF = 0x8282
+D_INTR = 0x8383
+
+
+class LMSUsageError(Exception):
+    pass
+
+
+def _h(*parts):
+    sha = hashlib.sha256()
+    for part in parts:
+        sha.update(part)
+    return sha.digest()
+
+
+def _u32(x):
+    return struct.pack('>I', x)
+
+
+def _u16(x):
+    return struct.pack('>H', x)
+
+
+def _coef(s, i, w):
+    return ((1 << w) - 1) & (s[i * w // 8] >> (8 - (w * (i % (8 // w)) + w)))
+
+
+def _cksm(s, w, ls):
+    total = 0
+    for i in range(N * 8 // w):
+        total += (1 << w) - 1 - _coef(s, i, w)
+    return _u16(total << ls)
+
+
+def _write_atomic(path, data):
+    """Replace the contents of a file, so that it holds either the old or the
+    new contents whatever happens, and the new ones are on disk on return."""
+    path = os.path.abspath(path)
+    fd, tmp = tempfile.mkstemp(dir=os.path.dirname(path),
+                               prefix=os.path.basename(path) + '.')
+    try:
+        with os.fdopen(fd, 'wb') as f:
+            f.write(data)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(tmp, path)
+    except BaseException:
+        if os.path.exists(tmp):
+            os.remove(tmp)
+        raise
+    if hasattr(os, 'O_DIRECTORY'):
+        # Make the rename itself durable.
+        dirfd = os.open(os.path.dirname(path), os.O_RDONLY | os.O_DIRECTORY)
+        try:
+            os.fsync(dirfd)
+        finally:
+            os.close(dirfd)
+
+
+def _armor(label, data):
+    b64 = base64.encodebytes(data).decode('ascii')
+    return "-----BEGIN {0}-----\n{1}-----END {0}-----\n".format(
+        label, b64).encode('ascii')
+
+
+def unarmor(raw):
+    """Return the label and the contents of an LMS key file, or None if it
+    is not one."""
+    text = raw.decode('ascii', errors='replace').strip()
+    for label in (LMS_PUB_LABEL, LMS_PRIV_LABEL):
+        begin = "-----BEGIN {}-----".format(label)
+        end = "-----END {}-----".format(label)
+        if text.startswith(begin) and text.endswith(end):
+            body = text[len(begin):-len(end)]
+            return label, base64.b64decode(body)
+    return None
+
+
+def _lmots_verify_key(ident, q, otstype, sig, message):
+    """Compute the candidate LM-OTS public key from a signature (RFC 8554,
+    algorithm 4b)."""
+    w, p, ls = LMOTS_TYPES[otstype]
+    c = sig[4:4+N]
+    y = sig[4+N:]
+    q_hash = _h(ident, _u32(q), _u16(D_MESG), c, message)
+    s = q_hash + _cksm(q_hash, w, ls)
+    z = []
+    for i in range(p):
+        tmp = y[i*N:(i+1)*N]
+        for j in range(_coef(s, i, w), (1 << w) - 1):
+            tmp = _h(ident, _u32(q), _u16(i), bytes([j]), tmp)
+        z.append(tmp)
+    return _h(ident, _u32(q), _u16(D_PBLC), *z)
+
+
+class LMSPublic(KeyClass):
+    def __init__(self, lms_type, otstype, ident, root):
+        if lms_type not in LMS_TYPES or otstype not in LMOTS_TYPES:
+            raise LMSUsageError("Unsupported LMS parameters")
+        self.lms_type = lms_type
+        self.otstype = otstype
+        self.ident = ident
+        self.root = root
+
+    @staticmethod
+    def from_bytes(data):
+        if len(data) != 8 + 16 + N:
+            raise LMSUsageError("Invalid LMS public key")
+        lms_type, otstype = struct.unpack('>II', data[:8])
+        return LMSPublic(lms_type, otstype, data[8:24], data[24:])
+
+    def shortname(self):
+        return "lms"
+
+    def _unsupported(self, name):
+        raise LMSUsageError("Operation {} requires private key".format(name))
+
+    def get_public_bytes(self):
+        # The key is embedded into MCUboot in the raw RFC 8554 format.
+        return (_u32(self.lms_type) + _u32(self.otstype) + self.ident +
+                self.root)
+
+    def get_private_bytes(self, minimal):
+        self._unsupported('get_private_bytes')
+
+    def export_private(self, path, passwd=None):
+        self._unsupported('export_private')
+
+    def export_public(self, path):
+        """Write the public key to the given file."""
+        with open(path, 'wb') as f:
+            f.write(_armor(LMS_PUB_LABEL, self.get_public_bytes()))
+
+    def sig_type(self):
+        return "LMS_SHA256"
+
+    def sig_tlv(self):
+        return "LMS"
+
+    def sig_len(self):
+        _, p, _ = LMOTS_TYPES[self.otstype]
+        return 4 + 4 + N + p * N + 4 + LMS_TYPES[self.lms_type] * N
+
+    def verify_digest(self, signature, digest):
+        """Verify that signature is valid for given digest"""
+        h = LMS_TYPES[self.lms_type]
+        if len(signature) != self.sig_len():
+            raise InvalidSignature()
+        q, otstype = struct.unpack('>II', signature[:8])
+        ots_len = 4 + N + LMOTS_TYPES[self.otstype][1] * N
+        lms_type, = struct.unpack(
+            '>I', signature[4+ots_len:4+ots_len+4])
+        if (q >= (1 << h) or otstype != self.otstype or
+                lms_type != self.lms_type):
+            raise InvalidSignature()
+        kc = _lmots_verify_key(self.ident, q, otstype,
+                               signature[4:4+ots_len], digest)
+        path = signature[4+ots_len+4:]
+        node = (1 << h) + q
+        tmp = _h(self.ident, _u32(node), _u16(D_LEAF), kc)
+        for i in range(h):
+            sibling = path[i*N:(i+1)*N]
+            if node & 1:
+                tmp = _h(self.ident, _u32(node // 2), _u16(D_INTR),
+                         sibling, tmp)
+            else:
+                tmp = _h(self.ident, _u32(node // 2), _u16(D_INTR),
+                         tmp, sibling)
+            node //= 2
+        if tmp != self.root:
+            raise InvalidSignature()
+
+
+class LMS(LMSPublic):
+    """
+    LMS private key: the parameters, the tree identifier, the seed from which
+    the one-time keys are derived and the index of the next one-time key.
+    """
+
+    def __init__(self, lms_type, otstype, ident, seed, q, path=None):
+        if lms_type not in LMS_TYPES or otstype not in LMOTS_TYPES:
+            raise LMSUsageError("Unsupported LMS parameters")
+        self.seed = seed
+        self.q = q
+        self.path = path
+        self.lms_type = lms_type
+        self.otstype = otstype
+        self.ident = ident
+        self._top = None
+
+    @property
+    def root(self):
+        return self._top_nodes()[1]
+
+    @staticmethod
+    def generate(lms_type=LMS_SHA256_M32_H10, otstype=LMOTS_SHA256_N32_W4):
+        return LMS(lms_type, otstype, os.urandom(16), os.urandom(N), 0)
+
+    @staticmethod
+    def from_bytes(data, path=None):
+        if len(data) != 8 + 16 + N + 4:
+            raise LMSUsageError("Invalid LMS private key")
+        lms_type, otstype = struct.unpack('>II', data[:8])
+        q, = struct.unpack('>I', data[-4:])
+        return LMS(lms_type, otstype, data[8:24], data[24:24+N], q, path)
+
+    def _private_bytes(self):
+        return (_u32(self.lms_type) + _u32(self.otstype) + self.ident +
+                self.seed + _u32(self.q))
+
+    def _ots_private(self, q, i):
+        # RFC 8554, appendix A.
+        return _h(self.ident, _u32(q), _u16(i), b'\xff', self.seed)
+
+    def _ots_public(self, q):
+        w, p, _ = LMOTS_TYPES[self.otstype]
+        y = []
+        for i in range(p):
+            tmp = self._ots_private(q, i)
+            for j in range((1 << w) - 1):
+                tmp = _h(self.ident, _u32(q), _u16(i), bytes([j]), tmp)
+            y.append(tmp)
+        return _h(self.ident, _u32(q), _u16(D_PBLC), *y)
+
+    def _top_height(self):
+        """Return the depth of the roots of the subtrees computed for each
+        signature, the lowest level of cached nodes."""
+        return max(LMS_TYPES[self.lms_type] - SUBTREE_HEIGHT, 0)
+
+    def _subtree(self, r):
+        """Return the nodes of the subtree rooted at node r, by node
+        number."""
+        h = LMS_TYPES[self.lms_type]
+        height = h - (r.bit_length() - 1)
+        nodes = {}
+        for node in range(r << height, (r + 1) << height):
+            nodes[node] = _h(self.ident, _u32(node), _u16(D_LEAF),
+                             self._ots_public(node - (1 << h)))
+        for level in range(height - 1, -1, -1):
+            for node in range(r << level, (r + 1) << level):
+                nodes[node] = _h(self.ident, _u32(node), _u16(D_INTR),
+                                 nodes[2*node], nodes[2*node+1])
+        return nodes
+
+    def _cache_path(self):
+        return self.path + '.tree'
+
+    def _cache_check(self, nodes):
+        # Binds the cache to the secret seed, so that a damaged or foreign
+        # cache is never used.
+        return _h(self._private_bytes()[:-4], *nodes)
+
+    def _read_cache(self, count):
+        if self.path is None:
+            return None
+        try:
+            with open(self._cache_path(), 'rb') as f:
+                data = f.read()
+        except OSError:
+            return None
+        if len(data) != (count + 1) * N:
+            return None
+        nodes = [data[i*N:(i+1)*N] for i in range(count)]
+        if data[count*N:] != self._cache_check(nodes):
+            return None
+        return [None] + nodes
+
+    def _top_nodes(self):
+        """Return the nodes of the tree down to the subtree roots, indexed
+        by node number, from the cache if it is valid."""
+        if self._top is not None:
+            return self._top
+        t = self._top_height()
+        self._top = self._read_cache((2 << t) - 1)
+        if self._top is None:
+            top = [None] * (2 << t)
+            for r in range(1 << t, 2 << t):
+                top[r] = self._subtree(r)[r]
+            for r in range((1 << t) - 1, 0, -1):
+                top[r] = _h(self.ident, _u32(r), _u16(D_INTR),
+                            top[2*r], top[2*r+1])
+            self._top = top
+            self._write_cache()
+        return self._top
+
+    def _write_cache(self):
+        if self.path is None or self._top is None:
+            return
+        nodes = self._top[1:]
+        _write_atomic(self._cache_path(),
+                      b''.join(nodes) + self._cache_check(nodes))
+
+    def get_private_bytes(self, minimal):
+        raise LMSUsageError("Operation not supported with {} keys".format(
+            self.shortname()))
+
+    def export_private(self, path, passwd=None):
+        """Write the private key to the given file. Password protection is
+        not supported."""
+        if passwd is not None:
+            raise LMSUsageError("LMS keys cannot be password protected")
+        _write_atomic(path, _armor(LMS_PRIV_LABEL, self._private_bytes()))
+        if path != self.path:
+            self.path = path
+            self._write_cache()
+
+    def sign_digest(self, digest):
+        """Return the signature of the digest with the next one-time key.
+        The private key file is updated first."""
+        w, p, ls = LMOTS_TYPES[self.otstype]
+        h = LMS_TYPES[self.lms_type]
+        q = self.q
+        if q >= (1 << h):
+            raise LMSUsageError("All the one-time keys have been used")
+        if self.path is None:
+            raise LMSUsageError("The key state cannot be saved")
+        self.q += 1
+        self.export_private(self.path)
+
+        c = os.urandom(N)
+        q_hash = _h(self.ident, _u32(q), _u16(D_MESG), c, digest)
+        s = q_hash + _cksm(q_hash, w, ls)
+        y = bytearray()
+        for i in range(p):
+            tmp = self._ots_private(q, i)
+            for j in range(_coef(s, i, w)):
+                tmp = _h(self.ident, _u32(q), _u16(i), bytes([j]), tmp)
+            y += tmp
+
+        # The siblings below the cached nodes come from the subtree of the
+        # one-time key, the others from the cache.
+        node = (1 << h) + q
+        k = h - self._top_height()
+        subtree = self._subtree(node >> k)
+        top = self._top_nodes()
+        path = bytearray()
+        for i in range(h):
+            sibling = (node >> i) ^ 1
+            path += subtree[sibling] if i < k else top[sibling]
+
+        return (_u32(q) + _u32(self.otstype) + c + bytes(y) +
+                _u32(self.lms_type) + bytes(path))
@@ -0,0 +1,185 @@
+"""
+Tests for LMS keys
+"""
+
+import hashlib
+import io
+import os.path
+import re
+import shutil
+import sys
+import tempfile
+import unittest
+from unittest import mock
+
+from cryptography.exceptions import InvalidSignature
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '../..')))
+
+from imgtool.keys import load, LMS, LMSPublic, LMSUsageError
+from imgtool.keys import lms
+
+TOP_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__),
+                                       '../../..'))
+
+# The smallest tree and the fastest one-time keys, to keep the tests quick.
+LMS_SHA256_M32_H5 = 5
+LMOTS_SHA256_N32_W8 = 4
+
+
+class LMSKeyGeneration(unittest.TestCase):
+
+    def setUp(self):
+        self.test_dir = tempfile.TemporaryDirectory()
+
+    def tname(self, base):
+        return os.path.join(self.test_dir.name, base)
+
+    def tearDown(self):
+        self.test_dir.cleanup()
+
+    def generate(self, name):
+        k = LMS.generate(LMS_SHA256_M32_H5, LMOTS_SHA256_N32_W8)
+        k.export_private(name)
+        return k
+
+    def test_keygen(self):
+        name1 = self.tname("keygen.pem")
+        k = self.generate(name1)
+
+        self.assertRaises(LMSUsageError,
+                          k.export_private, self.tname("pw.pem"), b'secret')
+
+        k2 = load(name1)
+        self.assertIsInstance(k2, LMS)
+        self.assertEqual(k.get_public_bytes(), k2.get_public_bytes())
+
+        pubname = self.tname('keygen-pub.pem')
+        k2.export_public(pubname)
+        pk2 = load(pubname)
+        self.assertIsInstance(pk2, LMSPublic)
+        self.assertEqual(k.get_public_bytes(), pk2.get_public_bytes())
+
+        # We should be able to export the public key from the loaded
+        # public key, but not the private key.
+        pk2.export_public(self.tname('keygen-pub2.pem'))
+        self.assertRaises(LMSUsageError,
+                          pk2.export_private, self.tname('keygen-priv2.pem'))
+
+    def test_emit(self):
+        """Basic sanity check on the code emitters."""
+        k = LMS.generate(LMS_SHA256_M32_H5, LMOTS_SHA256_N32_W8)
+
+        ccode = io.StringIO()
+        k.emit_c_public(ccode)
+        self.assertIn("lms_pub_key", ccode.getvalue())
+        self.assertIn("lms_pub_key_len", ccode.getvalue())
+
+        rustcode = io.StringIO()
+        k.emit_rust_public(rustcode)
+        self.assertIn("LMS_PUB_KEY", rustcode.getvalue())
+
+    def test_sig(self):
+        name = self.tname("sig.pem")
+        k = self.generate(name)
+        digest = hashlib.sha256(b'This is the message').digest()
+
+        sig = k.sign_digest(digest)
+        self.assertEqual(len(sig), k.sig_len())
+        k.verify_digest(sig, digest)
+
+        # The state is saved before the signature is returned, so a reload
+        # moves on to the next one-time key.
+        k2 = load(name)
+        sig2 = k2.sign_digest(digest)
+        self.assertNotEqual(sig[:4], sig2[:4])
+        k.verify_digest(sig2, digest)
+
+        # Modify the message to make sure the signature fails.
+        self.assertRaises(InvalidSignature,
+                          k.verify_digest,
+                          sig,
+                          hashlib.sha256(b'This is thE message').digest())
+
+        # Modify the signature to make sure it fails.
+        for pos in (4, 8, len(sig) - 1):
+            bad = bytearray(sig)
+            bad[pos] ^= 0x01
+            self.assertRaises(InvalidSignature,
+                              k.verify_digest, bytes(bad), digest)
+
+    def test_export_atomic(self):
+        name = self.tname("atomic.pem")
+        k = self.generate(name)
+        self.assertEqual(os.listdir(self.test_dir.name), ["atomic.pem"])
+
+        # A failed write leaves the saved state alone.
+        with open(name, 'rb') as f:
+            saved = f.read()
+        with mock.patch('os.replace', side_effect=OSError):
+            self.assertRaises(OSError, k.export_private, name)
+        with open(name, 'rb') as f:
+            self.assertEqual(f.read(), saved)
+        self.assertEqual(os.listdir(self.test_dir.name), ["atomic.pem"])
+
+        # Nor is a signature released if its state can't be saved.
+        digest = hashlib.sha256(b'This is the message').digest()
+        with mock.patch('os.replace', side_effect=OSError):
+            self.assertRaises(OSError, k.sign_digest, digest)
+        self.assertEqual(load(name).q, 0)
+
+    def test_tree_cache(self):
+        # Small subtrees, so that the signatures combine them with the
+        # cached nodes.
+        with mock.patch.object(lms, 'SUBTREE_HEIGHT', 2):
+            name = self.tname("cache.pem")
+            k = self.generate(name)
+            pub = k.get_public_bytes()
+            self.assertTrue(os.path.exists(name + '.tree'))
+
+            # The cached nodes give the public key without recomputing the
+            # tree, and signatures which check out.
+            with mock.patch.object(LMS, '_subtree',
+                                   side_effect=AssertionError):
+                k2 = load(name)
+                self.assertEqual(k2.get_public_bytes(), pub)
+            digest = hashlib.sha256(b'This is the message').digest()
+            for _ in range(5):
+                k2.verify_digest(k2.sign_digest(digest), digest)
+
+            # A damaged cache is recomputed.
+            with open(name + '.tree', 'r+b') as f:
+                f.write(b'\0')
+            self.assertEqual(load(name).get_public_bytes(), pub)
+
+    def test_dev_key(self):
+        # The development key is tracked, so it is used from a copy, which
+        # is the one whose state moves on.
+        dev_key = os.path.join(TOP_DIR, 'root-lms.pem')
+        with open(dev_key, 'rb') as f:
+            saved = f.read()
+        name = self.tname("root-lms.pem")
+        shutil.copyfile(dev_key, name)
+
+        k = load(name)
+        digest = hashlib.sha256(b'This is the message').digest()
+        k.verify_digest(k.sign_digest(digest), digest)
+        self.assertEqual(load(name).q, 1)
+        with open(dev_key, 'rb') as f:
+            self.assertEqual(f.read(), saved)
+
+        # It matches the public key the simulator checks its images with.
+        with open(os.path.join(TOP_DIR, 'sim/src/lms_pub_key-rs.txt')) as f:
+            sim_pub = bytes(int(x, 16) for x in
+                            re.findall(r'0x([0-9a-f]{2})', f.read()))
+        self.assertEqual(k.get_public_bytes(), sim_pub)
+
+    def test_exhausted(self):
+        k = self.generate(self.tname("exhausted.pem"))
+        digest = hashlib.sha256(b'This is the message').digest()
+        k.q = 1 << 5
+        self.assertRaises(LMSUsageError, k.sign_digest, digest)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -23,7 +23,8 @@ import sys
 from imgtool import image, imgtool_version
 from imgtool.version import decode_version
 from .keys import (
-    RSAUsageError, ECDSAUsageError, Ed25519UsageError, X25519UsageError)
+    RSAUsageError, ECDSAUsageError, Ed25519UsageError, X25519UsageError,
+    LMSUsageError)
 
 MIN_PYTHON_VERSION = (3, 6)
 if sys.version_info < MIN_PYTHON_VERSION:
@@ -56,6 +57,12 @@ def gen_x25519(keyfile, passwd):
     keys.X25519.generate().export_private(path=keyfile, passwd=passwd)
 
 
+def gen_lms(keyfile, passwd):
+    if passwd is not None:
+        raise click.UsageError("LMS keys cannot be password protected")
+    keys.LMS.generate().export_private(path=keyfile)
+
+
 valid_langs = ['c', 'rust']
 keygens = {
     'rsa-2048':   gen_rsa2048,
@@ -64,6 +71,7 @@ keygens = {
     'ecdsa-p224': gen_ecdsa_p224,
     'ed25519':    gen_ed25519,
     'x25519':     gen_x25519,
+    'lms':        gen_lms,
 }
 
 
@@ -131,7 +139,7 @@ def getpriv(key, minimal):
     try:
         key.emit_private(minimal)
     except (RSAUsageError, ECDSAUsageError, Ed25519UsageError,
-            X25519UsageError) as e:
+            X25519UsageError, LMSUsageError) as e:
         raise click.UsageError(e)
 
 
@@ -232,6 +240,14 @@ class BasedIntParamType(click.ParamType):
                    'Add "0x" prefix if the value should be interpreted as an '
                    'integer, otherwise it will be interpreted as a string. '
                    'Specify the option multiple times to add multiple TLVs.')
+@click.option('--hash-block-size', type=BasedIntParamType(), required=False,
+              help='Hash the image in blocks of this many bytes (e.g. the '
+                   'sector size) so that it can be verified block by block. '
+                   'Requires MCUBOOT_HASH_BLOCKS in the bootloader.')
+@click.option('--aead', default=False, is_flag=True,
+              help='Authenticate the encrypted payload with AES-CMAC, so that '
+                   'it is checked without decrypting it (requires --encrypt '
+                   'and MCUBOOT_ENC_AEAD in the bootloader).')
 @click.option('-R', '--erased-val', type=click.Choice(['0', '0xff']),
               required=False,
               help='The value that is read back from erased flash.')
@@ -265,6 +281,13 @@ class BasedIntParamType(click.ParamType):
 @click.option('-S', '--slot-size', type=BasedIntParamType(), required=True,
               help='Size of the slot. If the slots have different sizes, use '
               'the size of the secondary slot.')
+@click.option('--slot-offset', type=BasedIntParamType(), default=0,
+              help='Offset of the image in the slot, for swap using offset: '
+                   'the size of the first sector of the secondary slot. '
+                   'Padding keeps the trailer at the end of the slot.')
+@click.option('--compact-trailer', default=False, is_flag=True,
+              help='Size the trailer for a bootloader built with the compact '
+                   'trailer (MCUBOOT_TRAILER_COMPACT)')
 @click.option('--pad-header', default=False, is_flag=True,
               help='Add --header-size zeroed bytes at the beginning of the '
                    'image')
@@ -290,9 +313,18 @@ class BasedIntParamType(click.ParamType):
                INFILE and OUTFILE are parsed as Intel HEX if the params have
                .hex extension, otherwise binary format is used''')
 def sign(key, public_key_format, align, version, pad_sig, header_size,
-         pad_header, slot_size, pad, confirm, max_sectors, overwrite_only,
+         pad_header, slot_size, slot_offset, compact_trailer, pad, confirm, max_sectors, overwrite_only,
          endian, encrypt, infile, outfile, dependencies, load_addr, hex_addr,
-         erased_val, save_enctlv, security_counter, boot_record, custom_tlv):
+         erased_val, save_enctlv, security_counter, boot_record, custom_tlv,
+         hash_block_size, aead):
+
+    if hash_block_size is not None and hash_block_size <= 0:
+        raise click.BadParameter("Invalid hash block size: {}".format(
+            hash_block_size))
+
+    if slot_offset < 0 or slot_offset >= slot_size:
+        raise click.BadParameter("Invalid slot offset: {}".format(
+            slot_offset))
 
     if confirm:
         # Confirmed but non-padded images don't make much sense, because
@@ -301,10 +333,12 @@ def sign(key, public_key_format, align, version, pad_sig, header_size,
     img = image.Image(version=decode_version(version), header_size=header_size,
                       pad_header=pad_header, pad=pad, confirm=confirm,
                       align=int(align), slot_size=slot_size,
+                      slot_offset=slot_offset, compact_trailer=compact_trailer,
                       max_sectors=max_sectors, overwrite_only=overwrite_only,
                       endian=endian, load_addr=load_addr, erased_val=erased_val,
                       save_enctlv=save_enctlv,
-                      security_counter=security_counter)
+                      security_counter=security_counter,
+                      hash_block_size=hash_block_size, aead=aead)
     img.load(infile)
     key = load_key(key) if key else None
     enckey = load_key(encrypt) if encrypt else None
@@ -338,8 +372,11 @@ def sign(key, public_key_format, align, version, pad_sig, header_size,
         else:
             custom_tlvs[tag] = value.encode('utf-8')
 
-    img.create(key, public_key_format, enckey, dependencies, boot_record,
-               custom_tlvs)
+    try:
+        img.create(key, public_key_format, enckey, dependencies, boot_record,
+                   custom_tlvs)
+    except LMSUsageError as e:
+        raise click.UsageError(e)
     img.save(outfile, hex_addr)
 
 
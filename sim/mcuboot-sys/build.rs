@@ -13,17 +13,31 @@ fn main() {
     let sig_rsa3072 = env::var("CARGO_FEATURE_SIG_RSA3072").is_ok();
     let sig_ecdsa = env::var("CARGO_FEATURE_SIG_ECDSA").is_ok();
     let sig_ed25519 = env::var("CARGO_FEATURE_SIG_ED25519").is_ok();
+    let sig_lms = env::var("CARGO_FEATURE_SIG_LMS").is_ok();
     let overwrite_only = env::var("CARGO_FEATURE_OVERWRITE_ONLY").is_ok();
     let swap_move = env::var("CARGO_FEATURE_SWAP_MOVE").is_ok();
+    let swap_offset = env::var("CARGO_FEATURE_SWAP_OFFSET").is_ok();
+    let compact_trailer = env::var("CARGO_FEATURE_COMPACT_TRAILER").is_ok();
+    let staged_boot = env::var("CARGO_FEATURE_STAGED_BOOT").is_ok();
+    let erase_skip_erased = env::var("CARGO_FEATURE_ERASE_SKIP_ERASED").is_ok();
+    let direct_xip = env::var("CARGO_FEATURE_DIRECT_XIP").is_ok();
+    let multi_slot = env::var("CARGO_FEATURE_MULTI_SLOT").is_ok();
+    let boot_attempts = env::var("CARGO_FEATURE_BOOT_ATTEMPTS").is_ok();
+    let warm_boot = env::var("CARGO_FEATURE_WARM_BOOT").is_ok();
     let validate_primary_slot =
                   env::var("CARGO_FEATURE_VALIDATE_PRIMARY_SLOT").is_ok();
     let enc_rsa = env::var("CARGO_FEATURE_ENC_RSA").is_ok();
     let enc_kw = env::var("CARGO_FEATURE_ENC_KW").is_ok();
     let enc_ec256 = env::var("CARGO_FEATURE_ENC_EC256").is_ok();
     let enc_x25519 = env::var("CARGO_FEATURE_ENC_X25519").is_ok();
+    let enc_aead = env::var("CARGO_FEATURE_ENC_AEAD").is_ok();
     let bootstrap = env::var("CARGO_FEATURE_BOOTSTRAP").is_ok();
     let multiimage = env::var("CARGO_FEATURE_MULTIIMAGE").is_ok();
     let downgrade_prevention = env::var("CARGO_FEATURE_DOWNGRADE_PREVENTION").is_ok();
+    let flash_cache = env::var("CARGO_FEATURE_FLASH_CACHE").is_ok();
+    let hash_blocks = env::var("CARGO_FEATURE_HASH_BLOCKS").is_ok();
+    let ram_report = env::var("CARGO_FEATURE_RAM_REPORT").is_ok();
+    let cypress_qspi = env::var("CARGO_FEATURE_CYPRESS_QSPI").is_ok();
 
     let mut conf = cc::Build::new();
     conf.define("__BOOTSIM__", None);
@@ -50,8 +64,33 @@ fn main() {
         conf.define("MCUBOOT_DOWNGRADE_PREVENTION", None);
     }
 
+    if flash_cache {
+        conf.define("MCUBOOT_FLASH_CACHE", None);
+        // Small pages, so that the cache is exercised by the test images.
+        conf.define("MCUBOOT_FLASH_CACHE_PAGE_SIZE", Some("64"));
+        conf.define("MCUBOOT_FLASH_CACHE_PAGES", Some("4"));
+    }
+
+    if hash_blocks {
+        conf.define("MCUBOOT_HASH_BLOCKS", None);
+    }
+
+    if enc_aead {
+        if !(enc_rsa || enc_kw || enc_ec256 || enc_x25519) {
+            panic!("enc-aead requires one of the enc-* features");
+        }
+        if hash_blocks {
+            panic!("enc-aead images are not hashed in blocks");
+        }
+        conf.define("MCUBOOT_ENC_AEAD", None);
+    }
+
+    if ram_report {
+        conf.define("SIM_RAM_REPORT", None);
+    }
+
     // Currently no more than one sig type can be used simultaneously.
-    if vec![sig_rsa, sig_rsa3072, sig_ecdsa, sig_ed25519].iter()
+    if vec![sig_rsa, sig_rsa3072, sig_ecdsa, sig_ed25519, sig_lms].iter()
         .fold(0, |sum, &v| sum + v as i32) > 1 {
         panic!("mcuboot does not support more than one sig type at the same time");
     }
@@ -111,6 +150,14 @@ fn main() {
         conf.file("../../ext/fiat/src/curve25519.c");
         conf.file("../../ext/mbedtls-asn1/src/platform_util.c");
         conf.file("../../ext/mbedtls-asn1/src/asn1parse.c");
+    } else if sig_lms {
+        conf.define("MCUBOOT_SIGN_LMS", None);
+        conf.define("MCUBOOT_USE_TINYCRYPT", None);
+
+        conf.include("../../ext/tinycrypt/lib/include");
+        conf.file("../../ext/tinycrypt/lib/source/sha256.c");
+        conf.file("../../ext/tinycrypt/lib/source/utils.c");
+        conf.file("csupport/keys.c");
     } else if !enc_ec256 && !enc_x25519 {
         // No signature type, only sha256 validation. The default
         // configuration file bundled with mbedTLS is sufficient.
@@ -128,6 +175,51 @@ fn main() {
         conf.define("MCUBOOT_SWAP_USING_MOVE", None);
     }
 
+    if swap_offset {
+        conf.define("MCUBOOT_SWAP_USING_OFFSET", None);
+    }
+
+    if compact_trailer {
+        conf.define("MCUBOOT_TRAILER_COMPACT", None);
+    }
+
+    if staged_boot {
+        // Image 1 is checked after the handoff.
+        conf.define("MCUBOOT_STAGED_BOOT", None);
+        conf.define("MCUBOOT_DEFERRED_IMAGES", Some("0x2"));
+    }
+
+    if erase_skip_erased {
+        conf.define("MCUBOOT_ERASE_SKIP_ERASED", None);
+    }
+
+    if direct_xip {
+        if multiimage || overwrite_only || swap_move || swap_offset ||
+            enc_rsa || enc_kw || enc_ec256 || enc_x25519 {
+            panic!("direct-xip boots a single, unencrypted image in place");
+        }
+        conf.define("MCUBOOT_DIRECT_XIP", None);
+        conf.define("MCUBOOT_DIRECT_XIP_REVERT", None);
+    }
+
+    if multi_slot {
+        // The scratch area is the third slot.
+        conf.define("MCUBOOT_NUM_SLOTS", Some("3"));
+    }
+
+    if boot_attempts {
+        conf.define("MCUBOOT_BOOT_ATTEMPTS", Some("3"));
+    }
+
+    if warm_boot {
+        if direct_xip {
+            panic!("warm-boot records the decision of a swap or overwrite boot");
+        }
+        conf.define("MCUBOOT_WARM_BOOT", None);
+        conf.file("../../boot/bootutil/src/warm_boot.c");
+        conf.file("../../boot/bootutil/src/crc32c.c");
+    }
+
     if enc_rsa {
         conf.define("MCUBOOT_ENCRYPT_RSA", None);
         conf.define("MCUBOOT_ENC_IMAGES", None);
@@ -262,14 +354,20 @@ fn main() {
         conf.file("../../boot/bootutil/src/image_ec256.c");
     } else if sig_ed25519 {
         conf.file("../../boot/bootutil/src/image_ed25519.c");
+    } else if sig_lms {
+        conf.file("../../boot/bootutil/src/image_lms.c");
     }
     conf.file("../../boot/bootutil/src/loader.c");
     conf.file("../../boot/bootutil/src/swap_misc.c");
     conf.file("../../boot/bootutil/src/swap_scratch.c");
     conf.file("../../boot/bootutil/src/swap_move.c");
+    conf.file("../../boot/bootutil/src/swap_offset.c");
     conf.file("../../boot/bootutil/src/caps.c");
     conf.file("../../boot/bootutil/src/bootutil_misc.c");
+    conf.file("../../boot/bootutil/src/prestage.c");
     conf.file("../../boot/bootutil/src/tlv.c");
+    conf.file("../../boot/bootutil/src/security_cnt_cache.c");
+    conf.file("../../boot/bootutil/src/flash_cache.c");
     conf.file("../../boot/bootutil/src/fault_injection_hardening.c");
     conf.file("csupport/run.c");
     conf.include("../../boot/bootutil/include");
@@ -286,6 +384,24 @@ fn main() {
 
     conf.compile("libbootutil.a");
 
+    if cypress_qspi {
+        let mut qspi = cc::Build::new();
+        qspi.define("PSOC_064_2M", None);
+        qspi.define("CY_BOOT_SFDP_CACHE_ADDR", Some("((uintptr_t)cy_model_sfdp_cache_row)"));
+        qspi.file("../../boot/cypress/cy_flash_pal/flash_qspi/flash_qspi.c");
+        qspi.file("../../boot/cypress/cy_flash_pal/cy_smif_psoc6.c");
+        qspi.file("csupport/cy_pdl/cy_pdl_model.c");
+        qspi.include("csupport/cy_pdl");
+        qspi.include("../../boot/cypress/cy_flash_pal/flash_qspi");
+        qspi.include("../../boot/cypress/cy_flash_pal/include");
+        qspi.include("../../boot/cypress/MCUBootApp");
+        qspi.debug(true);
+        qspi.flag("-Wall");
+        qspi.flag("-Werror");
+        qspi.flag("-std=c99");
+        qspi.compile("libcyqspi.a");
+    }
+
     walk_dir("../../boot").unwrap();
     walk_dir("../../ext/tinycrypt/lib/source").unwrap();
     walk_dir("../../ext/mbedtls-asn1").unwrap();
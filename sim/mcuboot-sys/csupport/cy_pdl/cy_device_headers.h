@@ -0,0 +1,7 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The PDL model has everything in cy_pdl.h.
+ */
+
+#include "cy_pdl.h"
@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host model of the parts of the Cypress PDL used by
+ * boot/cypress/cy_flash_pal/flash_qspi and cy_smif_psoc6.c, so that the QSPI
+ * initialization, with its SFDP cache, and the external flash erase can run
+ * in the simulator. The types and names follow the PDL, but only the fields
+ * and calls that these files use are present. The GPIO, clock and interrupt
+ * calls do nothing, the SMIF calls are modelled in cy_pdl_model.c.
+ */
+
+#ifndef H_CY_PDL_MODEL_
+#define H_CY_PDL_MODEL_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct { uint32_t unused; } GPIO_PRT_Type;
+typedef struct { uint32_t unused; } SMIF_Type;
+
+extern GPIO_PRT_Type cy_model_gpio_prt[2];
+extern SMIF_Type cy_model_smif0;
+
+#define GPIO_PRT11                  (&cy_model_gpio_prt[0])
+#define GPIO_PRT12                  (&cy_model_gpio_prt[1])
+#define SMIF0                       (&cy_model_smif0)
+
+typedef enum
+{
+    P11_0_SMIF_SPI_SELECT2 = 26,
+    P11_1_SMIF_SPI_SELECT1 = 26,
+    P11_2_SMIF_SPI_SELECT0 = 26,
+    P11_3_SMIF_SPI_DATA3 = 26,
+    P11_4_SMIF_SPI_DATA2 = 26,
+    P11_5_SMIF_SPI_DATA1 = 26,
+    P11_6_SMIF_SPI_DATA0 = 26,
+    P11_7_SMIF_SPI_CLK = 26,
+    P12_4_SMIF_SPI_SELECT3 = 26,
+} en_hsiom_sel_t;
+
+typedef enum
+{
+    NvicMux7_IRQn = 7,
+} IRQn_Type;
+
+typedef enum
+{
+    smif_interrupt_IRQn = 2,
+} cy_en_intr_t;
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    cy_en_intr_t cm0pSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+typedef void (*cy_israddress)(void);
+
+typedef struct
+{
+    uint32_t outVal;
+    uint32_t driveMode;
+    en_hsiom_sel_t hsiom;
+    uint32_t intEdge;
+    uint32_t intMask;
+    uint32_t vtrip;
+    uint32_t slewRate;
+    uint32_t driveSel;
+    uint32_t vregEn;
+    uint32_t ibufMode;
+    uint32_t vtripSel;
+    uint32_t vrefSel;
+    uint32_t vohSel;
+} cy_stc_gpio_pin_config_t;
+
+#define CY_GPIO_DM_STRONG           6UL
+#define CY_GPIO_DM_STRONG_IN_OFF    14UL
+#define CY_GPIO_INTR_DISABLE        0UL
+#define CY_GPIO_VTRIP_CMOS          0UL
+#define CY_GPIO_SLEW_FAST           0UL
+#define CY_GPIO_DRIVE_1_2           1UL
+
+#define CY_SYSCLK_CLKHF_IN_CLKPATH0 0UL
+#define CY_SYSCLK_CLKHF_IN_CLKPATH2 2UL
+#define CY_SYSCLK_CLKHF_DIVIDE_BY_4 2UL
+
+typedef enum
+{
+    CY_SMIF_SUCCESS = 0x00U,
+    CY_SMIF_CMD_FIFO_FULL = 0x01U,
+    CY_SMIF_EXCEED_TIMEOUT = 0x02U,
+    CY_SMIF_NO_QE_BIT = 0x03U,
+    CY_SMIF_BAD_PARAM = 0x04U,
+    CY_SMIF_NO_SFDP_SUPPORT = 0x05U,
+    CY_SMIF_SFDP_SS0_FAILED = 0x08U,
+    CY_SMIF_CMD_NOT_FOUND = 0x0CU,
+} cy_en_smif_status_t;
+
+typedef enum
+{
+    CY_SMIF_WIDTH_SINGLE = 0U,
+    CY_SMIF_WIDTH_DUAL = 1U,
+    CY_SMIF_WIDTH_QUAD = 2U,
+    CY_SMIF_WIDTH_OCTAL = 3U,
+} cy_en_smif_txfr_width_t;
+
+typedef enum
+{
+    CY_SMIF_SLAVE_SELECT_0 = 1U,
+    CY_SMIF_SLAVE_SELECT_1 = 2U,
+    CY_SMIF_SLAVE_SELECT_2 = 4U,
+    CY_SMIF_SLAVE_SELECT_3 = 8U,
+} cy_en_smif_slave_select_t;
+
+typedef enum
+{
+    CY_SMIF_DATA_SEL0 = 0,
+    CY_SMIF_DATA_SEL1 = 1,
+    CY_SMIF_DATA_SEL2 = 2,
+    CY_SMIF_DATA_SEL3 = 3,
+} cy_en_smif_data_select_t;
+
+#define CY_SMIF_NORMAL                  0U
+#define CY_SMIF_SEL_INV_INTERNAL_CLK    1U
+#define CY_SMIF_BUS_ERROR               0U
+
+#define CY_SMIF_TX_NOT_LAST_BYTE        0U
+#define CY_SMIF_TX_LAST_BYTE            1U
+
+#define CY_SMIF_FLAG_MEMORY_MAPPED      (1UL << 0)
+#define CY_SMIF_FLAG_WR_EN              (1UL << 1)
+#define CY_SMIF_FLAG_DETECT_SFDP        (1UL << 2)
+
+typedef struct
+{
+    uint32_t command;
+    cy_en_smif_txfr_width_t cmdWidth;
+    cy_en_smif_txfr_width_t addrWidth;
+    uint32_t mode;
+    cy_en_smif_txfr_width_t modeWidth;
+    uint32_t dummyCycles;
+    cy_en_smif_txfr_width_t dataWidth;
+} cy_stc_smif_mem_cmd_t;
+
+typedef struct
+{
+    uint32_t numOfAddrBytes;
+    uint32_t memSize;
+    cy_stc_smif_mem_cmd_t *readCmd;
+    cy_stc_smif_mem_cmd_t *writeEnCmd;
+    cy_stc_smif_mem_cmd_t *writeDisCmd;
+    cy_stc_smif_mem_cmd_t *eraseCmd;
+    uint32_t eraseSize;
+    cy_stc_smif_mem_cmd_t *chipEraseCmd;
+    cy_stc_smif_mem_cmd_t *programCmd;
+    uint32_t programSize;
+    cy_stc_smif_mem_cmd_t *readStsRegWipCmd;
+    cy_stc_smif_mem_cmd_t *readStsRegQeCmd;
+    cy_stc_smif_mem_cmd_t *writeStsRegQeCmd;
+    cy_stc_smif_mem_cmd_t *readSfdpCmd;
+    uint32_t stsRegBusyMask;
+    uint32_t stsRegQuadEnableMask;
+    uint32_t eraseTime;
+    uint32_t chipEraseTime;
+    uint32_t programTime;
+} cy_stc_smif_mem_device_cfg_t;
+
+typedef struct
+{
+    cy_en_smif_slave_select_t slaveSelect;
+    uint32_t flags;
+    cy_en_smif_data_select_t dataSelect;
+    uint32_t baseAddress;
+    uint32_t memMappedSize;
+    uint32_t dualQuadSlots;
+    cy_stc_smif_mem_device_cfg_t *deviceCfg;
+} cy_stc_smif_mem_config_t;
+
+typedef struct
+{
+    uint32_t memCount;
+    cy_stc_smif_mem_config_t **memConfig;
+    uint32_t majorVersion;
+    uint32_t minorVersion;
+} cy_stc_smif_block_config_t;
+
+typedef struct
+{
+    uint32_t mode;
+    uint32_t deselectDelay;
+    uint32_t rxClockSel;
+    uint32_t blockEvent;
+} cy_stc_smif_config_t;
+
+typedef struct
+{
+    uint32_t timeout;
+} cy_stc_smif_context_t;
+
+void Cy_GPIO_Pin_Init(GPIO_PRT_Type *base, uint32_t pinNum,
+                      const cy_stc_gpio_pin_config_t *config);
+void Cy_GPIO_SetHSIOM(GPIO_PRT_Type *base, uint32_t pinNum,
+                      en_hsiom_sel_t value);
+void Cy_GPIO_Port_Deinit(GPIO_PRT_Type *base);
+
+void Cy_SysClk_ClkHfSetSource(uint32_t clkHf, uint32_t source);
+void Cy_SysClk_ClkHfSetDivider(uint32_t clkHf, uint32_t divider);
+void Cy_SysClk_ClkHfEnable(uint32_t clkHf);
+void Cy_SysClk_ClkHfDisable(uint32_t clkHf);
+
+void Cy_SysInt_Init(const cy_stc_sysint_t *config,
+                    cy_israddress userIsr);
+void Cy_SysInt_DisconnectInterruptSource(IRQn_Type IRQn,
+                                         cy_en_intr_t devIntrSrc);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+
+cy_en_smif_status_t Cy_SMIF_Init(SMIF_Type *base,
+                                 cy_stc_smif_config_t const *config,
+                                 uint32_t timeout,
+                                 cy_stc_smif_context_t *context);
+void Cy_SMIF_Enable(SMIF_Type *base, cy_stc_smif_context_t *context);
+void Cy_SMIF_Disable(SMIF_Type *base);
+void Cy_SMIF_Interrupt(SMIF_Type *base, cy_stc_smif_context_t *context);
+void Cy_SMIF_SetDataSelect(SMIF_Type *base,
+                           cy_en_smif_slave_select_t slaveSelect,
+                           cy_en_smif_data_select_t dataSelect);
+cy_en_smif_status_t Cy_SMIF_TransmitCommand(SMIF_Type *base, uint8_t cmd,
+                                            cy_en_smif_txfr_width_t cmdTxfrWidth,
+                                            uint8_t const cmdParam[],
+                                            uint32_t paramSize,
+                                            cy_en_smif_txfr_width_t paramTxfrWidth,
+                                            cy_en_smif_slave_select_t slaveSelect,
+                                            uint32_t completeTxfr,
+                                            cy_stc_smif_context_t const *context);
+cy_en_smif_status_t Cy_SMIF_ReceiveDataBlocking(SMIF_Type *base,
+                                                uint8_t *rxBuffer,
+                                                uint32_t size,
+                                                cy_en_smif_txfr_width_t transferWidth,
+                                                cy_stc_smif_context_t const *context);
+cy_en_smif_status_t Cy_SMIF_MemInit(SMIF_Type *base,
+                                    cy_stc_smif_block_config_t const *blockConfig,
+                                    cy_stc_smif_context_t *context);
+void Cy_SMIF_MemDeInit(SMIF_Type *base);
+cy_en_smif_status_t Cy_SMIF_SendDummyCycles(SMIF_Type *base,
+                                            uint32_t cycles);
+cy_en_smif_status_t Cy_SMIF_MemRead(SMIF_Type *base,
+                                    cy_stc_smif_mem_config_t const *memConfig,
+                                    uint32_t address, uint8_t rxBuffer[],
+                                    uint32_t length,
+                                    cy_stc_smif_context_t const *context);
+cy_en_smif_status_t Cy_SMIF_MemWrite(SMIF_Type *base,
+                                     cy_stc_smif_mem_config_t const *memConfig,
+                                     uint32_t address, uint8_t const txBuffer[],
+                                     uint32_t length,
+                                     cy_stc_smif_context_t const *context);
+cy_en_smif_status_t Cy_SMIF_MemEraseSector(SMIF_Type *base,
+                                           cy_stc_smif_mem_config_t const *memConfig,
+                                           uint32_t startAddr, uint32_t length,
+                                           cy_stc_smif_context_t const *context);
+cy_en_smif_status_t Cy_SMIF_MemEraseChip(SMIF_Type *base,
+                                         cy_stc_smif_mem_config_t const *memConfig,
+                                         cy_stc_smif_context_t const *context);
+
+typedef enum
+{
+    CY_FLASH_DRV_SUCCESS = 0x00U,
+    CY_FLASH_DRV_INVALID_INPUT_PARAMETERS = 0x01U,
+} cy_en_flashdrv_status_t;
+
+#define CY_FLASH_BASE               0x10000000U
+#define CY_FLASH_SIZEOF_ROW         512U
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr,
+                                          const uint32_t *data);
+
+/*
+ * The internal flash row holding the SFDP cache. The driver reads it through
+ * CY_BOOT_SFDP_CACHE_ADDR and writes it with Cy_Flash_WriteRow.
+ */
+extern uint32_t cy_model_sfdp_cache_row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+
+#endif /* H_CY_PDL_MODEL_ */
@@ -0,0 +1,722 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host model of the SMIF and flash calls of the Cypress PDL, see cy_pdl.h.
+ *
+ * The model holds one QSPI part, out of a few with different erase
+ * commands. The part answers the JEDEC ID and SFDP commands, and
+ * Cy_SMIF_MemInit fills in its parameters when it is asked to run the SFDP
+ * discovery. The model counts the discoveries, so that a test can tell
+ * whether the driver used its cache, and keeps the block configuration it was
+ * last initialized with, so that it can check that the cached parameters are
+ * the ones the discovery would have found. The erase commands are checked
+ * against the part, and the model keeps track of the erased memory and of
+ * the time the erases would take.
+ */
+
+#include <string.h>
+
+#include "cy_pdl.h"
+
+#define JEDEC_ID_CMD    0x9FU
+#define SFDP_CMD        0x5AU
+#define SFDP_SIZE       256U
+#define BFPT_ADDR       0x40U
+#define SECTOR_MAP_ADDR 0x80U
+#define BAIT_ADDR       0x90U
+#define GRANULE         4096U
+#define MAX_MEM_SIZE    0x4000000U
+
+/* An erase type, as the SFDP basic flash parameter table describes it */
+struct model_erase {
+    uint8_t exp;        /* log2 of the block size, 0 if unused */
+    uint8_t cmd;        /* Opcode with 3-byte addresses */
+    uint8_t cmd4;       /* Opcode with 4-byte addresses */
+    uint32_t time;      /* Typical time in ms */
+};
+
+struct model_part {
+    uint8_t jedec_id[3];
+    uint32_t numOfAddrBytes;
+    uint32_t memSize;
+    uint32_t programSize;
+    uint32_t chipTime;
+    uint32_t programTime;
+    uint8_t readCmd;
+    uint8_t programCmd;
+    cy_en_smif_txfr_width_t dataWidth;
+    uint32_t dummyCycles;
+    struct model_erase erase[4];
+    /* The erase type the PDL keeps in the device configuration */
+    unsigned pdl_erase;
+    /* The 4 KB erase works everywhere */
+    bool uniform_4k;
+    bool sector_map;
+    /* Has the 4-byte address instruction table */
+    bool bait;
+};
+
+/*
+ * The maximum times in the SFDP, and so in the device configuration, are this
+ * many times the typical ones.
+ */
+#define MAX_TIME_FACTOR 6U
+
+static const struct model_part model_parts[] = {
+    /* S25FL512S: uniform 256 KB blocks */
+    {
+        .jedec_id = { 0x01, 0x02, 0x20 },
+        .numOfAddrBytes = 4,
+        .memSize = 0x4000000,
+        .programSize = 512,
+        .chipTime = 104000,
+        .programTime = 340,
+        .readCmd = 0xEC,
+        .programCmd = 0x12,
+        .dataWidth = CY_SMIF_WIDTH_QUAD,
+        .dummyCycles = 4,
+        .erase = {
+            { 18, 0xD8, 0xDC, 512 },
+        },
+        .pdl_erase = 0,
+        .bait = true,
+    },
+    /* S25FL128L: 4, 32 and 64 KB blocks */
+    {
+        .jedec_id = { 0x01, 0x60, 0x18 },
+        .numOfAddrBytes = 3,
+        .memSize = 0x1000000,
+        .programSize = 256,
+        .chipTime = 55000,
+        .programTime = 450,
+        .readCmd = 0xEB,
+        .programCmd = 0x02,
+        .dataWidth = CY_SMIF_WIDTH_QUAD,
+        .dummyCycles = 10,
+        .erase = {
+            { 12, 0x20, 0x00, 48 },
+            { 15, 0x52, 0x00, 144 },
+            { 16, 0xD8, 0x00, 208 },
+        },
+        .pdl_erase = 0,
+        .uniform_4k = true,
+    },
+    /* MX25L51245G: 4, 32 and 64 KB blocks, with 4-byte addresses */
+    {
+        .jedec_id = { 0xC2, 0x20, 0x1A },
+        .numOfAddrBytes = 4,
+        .memSize = 0x4000000,
+        .programSize = 256,
+        .chipTime = 150000,
+        .programTime = 750,
+        .readCmd = 0xEC,
+        .programCmd = 0x12,
+        .dataWidth = CY_SMIF_WIDTH_QUAD,
+        .dummyCycles = 10,
+        .erase = {
+            { 12, 0x20, 0x21, 32 },
+            { 15, 0x52, 0x5C, 112 },
+            { 16, 0xD8, 0xDC, 208 },
+        },
+        .pdl_erase = 0,
+        .uniform_4k = true,
+        .bait = true,
+    },
+    /* S25FL127S: 64 KB blocks, and 4 KB ones only at the bottom */
+    {
+        .jedec_id = { 0x01, 0x20, 0x18 },
+        .numOfAddrBytes = 3,
+        .memSize = 0x1000000,
+        .programSize = 256,
+        .chipTime = 32000,
+        .programTime = 250,
+        .readCmd = 0xEB,
+        .programCmd = 0x02,
+        .dataWidth = CY_SMIF_WIDTH_QUAD,
+        .dummyCycles = 10,
+        .erase = {
+            { 12, 0x20, 0x00, 48 },
+            { 16, 0xD8, 0x00, 208 },
+        },
+        .pdl_erase = 1,
+        .sector_map = true,
+    },
+};
+
+GPIO_PRT_Type cy_model_gpio_prt[2];
+SMIF_Type cy_model_smif0;
+uint32_t cy_model_sfdp_cache_row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+
+/* The part on the bus, NULL if nothing answers */
+static const struct model_part *model_part = &model_parts[0];
+static uint8_t model_last_cmd;
+static uint32_t model_last_addr;
+static uint32_t model_discoveries;
+static const cy_stc_smif_block_config_t *model_block_config;
+
+/* Which 4 KB granules of the memory are erased, and what erasing cost */
+static bool model_erased[MAX_MEM_SIZE / GRANULE];
+static uint32_t model_erase_ops;
+static uint32_t model_erase_time;
+
+void cy_model_set_part(int index)
+{
+    if (index < 0 || (size_t)index >= sizeof(model_parts) / sizeof(model_parts[0])) {
+        model_part = NULL;
+    } else {
+        model_part = &model_parts[index];
+    }
+}
+
+void cy_model_reset(void)
+{
+    memset(cy_model_sfdp_cache_row, 0, sizeof(cy_model_sfdp_cache_row));
+    model_part = &model_parts[0];
+    model_discoveries = 0;
+    model_block_config = NULL;
+    memset(model_erased, 0, sizeof(model_erased));
+    model_erase_ops = 0;
+    model_erase_time = 0;
+}
+
+uint32_t cy_model_discoveries(void)
+{
+    return model_discoveries;
+}
+
+void cy_model_corrupt_cache(void)
+{
+    cy_model_sfdp_cache_row[4] ^= 1;
+}
+
+/* Programs the whole memory, and forgets the cost of the erases so far */
+void cy_model_program_all(void)
+{
+    memset(model_erased, 0, sizeof(model_erased));
+    model_erase_ops = 0;
+    model_erase_time = 0;
+}
+
+/* Returns the number of erased granules in [off, off + len) */
+uint32_t cy_model_erased(uint32_t off, uint32_t len)
+{
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (i = off / GRANULE; i < (off + len) / GRANULE && i < MAX_MEM_SIZE / GRANULE; i++) {
+        count += model_erased[i];
+    }
+    return count;
+}
+
+uint32_t cy_model_erase_ops(void)
+{
+    return model_erase_ops;
+}
+
+/* The typical time the erases so far took on the part, in ms */
+uint32_t cy_model_erase_time(void)
+{
+    return model_erase_time;
+}
+
+static uint32_t model_erase_cmd(const struct model_part *part,
+                                const struct model_erase *erase)
+{
+    return part->numOfAddrBytes == 4 ? erase->cmd4 : erase->cmd;
+}
+
+/* Encodes a typical time as in DWORD 10 of the basic flash parameter table */
+static uint32_t model_sfdp_time(uint32_t time)
+{
+    static const uint32_t units[4] = { 1, 16, 128, 1000 };
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        if (time % units[i] == 0 && time / units[i] <= 32) {
+            return (time / units[i] - 1) | (i << 5);
+        }
+    }
+    return 0x7F;
+}
+
+static void model_put_dword(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/*
+ * Builds the SFDP of the part: the header, the parameter headers, and the
+ * parameter tables with what the driver reads from them.
+ */
+static void model_sfdp(const struct model_part *part, uint8_t *sfdp)
+{
+    uint8_t *hdr = &sfdp[8];
+    uint8_t *bfpt = &sfdp[BFPT_ADDR];
+    uint8_t *bait = &sfdp[BAIT_ADDR];
+    uint32_t times = MAX_TIME_FACTOR / 2 - 1;
+    uint32_t bait_types = 0;
+    uint32_t i;
+
+    memset(sfdp, 0xFF, SFDP_SIZE);
+    memcpy(sfdp, "SFDP", 4);
+    sfdp[4] = 6;
+    sfdp[5] = 1;
+    sfdp[6] = 0;
+    sfdp[7] = 0xFF;
+
+    memcpy(hdr, (const uint8_t[]){ 0x00, 6, 1, 16, BFPT_ADDR, 0, 0, 0xFF }, 8);
+    if (part->sector_map) {
+        hdr += 8;
+        sfdp[6]++;
+        memcpy(hdr, (const uint8_t[]){ 0x81, 0, 1, 2, SECTOR_MAP_ADDR, 0, 0, 0xFF }, 8);
+    }
+    if (part->bait) {
+        hdr += 8;
+        sfdp[6]++;
+        memcpy(hdr, (const uint8_t[]){ 0x84, 0, 1, 2, BAIT_ADDR, 0, 0, 0xFF }, 8);
+    }
+
+    memset(bfpt, 0, 64);
+    bfpt[0] = part->uniform_4k ? 0xE5 : 0xE7;
+    bfpt[1] = part->uniform_4k ? 0x20 : 0xFF;
+    for (i = 0; i < 4; i++) {
+        const struct model_erase *erase = &part->erase[i];
+
+        if (erase->exp == 0) {
+            continue;
+        }
+        bfpt[28 + 2 * i] = erase->exp;
+        bfpt[29 + 2 * i] = erase->cmd;
+        times |= model_sfdp_time(erase->time) << (4 + 7 * i);
+        bait[4 + i] = erase->cmd4;
+        bait_types |= 1UL << (9 + i);
+    }
+    model_put_dword(&bfpt[36], times);
+    model_put_dword(bait, bait_types);
+}
+
+static void model_cmd(cy_stc_smif_mem_cmd_t *cmd, uint8_t command,
+                      cy_en_smif_txfr_width_t width, uint32_t dummy)
+{
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->command = command;
+    cmd->cmdWidth = CY_SMIF_WIDTH_SINGLE;
+    cmd->addrWidth = width;
+    cmd->mode = 0xFFFFFFFFU;
+    cmd->dummyCycles = dummy;
+    cmd->dataWidth = width;
+}
+
+static bool model_cmd_matches(const cy_stc_smif_mem_cmd_t *cmd, uint8_t command,
+                              cy_en_smif_txfr_width_t width, uint32_t dummy)
+{
+    cy_stc_smif_mem_cmd_t expected;
+
+    model_cmd(&expected, command, width, dummy);
+    return memcmp(cmd, &expected, sizeof(expected)) == 0;
+}
+
+static void model_discover(const struct model_part *part,
+                           cy_stc_smif_mem_device_cfg_t *dev)
+{
+    const struct model_erase *erase = &part->erase[part->pdl_erase];
+
+    dev->numOfAddrBytes = part->numOfAddrBytes;
+    dev->memSize = part->memSize;
+    dev->eraseSize = 1UL << erase->exp;
+    dev->programSize = part->programSize;
+    dev->stsRegBusyMask = 0x01;
+    dev->stsRegQuadEnableMask = 0x02;
+    dev->eraseTime = erase->time * MAX_TIME_FACTOR;
+    dev->chipEraseTime = part->chipTime * MAX_TIME_FACTOR;
+    dev->programTime = part->programTime;
+    model_cmd(dev->readCmd, part->readCmd, part->dataWidth, part->dummyCycles);
+    model_cmd(dev->writeEnCmd, 0x06, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->writeDisCmd, 0x04, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->eraseCmd, model_erase_cmd(part, erase),
+              CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->chipEraseCmd, 0x60, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->programCmd, part->programCmd, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->readStsRegWipCmd, 0x05, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->readStsRegQeCmd, 0x35, CY_SMIF_WIDTH_SINGLE, 0);
+    model_cmd(dev->writeStsRegQeCmd, 0x01, CY_SMIF_WIDTH_SINGLE, 0);
+}
+
+/*
+ * Returns 1 if the memory the driver was last initialized with has the
+ * parameters of the part on the bus.
+ */
+int cy_model_config_matches(void)
+{
+    const struct model_part *part = model_part;
+    const cy_stc_smif_mem_device_cfg_t *dev;
+    const struct model_erase *erase;
+
+    if (part == NULL || model_block_config == NULL) {
+        return 0;
+    }
+    dev = model_block_config->memConfig[0]->deviceCfg;
+    erase = &part->erase[part->pdl_erase];
+
+    return dev->numOfAddrBytes == part->numOfAddrBytes &&
+           dev->memSize == part->memSize &&
+           dev->eraseSize == 1UL << erase->exp &&
+           dev->programSize == part->programSize &&
+           dev->stsRegBusyMask == 0x01 &&
+           dev->stsRegQuadEnableMask == 0x02 &&
+           dev->eraseTime == erase->time * MAX_TIME_FACTOR &&
+           dev->chipEraseTime == part->chipTime * MAX_TIME_FACTOR &&
+           dev->programTime == part->programTime &&
+           model_cmd_matches(dev->readCmd, part->readCmd, part->dataWidth,
+                             part->dummyCycles) &&
+           model_cmd_matches(dev->writeEnCmd, 0x06, CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->writeDisCmd, 0x04, CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->eraseCmd, model_erase_cmd(part, erase),
+                             CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->chipEraseCmd, 0x60, CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->programCmd, part->programCmd,
+                             CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->readStsRegWipCmd, 0x05,
+                             CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->readStsRegQeCmd, 0x35,
+                             CY_SMIF_WIDTH_SINGLE, 0) &&
+           model_cmd_matches(dev->writeStsRegQeCmd, 0x01,
+                             CY_SMIF_WIDTH_SINGLE, 0);
+}
+
+void Cy_GPIO_Pin_Init(GPIO_PRT_Type *base, uint32_t pinNum,
+                      const cy_stc_gpio_pin_config_t *config)
+{
+    (void)base;
+    (void)pinNum;
+    (void)config;
+}
+
+void Cy_GPIO_SetHSIOM(GPIO_PRT_Type *base, uint32_t pinNum,
+                      en_hsiom_sel_t value)
+{
+    (void)base;
+    (void)pinNum;
+    (void)value;
+}
+
+void Cy_GPIO_Port_Deinit(GPIO_PRT_Type *base)
+{
+    (void)base;
+}
+
+void Cy_SysClk_ClkHfSetSource(uint32_t clkHf, uint32_t source)
+{
+    (void)clkHf;
+    (void)source;
+}
+
+void Cy_SysClk_ClkHfSetDivider(uint32_t clkHf, uint32_t divider)
+{
+    (void)clkHf;
+    (void)divider;
+}
+
+void Cy_SysClk_ClkHfEnable(uint32_t clkHf)
+{
+    (void)clkHf;
+}
+
+void Cy_SysClk_ClkHfDisable(uint32_t clkHf)
+{
+    (void)clkHf;
+}
+
+void Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    (void)config;
+    (void)userIsr;
+}
+
+void Cy_SysInt_DisconnectInterruptSource(IRQn_Type IRQn,
+                                         cy_en_intr_t devIntrSrc)
+{
+    (void)IRQn;
+    (void)devIntrSrc;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+cy_en_smif_status_t Cy_SMIF_Init(SMIF_Type *base,
+                                 cy_stc_smif_config_t const *config,
+                                 uint32_t timeout,
+                                 cy_stc_smif_context_t *context)
+{
+    (void)base;
+    (void)config;
+    context->timeout = timeout;
+    return CY_SMIF_SUCCESS;
+}
+
+void Cy_SMIF_Enable(SMIF_Type *base, cy_stc_smif_context_t *context)
+{
+    (void)base;
+    (void)context;
+}
+
+void Cy_SMIF_Disable(SMIF_Type *base)
+{
+    (void)base;
+}
+
+void Cy_SMIF_Interrupt(SMIF_Type *base, cy_stc_smif_context_t *context)
+{
+    (void)base;
+    (void)context;
+}
+
+void Cy_SMIF_SetDataSelect(SMIF_Type *base,
+                           cy_en_smif_slave_select_t slaveSelect,
+                           cy_en_smif_data_select_t dataSelect)
+{
+    (void)base;
+    (void)slaveSelect;
+    (void)dataSelect;
+}
+
+cy_en_smif_status_t Cy_SMIF_TransmitCommand(SMIF_Type *base, uint8_t cmd,
+                                            cy_en_smif_txfr_width_t cmdTxfrWidth,
+                                            uint8_t const cmdParam[],
+                                            uint32_t paramSize,
+                                            cy_en_smif_txfr_width_t paramTxfrWidth,
+                                            cy_en_smif_slave_select_t slaveSelect,
+                                            uint32_t completeTxfr,
+                                            cy_stc_smif_context_t const *context)
+{
+    (void)base;
+    (void)cmdTxfrWidth;
+    (void)paramTxfrWidth;
+    (void)slaveSelect;
+    (void)completeTxfr;
+    (void)context;
+    model_last_cmd = cmd;
+    model_last_addr = 0;
+    if (cmd == SFDP_CMD) {
+        if (paramSize != 3) {
+            return CY_SMIF_BAD_PARAM;
+        }
+        model_last_addr = ((uint32_t)cmdParam[0] << 16) |
+                          ((uint32_t)cmdParam[1] << 8) | cmdParam[2];
+    }
+    return CY_SMIF_SUCCESS;
+}
+
+cy_en_smif_status_t Cy_SMIF_ReceiveDataBlocking(SMIF_Type *base,
+                                                uint8_t *rxBuffer,
+                                                uint32_t size,
+                                                cy_en_smif_txfr_width_t transferWidth,
+                                                cy_stc_smif_context_t const *context)
+{
+    uint8_t sfdp[SFDP_SIZE];
+    uint32_t i;
+
+    (void)base;
+    (void)transferWidth;
+    (void)context;
+
+    /* Nothing drives the bus: the data lines float high */
+    memset(rxBuffer, 0xFF, size);
+    if (model_part == NULL) {
+        return CY_SMIF_SUCCESS;
+    }
+
+    if (model_last_cmd == JEDEC_ID_CMD) {
+        memcpy(rxBuffer, model_part->jedec_id,
+               size < sizeof(model_part->jedec_id) ?
+               size : sizeof(model_part->jedec_id));
+    } else if (model_last_cmd == SFDP_CMD) {
+        model_sfdp(model_part, sfdp);
+        for (i = 0; i < size && model_last_addr + i < SFDP_SIZE; i++) {
+            rxBuffer[i] = sfdp[model_last_addr + i];
+        }
+    }
+    return CY_SMIF_SUCCESS;
+}
+
+cy_en_smif_status_t Cy_SMIF_SendDummyCycles(SMIF_Type *base, uint32_t cycles)
+{
+    (void)base;
+
+    return (model_last_cmd == SFDP_CMD && cycles != 8) ?
+           CY_SMIF_BAD_PARAM : CY_SMIF_SUCCESS;
+}
+
+cy_en_smif_status_t Cy_SMIF_MemInit(SMIF_Type *base,
+                                    cy_stc_smif_block_config_t const *blockConfig,
+                                    cy_stc_smif_context_t *context)
+{
+    cy_stc_smif_mem_config_t *mem;
+    uint32_t i;
+
+    (void)base;
+    (void)context;
+
+    for (i = 0; i < blockConfig->memCount; i++) {
+        mem = blockConfig->memConfig[i];
+        if (mem->flags & CY_SMIF_FLAG_DETECT_SFDP) {
+            model_discoveries++;
+            if (model_part == NULL) {
+                return CY_SMIF_SFDP_SS0_FAILED;
+            }
+            model_discover(model_part, mem->deviceCfg);
+        }
+    }
+    model_block_config = blockConfig;
+    return CY_SMIF_SUCCESS;
+}
+
+/*
+ * The driver keeps the parameters in static memory, which a reset would clear.
+ * Clear them here instead, so that the next initialization has to find them
+ * again.
+ */
+void Cy_SMIF_MemDeInit(SMIF_Type *base)
+{
+    cy_stc_smif_mem_device_cfg_t *dev;
+
+    (void)base;
+
+    if (model_block_config == NULL) {
+        return;
+    }
+    dev = model_block_config->memConfig[0]->deviceCfg;
+    dev->memSize = 0;
+    dev->eraseSize = 0;
+    dev->programSize = 0;
+    dev->stsRegBusyMask = 0;
+    dev->stsRegQuadEnableMask = 0;
+    dev->eraseTime = 0;
+    dev->chipEraseTime = 0;
+    dev->programTime = 0;
+    memset(dev->readCmd, 0, sizeof(*dev->readCmd));
+    memset(dev->writeEnCmd, 0, sizeof(*dev->writeEnCmd));
+    memset(dev->writeDisCmd, 0, sizeof(*dev->writeDisCmd));
+    memset(dev->eraseCmd, 0, sizeof(*dev->eraseCmd));
+    memset(dev->chipEraseCmd, 0, sizeof(*dev->chipEraseCmd));
+    memset(dev->programCmd, 0, sizeof(*dev->programCmd));
+    memset(dev->readStsRegWipCmd, 0, sizeof(*dev->readStsRegWipCmd));
+    memset(dev->readStsRegQeCmd, 0, sizeof(*dev->readStsRegQeCmd));
+    memset(dev->writeStsRegQeCmd, 0, sizeof(*dev->writeStsRegQeCmd));
+    model_block_config = NULL;
+}
+
+cy_en_smif_status_t Cy_SMIF_MemRead(SMIF_Type *base,
+                                    cy_stc_smif_mem_config_t const *memConfig,
+                                    uint32_t address, uint8_t rxBuffer[],
+                                    uint32_t length,
+                                    cy_stc_smif_context_t const *context)
+{
+    (void)base;
+    (void)memConfig;
+    (void)address;
+    (void)rxBuffer;
+    (void)length;
+    (void)context;
+    return CY_SMIF_BAD_PARAM;
+}
+
+cy_en_smif_status_t Cy_SMIF_MemWrite(SMIF_Type *base,
+                                     cy_stc_smif_mem_config_t const *memConfig,
+                                     uint32_t address, uint8_t const txBuffer[],
+                                     uint32_t length,
+                                     cy_stc_smif_context_t const *context)
+{
+    (void)base;
+    (void)memConfig;
+    (void)address;
+    (void)txBuffer;
+    (void)length;
+    (void)context;
+    return CY_SMIF_BAD_PARAM;
+}
+
+/*
+ * Erases with the command and block size of the device configuration, as the
+ * PDL does. A command the part doesn't have, or one which only works in some
+ * places, fails, where the part would silently ignore it.
+ */
+cy_en_smif_status_t Cy_SMIF_MemEraseSector(SMIF_Type *base,
+                                           cy_stc_smif_mem_config_t const *memConfig,
+                                           uint32_t startAddr, uint32_t length,
+                                           cy_stc_smif_context_t const *context)
+{
+    const cy_stc_smif_mem_device_cfg_t *dev = memConfig->deviceCfg;
+    const struct model_part *part = model_part;
+    const struct model_erase *erase = NULL;
+    uint32_t size = dev->eraseSize;
+    uint32_t i;
+
+    (void)base;
+    (void)context;
+
+    if (part == NULL) {
+        return CY_SMIF_EXCEED_TIMEOUT;
+    }
+    for (i = 0; i < 4; i++) {
+        if (part->erase[i].exp != 0 &&
+            1UL << part->erase[i].exp == size &&
+            model_erase_cmd(part, &part->erase[i]) == dev->eraseCmd->command) {
+            erase = &part->erase[i];
+        }
+    }
+    if (erase == NULL || (size == 4096 && !part->uniform_4k) ||
+        startAddr % size != 0 || length % size != 0 ||
+        startAddr + length > part->memSize || length == 0) {
+        return CY_SMIF_BAD_PARAM;
+    }
+    if (dev->eraseTime < erase->time) {
+        return CY_SMIF_EXCEED_TIMEOUT;
+    }
+
+    for (i = startAddr; i < startAddr + length; i += size) {
+        memset(&model_erased[i / GRANULE], 1, size / GRANULE);
+        model_erase_ops++;
+        model_erase_time += erase->time;
+    }
+    return CY_SMIF_SUCCESS;
+}
+
+cy_en_smif_status_t Cy_SMIF_MemEraseChip(SMIF_Type *base,
+                                         cy_stc_smif_mem_config_t const *memConfig,
+                                         cy_stc_smif_context_t const *context)
+{
+    (void)base;
+    (void)memConfig;
+    (void)context;
+
+    if (model_part == NULL) {
+        return CY_SMIF_EXCEED_TIMEOUT;
+    }
+    memset(model_erased, 1, model_part->memSize / GRANULE);
+    model_erase_ops++;
+    model_erase_time += model_part->chipTime;
+    return CY_SMIF_SUCCESS;
+}
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr,
+                                          const uint32_t *data)
+{
+    /* On a 64-bit host only the low half of the address gets here */
+    if (rowAddr != (uint32_t)(uintptr_t)cy_model_sfdp_cache_row) {
+        return CY_FLASH_DRV_INVALID_INPUT_PARAMETERS;
+    }
+    memcpy(cy_model_sfdp_cache_row, data, sizeof(cy_model_sfdp_cache_row));
+    return CY_FLASH_DRV_SUCCESS;
+}
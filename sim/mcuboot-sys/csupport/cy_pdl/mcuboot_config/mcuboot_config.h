@@ -0,0 +1,14 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Stands in for the MCUBootApp configuration when cy_smif_psoc6.c is built
+ * against the PDL model.
+ */
+
+#ifndef H_CY_MODEL_MCUBOOT_CONFIG_
+#define H_CY_MODEL_MCUBOOT_CONFIG_
+
+#define MCUBOOT_IMAGE_NUMBER 1
+#define CY_BOOT_USE_EXTERNAL_FLASH
+
+#endif /* H_CY_MODEL_MCUBOOT_CONFIG_ */
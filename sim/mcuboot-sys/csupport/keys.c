@@ -133,6 +133,18 @@ const unsigned char root_pub_der[] = {
     0x20, 0xff, 0xb4, 0xe0,
 };
 const unsigned int root_pub_der_len = 44;
+#elif defined(MCUBOOT_SIGN_LMS)
+#define HAVE_KEYS
+const unsigned char root_pub_der[] = {
+    0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03,
+    0x88, 0x8b, 0xad, 0x98, 0x31, 0xdf, 0x4e, 0x9b,
+    0xf2, 0x01, 0xb6, 0x9c, 0x84, 0xeb, 0x08, 0xe9,
+    0x1b, 0xa6, 0x3a, 0x7a, 0xbd, 0xee, 0x19, 0x2a,
+    0x3e, 0x14, 0x9a, 0xb0, 0xa9, 0xc1, 0x4f, 0x36,
+    0x16, 0x00, 0xd1, 0x1c, 0x40, 0x25, 0x98, 0x6e,
+    0x86, 0x3a, 0x92, 0xaf, 0x00, 0xeb, 0x4e, 0xa1,
+};
+const unsigned int root_pub_der_len = 56;
 #endif
 
 #if defined(HAVE_KEYS)
@@ -2,14 +2,19 @@
 
 #include <assert.h>
 #include <setjmp.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <bootutil/bootutil.h>
 #include <bootutil/image.h>
+#include <bootutil/prestage.h>
 
 #include <flash_map_backend/flash_map_backend.h>
 
+/* The simulator implements the flash map backend below. */
+#define BOOT_FLASH_CACHE_NO_REMAP
+
 #include "../../../boot/bootutil/src/bootutil_priv.h"
 #include "bootsim.h"
 
@@ -22,6 +27,15 @@
 #include "mbedtls/nist_kw.h"
 #endif
 
+#ifdef MCUBOOT_ENCRYPT_X25519
+#include "bootutil/crypto/ecdh_x25519.h"
+#endif
+
+#ifdef MCUBOOT_WARM_BOOT
+#include "bootutil/warm_boot.h"
+#include "../../../boot/bootutil/src/crc32c.h"
+#endif
+
 #define BOOT_LOG_LEVEL BOOT_LOG_LEVEL_ERROR
 #include <bootutil/bootutil_log.h>
 
@@ -45,6 +59,10 @@ extern int sim_flash_write(uint8_t flash_id, uint32_t offset, const uint8_t *src
 extern uint16_t sim_flash_align(uint8_t flash_id);
 extern uint8_t sim_flash_erased_val(uint8_t flash_id);
 
+extern uint8_t *sim_warm_retained(uint32_t size);
+extern uint8_t sim_warm_reset(void);
+extern uint32_t sim_flash_generation(void);
+
 struct sim_context {
     int flash_counter;
     int jumped;
@@ -202,6 +220,37 @@ done:
 #endif
 }
 
+int sim_verify_sig(const uint8_t *hash, uint32_t hlen, const uint8_t *sig,
+                   uint32_t slen)
+{
+#if defined(MCUBOOT_SIGN_RSA) || defined(MCUBOOT_SIGN_EC256) || \
+    defined(MCUBOOT_SIGN_ED25519) || defined(MCUBOOT_SIGN_LMS)
+    fih_int fih_rc = FIH_FAILURE;
+
+    FIH_CALL(bootutil_verify_sig, fih_rc, (uint8_t *)hash, hlen,
+             (uint8_t *)sig, slen, 0);
+    return fih_eq(fih_rc, FIH_SUCCESS) ? 0 : -1;
+#else
+    (void)hash;
+    (void)hlen;
+    (void)sig;
+    (void)slen;
+    return -1;
+#endif
+}
+
+int sim_x25519(uint8_t *out, const uint8_t *priv, const uint8_t *pub)
+{
+#ifdef MCUBOOT_ENCRYPT_X25519
+    return X25519(out, priv, pub) == 1 ? 0 : -1;
+#else
+    (void)out;
+    (void)priv;
+    (void)pub;
+    return -1;
+#endif
+}
+
 uint16_t flash_area_align(const struct flash_area *area)
 {
     return sim_flash_align(area->fa_device_id);
@@ -224,11 +273,157 @@ struct area_desc {
     uint32_t num_slots;
 };
 
+#ifdef SIM_RAM_REPORT
+/*
+ * Stack high-water mark of context_boot_go(). The stack below the caller is
+ * painted before the boot, and the lowest byte which lost the pattern gives
+ * the depth the boot reached. The simulator keeps the buffers which are static
+ * on targets (TARGET_STATIC) on the stack, so they are counted here too.
+ */
+#define SIM_STACK_PAINT_SZ  (128 * 1024)
+#define SIM_STACK_PAINT     0xa5
+
+static __attribute__((noinline)) uintptr_t sim_paint_stack(void)
+{
+    volatile uint8_t area[SIM_STACK_PAINT_SZ];
+    uintptr_t base;
+    size_t i;
+
+    for (i = 0; i < sizeof(area); i++) {
+        area[i] = SIM_STACK_PAINT;
+    }
+    base = (uintptr_t)area;
+    return base;
+}
+
+static __attribute__((noinline)) size_t sim_stack_used(uintptr_t base)
+{
+    const volatile uint8_t *area = (const volatile uint8_t *)base;
+    size_t i;
+
+    for (i = 0; i < SIM_STACK_PAINT_SZ; i++) {
+        if (area[i] != SIM_STACK_PAINT) {
+            break;
+        }
+    }
+    return SIM_STACK_PAINT_SZ - i;
+}
+
+static void sim_report_ram(uintptr_t stack)
+{
+    size_t used = sim_stack_used(stack);
+
+    BOOT_LOG_INF("ram: %u bytes of boot state (%u of I/O buffer), "
+                 "%u%s bytes of stack",
+                 (unsigned)sizeof(struct boot_loader_state),
+                 (unsigned)BOOT_IO_BUF_SZ, (unsigned)used,
+                 used == SIM_STACK_PAINT_SZ ? "+" : "");
+}
+#endif
+
+#ifdef MCUBOOT_FLASH_CACHE
+static void sim_report_flash_cache_stats(void)
+{
+    struct boot_flash_cache_stats stats;
+    uint32_t lookups;
+
+    boot_flash_cache_get_stats(&stats);
+    lookups = stats.hits + stats.misses;
+    BOOT_LOG_INF("flash cache: %u hits, %u misses (%u%% hit rate), "
+                 "%u bypassed reads", (unsigned)stats.hits,
+                 (unsigned)stats.misses,
+                 lookups ? (unsigned)(stats.hits * 100ull / lookups) : 0u,
+                 (unsigned)stats.bypassed);
+}
+#endif
+
+/*
+ * The results of the last boot are kept per thread, as the tests run in
+ * parallel.
+ */
+
+/* Images which failed the deferred checks of the last boot. */
+static __thread uint32_t sim_deferred_failed;
+
+uint32_t sim_boot_deferred_failed(void)
+{
+    return sim_deferred_failed;
+}
+
+/* Offset of the image booted by the last successful boot. */
+static __thread uint32_t sim_image_off;
+
+uint32_t sim_boot_image_off(void)
+{
+    return sim_image_off;
+}
+
+/* Flash reads, and those of the last boot up to the handoff. */
+static __thread uint32_t sim_flash_reads;
+static __thread uint32_t sim_boot_reads;
+
+uint32_t sim_boot_flash_reads(void)
+{
+    return sim_boot_reads;
+}
+
+#ifdef MCUBOOT_WARM_BOOT
+/*
+ * The warm boot hooks of the platform. The retained RAM, the reset cause
+ * and the flash generation are kept by the simulator, per test thread.
+ */
+static const uint8_t sim_warm_key[32] = "bootsim warm boot state MAC key";
+
+struct boot_warm_state *boot_warm_retained_state(void)
+{
+    return (struct boot_warm_state *)
+        sim_warm_retained(sizeof(struct boot_warm_state));
+}
+
+bool boot_warm_reset(void)
+{
+    return sim_warm_reset() != 0;
+}
+
+uint32_t boot_warm_flash_generation(void)
+{
+    return sim_flash_generation();
+}
+
+const uint8_t *boot_warm_key(uint32_t *key_len)
+{
+    *key_len = sizeof(sim_warm_key);
+    return sim_warm_key;
+}
+#endif
+
+/*
+ * Redirects the recorded boot to the given offset, as an image could do by
+ * writing to the retained RAM: the CRC is updated, but not the MAC.
+ */
+int sim_warm_forge(uint32_t image_off)
+{
+#ifdef MCUBOOT_WARM_BOOT
+    struct boot_warm_state *ws = boot_warm_retained_state();
+
+    ws->image_off = image_off;
+    ws->crc = crc32c_checksum((const uint8_t *)ws,
+                              offsetof(struct boot_warm_state, crc));
+    return 0;
+#else
+    (void)image_off;
+    return -1;
+#endif
+}
+
 int invoke_boot_go(struct sim_context *ctx, struct area_desc *adesc)
 {
     int res;
     struct boot_rsp rsp;
     struct boot_loader_state *state;
+#ifdef SIM_RAM_REPORT
+    uintptr_t stack;
+#endif
 
 #if defined(MCUBOOT_SIGN_RSA)
     mbedtls_platform_set_calloc_free(calloc, free);
@@ -240,8 +435,36 @@ int invoke_boot_go(struct sim_context *ctx, struct area_desc *adesc)
     sim_set_flash_areas(adesc);
     sim_set_context(ctx);
 
+#ifdef MCUBOOT_FLASH_CACHE
+    boot_flash_cache_reset_stats();
+#endif
+#ifdef SIM_RAM_REPORT
+    stack = sim_paint_stack();
+#endif
+
+    sim_deferred_failed = 0;
+    sim_image_off = 0;
+    sim_flash_reads = 0;
+    sim_boot_reads = 0;
+
     if (setjmp(ctx->boot_jmpbuf) == 0) {
         res = context_boot_go(state, &rsp);
+        sim_boot_reads = sim_flash_reads;
+        if (res == 0) {
+            sim_image_off = rsp.br_image_off;
+        }
+#ifdef MCUBOOT_STAGED_BOOT
+        /* Image 0 would be started here, before the deferred checks. */
+        if (res == 0) {
+            (void)context_boot_go_deferred(state, &sim_deferred_failed);
+        }
+#endif
+#ifdef MCUBOOT_FLASH_CACHE
+        sim_report_flash_cache_stats();
+#endif
+#ifdef SIM_RAM_REPORT
+        sim_report_ram(stack);
+#endif
         sim_reset_flash_areas();
         sim_reset_context();
         free(state);
@@ -255,12 +478,88 @@ int invoke_boot_go(struct sim_context *ctx, struct area_desc *adesc)
     }
 }
 
+int invoke_prestage(struct sim_context *ctx, struct area_desc *adesc,
+                    int image_index, int permanent)
+{
+    uint8_t tmp_buf[256];
+    int res;
+
+    sim_set_flash_areas(adesc);
+    sim_set_context(ctx);
+
+    if (setjmp(ctx->boot_jmpbuf) == 0) {
+#if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
+        res = boot_prestage(image_index, permanent, tmp_buf, sizeof(tmp_buf));
+#else
+        /* There are no upgrades to prepare when the slots are equivalent. */
+        (void)image_index;
+        (void)permanent;
+        (void)tmp_buf;
+        res = -1;
+#endif
+    } else {
+        res = -0x13579;
+    }
+
+    sim_reset_flash_areas();
+    sim_reset_context();
+    return res;
+}
+
+int invoke_check_blocks(struct sim_context *ctx, struct area_desc *adesc,
+                        int image_index, int slot, uint32_t off, uint32_t len)
+{
+#ifdef MCUBOOT_HASH_BLOCKS
+    const struct flash_area *fap;
+    struct image_header hdr;
+    uint8_t tmp_buf[256];
+#endif
+    int res;
+
+    sim_set_flash_areas(adesc);
+    sim_set_context(ctx);
+
+    if (setjmp(ctx->boot_jmpbuf) == 0) {
+#ifdef MCUBOOT_HASH_BLOCKS
+        res = flash_area_open(flash_area_id_from_multi_image_slot(image_index,
+                                                                  slot),
+                              &fap);
+        if (res == 0) {
+            res = flash_area_read(fap, 0, &hdr, sizeof(hdr));
+            if (res == 0) {
+                res = bootutil_img_check_blocks(NULL, image_index, &hdr, fap,
+                                                tmp_buf, sizeof(tmp_buf),
+                                                off, len);
+            }
+            flash_area_close(fap);
+        }
+#else
+        (void)image_index;
+        (void)slot;
+        (void)off;
+        (void)len;
+        res = -1;
+#endif
+    } else {
+        res = -0x13579;
+    }
+
+    sim_reset_flash_areas();
+    sim_reset_context();
+    return res;
+}
+
 void *os_malloc(size_t size)
 {
     // printf("os_malloc 0x%x bytes\n", size);
     return malloc(size);
 }
 
+int flash_area_id_from_image_slot(int slot)
+{
+    return flash_area_id_from_multi_image_slot(0, slot);
+}
+
 int flash_area_id_from_multi_image_slot(int image_index, int slot)
 {
     switch (slot) {
@@ -306,6 +605,7 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
 {
     BOOT_LOG_SIM("%s: area=%d, off=%x, len=%x",
                  __func__, area->fa_id, off, len);
+    sim_flash_reads++;
     return sim_flash_read(area->fa_device_id, area->fa_off + off, dst, len);
 }
 
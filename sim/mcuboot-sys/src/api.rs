@@ -72,9 +72,26 @@ impl CSimContextPtr {
     }
 }
 
+/// The RAM kept across resets and the cause of the next reset, for the
+/// warm boot hooks.
+pub struct WarmContext {
+    retained: Vec<u64>,
+    warm_reset: bool,
+}
+
+impl WarmContext {
+    pub fn new() -> WarmContext {
+        WarmContext {
+            retained: Vec::new(),
+            warm_reset: false,
+        }
+    }
+}
+
 thread_local! {
     pub static THREAD_CTX: RefCell<FlashContext> = RefCell::new(FlashContext::new());
     pub static SIM_CTX: RefCell<CSimContextPtr> = RefCell::new(CSimContextPtr::new());
+    pub static WARM_CTX: RefCell<WarmContext> = RefCell::new(WarmContext::new());
 }
 
 // Set the flash device to be used by the simulation.  The pointer is unsafely stashed away.
@@ -192,6 +209,47 @@ pub extern fn sim_flash_erased_val(id: u8) -> u8 {
     })
 }
 
+/// Set the cause of the next reset: warm resets keep the retained RAM.
+pub fn set_warm_reset(warm: bool) {
+    WARM_CTX.with(|ctx| {
+        ctx.borrow_mut().warm_reset = warm;
+    });
+}
+
+/// The retained RAM of this thread, at least `size` bytes.  It is only
+/// allocated once, so that the C code can keep the pointer.
+#[no_mangle]
+pub extern fn sim_warm_retained(size: u32) -> *mut u8 {
+    WARM_CTX.with(|ctx| {
+        let mut ctx = ctx.borrow_mut();
+        let words = (size as usize + 7) / 8;
+        if ctx.retained.len() < words {
+            assert!(ctx.retained.is_empty(), "Retained RAM resized");
+            ctx.retained.resize(words, 0);
+        }
+        ctx.retained.as_mut_ptr() as *mut u8
+    })
+}
+
+#[no_mangle]
+pub extern fn sim_warm_reset() -> u8 {
+    WARM_CTX.with(|ctx| {
+        ctx.borrow().warm_reset as u8
+    })
+}
+
+/// The sum of the generations of the flash devices, which changes with any
+/// write or erase, whether done by the C code or by the test.
+#[no_mangle]
+pub extern fn sim_flash_generation() -> u32 {
+    THREAD_CTX.with(|ctx| {
+        ctx.borrow().flash_map.values().fold(0u32, |sum, flash| {
+            let dev = unsafe { &*(flash.ptr) };
+            sum.wrapping_add(dev.generation())
+        })
+    })
+}
+
 fn map_err(err: Result<()>) -> libc::c_int {
     match err {
         Ok(()) => 0,
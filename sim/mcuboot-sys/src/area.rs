@@ -124,6 +124,14 @@ impl AreaDesc {
         None
     }
 
+    // Return the size of the first sector of the image with the given ID,
+    // or None if the area is not present.
+    pub fn first_sector_size(&self, id: FlashId) -> Option<usize> {
+        self.areas.get(id as usize)
+            .and_then(|area| area.first())
+            .map(|sector| sector.size as usize)
+    }
+
     pub fn get_c(&self) -> CAreaDesc {
         let mut areas: CAreaDesc = Default::default();
 
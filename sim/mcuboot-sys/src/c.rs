@@ -42,6 +42,99 @@ pub fn boot_go(multiflash: &mut SimMultiFlash, areadesc: &AreaDesc,
     (result, asserts)
 }
 
+/// Prepare the upgrade of an image from the running image, as
+/// boot_prestage() does.  Returns -0x13579 if stopped by the counter.
+pub fn prestage(multiflash: &mut SimMultiFlash, areadesc: &AreaDesc,
+                image_index: usize, permanent: bool,
+                counter: Option<&mut i32>) -> i32 {
+    unsafe {
+        for (&dev_id, flash) in multiflash.iter_mut() {
+            api::set_flash(dev_id, flash);
+        }
+    }
+    let mut sim_ctx = api::CSimContext {
+        flash_counter: match counter {
+            None => 0,
+            Some(ref c) => **c as libc::c_int
+        },
+        jumped: 0,
+        c_asserts: 0,
+        c_catch_asserts: 0,
+        boot_jmpbuf: [0; 16],
+    };
+    let result = unsafe {
+        raw::invoke_prestage(&mut sim_ctx as *mut _, &areadesc.get_c() as *const _,
+                             image_index as libc::c_int,
+                             if permanent { 1 } else { 0 }) as i32
+    };
+    counter.map(|c| *c = sim_ctx.flash_counter);
+    unsafe {
+        for (&dev_id, _) in multiflash {
+            api::clear_flash(dev_id);
+        }
+    };
+    result
+}
+
+/// Check the blocks of the image in the given slot which overlap the range
+/// [off, off + len) of its hashed area, as bootutil_img_check_blocks() does.
+pub fn check_blocks(multiflash: &mut SimMultiFlash, areadesc: &AreaDesc,
+                    image_index: usize, slot: usize, off: u32, len: u32) -> i32 {
+    unsafe {
+        for (&dev_id, flash) in multiflash.iter_mut() {
+            api::set_flash(dev_id, flash);
+        }
+    }
+    let mut sim_ctx = api::CSimContext {
+        flash_counter: 0,
+        jumped: 0,
+        c_asserts: 0,
+        c_catch_asserts: 0,
+        boot_jmpbuf: [0; 16],
+    };
+    let result = unsafe {
+        raw::invoke_check_blocks(&mut sim_ctx as *mut _, &areadesc.get_c() as *const _,
+                                 image_index as libc::c_int, slot as libc::c_int,
+                                 off, len) as i32
+    };
+    unsafe {
+        for (&dev_id, _) in multiflash {
+            api::clear_flash(dev_id);
+        }
+    };
+    result
+}
+
+/// The images which failed the deferred checks of the last boot, bit N for
+/// image N.
+pub fn boot_deferred_failed() -> u32 {
+    unsafe { raw::sim_boot_deferred_failed() }
+}
+
+/// The offset of the slot the last successful boot booted the image from.
+pub fn boot_image_off() -> usize {
+    unsafe { raw::sim_boot_image_off() as usize }
+}
+
+/// The number of flash reads of the last boot, up to the handoff: none when
+/// it booted the image recorded for a warm reset.
+pub fn boot_flash_reads() -> u32 {
+    unsafe { raw::sim_boot_flash_reads() }
+}
+
+/// Make the next boots follow a warm reset, which keeps the state recorded
+/// in retained RAM, or a cold one.
+pub fn set_warm_reset(warm: bool) {
+    api::set_warm_reset(warm);
+}
+
+/// Redirect the boot recorded in retained RAM to the given offset, as the
+/// image could, without the key of the MAC.  Returns false if this build
+/// records no boot state.
+pub fn warm_forge(image_off: usize) -> bool {
+    unsafe { raw::sim_warm_forge(image_off as u32) == 0 }
+}
+
 pub fn boot_trailer_sz(align: u32) -> u32 {
     unsafe { raw::boot_trailer_sz(align) }
 }
@@ -58,6 +151,26 @@ pub fn boot_max_align() -> usize {
     unsafe { raw::boot_max_align() as usize }
 }
 
+/// Verify the signature of a hash with the first built-in key.
+pub fn verify_sig(hash: &[u8], sig: &[u8]) -> bool {
+    unsafe {
+        raw::sim_verify_sig(hash.as_ptr(), hash.len() as u32,
+                            sig.as_ptr(), sig.len() as u32) == 0
+    }
+}
+
+/// Compute an X25519 shared secret with the bootloader's implementation.
+pub fn x25519(privkey: &[u8; 32], pubkey: &[u8; 32]) -> Option<[u8; 32]> {
+    let mut out = [0u8; 32];
+    unsafe {
+        if raw::sim_x25519(out.as_mut_ptr(), privkey.as_ptr(), pubkey.as_ptr()) == 0 {
+            Some(out)
+        } else {
+            None
+        }
+    }
+}
+
 pub fn rsa_oaep_encrypt(pubkey: &[u8], seckey: &[u8]) -> Result<[u8; 256], &'static str> {
     unsafe {
         let mut encbuf: [u8; 256] = [0; 256];
@@ -90,6 +203,15 @@ mod raw {
         // be any way to get rid of this warning.  See https://github.com/rust-lang/rust/issues/34798
         // for information and tracking.
         pub fn invoke_boot_go(sim_ctx: *mut CSimContext, areadesc: *const CAreaDesc) -> libc::c_int;
+        pub fn sim_boot_deferred_failed() -> u32;
+        pub fn sim_boot_image_off() -> u32;
+        pub fn sim_boot_flash_reads() -> u32;
+        pub fn sim_warm_forge(image_off: u32) -> libc::c_int;
+        pub fn invoke_prestage(sim_ctx: *mut CSimContext, areadesc: *const CAreaDesc,
+                               image_index: libc::c_int, permanent: libc::c_int) -> libc::c_int;
+        pub fn invoke_check_blocks(sim_ctx: *mut CSimContext, areadesc: *const CAreaDesc,
+                                   image_index: libc::c_int, slot: libc::c_int,
+                                   off: u32, len: u32) -> libc::c_int;
 
         pub fn boot_trailer_sz(min_write_sz: u32) -> u32;
         pub fn boot_status_sz(min_write_sz: u32) -> u32;
@@ -97,6 +219,12 @@ mod raw {
         pub fn boot_magic_sz() -> u32;
         pub fn boot_max_align() -> u32;
 
+        pub fn sim_verify_sig(hash: *const u8, hlen: u32, sig: *const u8,
+                              slen: u32) -> libc::c_int;
+
+        pub fn sim_x25519(out: *mut u8, privkey: *const u8,
+                          pubkey: *const u8) -> libc::c_int;
+
         pub fn rsa_oaep_encrypt_(pubkey: *const u8, pubkey_len: libc::c_uint,
                                  seckey: *const u8, seckey_len: libc::c_uint,
                                  encbuf: *mut u8) -> libc::c_int;
@@ -9,4 +9,7 @@ pub mod c;
 // functions are exported to C code.
 pub mod api;
 
+#[cfg(feature = "cypress-qspi")]
+pub mod qspi;
+
 pub use crate::area::{AreaDesc, FlashId};
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: Apache-2.0
+
+//! The Cypress QSPI driver and external flash erase, built against the model
+//! of the PDL in csupport/cy_pdl.
+
+/// Where the external memory is mapped.
+const SMIF_BASE: u32 = 0x18000000;
+
+/// Initialize the external memory on the given slave select, as MCUBootApp
+/// does on every boot, and return the PDL status.
+pub fn init_sfdp(smif_id: u32) -> u32 {
+    unsafe { raw::qspi_init_sfdp(smif_id) }
+}
+
+pub fn deinit(smif_id: u32) {
+    unsafe { raw::qspi_deinit(smif_id) }
+}
+
+pub fn erase_size() -> u32 {
+    unsafe { raw::qspi_get_erase_size() }
+}
+
+pub fn mem_size() -> u32 {
+    unsafe { raw::qspi_get_mem_size() }
+}
+
+/// Erase [off, off + len) of the external memory, as flash_area_erase does.
+pub fn erase(off: u32, len: u32) -> i32 {
+    unsafe {
+        raw::psoc6_smif_erase((SMIF_BASE + off) as libc::c_long, len as libc::size_t)
+    }
+}
+
+/// Model control: a fresh part 0 on the bus and an erased internal flash.
+pub fn model_reset() {
+    unsafe { raw::cy_model_reset() }
+}
+
+/// Model control: put another part on the bus, `None` for nothing at all.
+pub fn model_set_part(part: Option<u32>) {
+    unsafe { raw::cy_model_set_part(part.map_or(-1, |p| p as libc::c_int)) }
+}
+
+/// Model control: the number of SFDP discoveries run so far.
+pub fn model_discoveries() -> u32 {
+    unsafe { raw::cy_model_discoveries() }
+}
+
+/// Model control: flip a bit of the saved parameters.
+pub fn model_corrupt_cache() {
+    unsafe { raw::cy_model_corrupt_cache() }
+}
+
+/// Model control: program the whole memory, and forget the erases so far.
+pub fn model_program_all() {
+    unsafe { raw::cy_model_program_all() }
+}
+
+/// Model control: the number of erased 4 KB granules in [off, off + len).
+pub fn model_erased(off: u32, len: u32) -> u32 {
+    unsafe { raw::cy_model_erased(off, len) }
+}
+
+/// Model control: the number of erase commands so far.
+pub fn model_erase_ops() -> u32 {
+    unsafe { raw::cy_model_erase_ops() }
+}
+
+/// Model control: the typical time the erases so far took, in ms.
+pub fn model_erase_time() -> u32 {
+    unsafe { raw::cy_model_erase_time() }
+}
+
+/// Model control: whether the driver was initialized with the parameters of
+/// the part on the bus.
+pub fn model_config_matches() -> bool {
+    unsafe { raw::cy_model_config_matches() != 0 }
+}
+
+mod raw {
+    extern "C" {
+        pub fn qspi_init_sfdp(smif_id: u32) -> u32;
+        pub fn qspi_deinit(smif_id: u32);
+        pub fn qspi_get_erase_size() -> u32;
+        pub fn qspi_get_mem_size() -> u32;
+        pub fn psoc6_smif_erase(addr: libc::c_long, size: libc::size_t) -> libc::c_int;
+
+        pub fn cy_model_reset();
+        pub fn cy_model_set_part(index: libc::c_int);
+        pub fn cy_model_discoveries() -> u32;
+        pub fn cy_model_corrupt_cache();
+        pub fn cy_model_config_matches() -> libc::c_int;
+        pub fn cy_model_program_all();
+        pub fn cy_model_erased(off: u32, len: u32) -> u32;
+        pub fn cy_model_erase_ops() -> u32;
+        pub fn cy_model_erase_time() -> u32;
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::sync::Mutex;
+
+    // The model is global, so the tests take turns.
+    static MODEL: Mutex<()> = Mutex::new(());
+
+    fn boot(discoveries: u32) {
+        assert_eq!(init_sfdp(1), 0);
+        assert_eq!(model_discoveries(), discoveries);
+        assert!(model_config_matches());
+    }
+
+    #[test]
+    fn sfdp_cache() {
+        let _model = MODEL.lock().unwrap_or_else(|e| e.into_inner());
+        model_reset();
+
+        // The first boot runs the discovery and saves what it found, the
+        // next ones use it.
+        boot(1);
+        assert_eq!(erase_size(), 0x40000);
+        deinit(1);
+        boot(1);
+        assert_eq!(erase_size(), 0x40000);
+        deinit(1);
+
+        // Another part has another JEDEC ID.
+        model_set_part(Some(1));
+        boot(2);
+        assert_eq!(erase_size(), 0x1000);
+        deinit(1);
+        boot(2);
+        deinit(1);
+
+        // A damaged cache is not used, but replaced.
+        model_corrupt_cache();
+        boot(3);
+        deinit(1);
+        boot(3);
+        deinit(1);
+
+        // Without a part, nothing is used or saved.
+        model_set_part(None);
+        assert_ne!(init_sfdp(1), 0);
+        assert_eq!(model_discoveries(), 4);
+        deinit(1);
+        model_set_part(Some(1));
+        boot(4);
+        deinit(1);
+    }
+
+    /// Erase the region covering [off, off + len) and check that exactly
+    /// [start, end) is erased.
+    fn check_erase(off: u32, len: u32, start: u32, end: u32) {
+        model_program_all();
+        assert_eq!(erase(off, len), 0);
+        assert_eq!(model_erased(start, end - start), (end - start) / 4096);
+        assert_eq!(model_erased(0, mem_size()), (end - start) / 4096);
+    }
+
+    #[test]
+    fn erase_plan() {
+        let _model = MODEL.lock().unwrap_or_else(|e| e.into_inner());
+        const SLOT_OFF: u32 = 0x40000;
+        const SLOT_SIZE: u32 = 0xC0000;
+
+        model_reset();
+        for part in 0..4 {
+            model_set_part(Some(part));
+
+            // The second boot gets the erase types from the cache.
+            for _ in 0..2 {
+                assert_eq!(init_sfdp(1), 0);
+
+                // One sector of the device configuration at a time, as the
+                // bootloader used to.
+                model_program_all();
+                let sector = erase_size();
+                for off in (0..SLOT_SIZE).step_by(sector as usize) {
+                    assert_eq!(erase(SLOT_OFF + off, sector), 0);
+                }
+                let sector_time = model_erase_time();
+
+                check_erase(SLOT_OFF, SLOT_SIZE, SLOT_OFF, SLOT_OFF + SLOT_SIZE);
+                let time = model_erase_time();
+                match part {
+                    // 4 KB sectors in the device configuration, and larger
+                    // blocks in the SFDP.
+                    1 | 2 => assert!(time * 2 < sector_time,
+                                     "part {}: {} ms vs {} ms", part, time, sector_time),
+                    // Only the sector of the device configuration can be
+                    // used everywhere.
+                    _ => assert_eq!(time, sector_time),
+                }
+
+                // The whole memory at once.
+                check_erase(0, mem_size(), 0, mem_size());
+                assert_eq!(model_erase_ops(), 1);
+
+                // Anything else is rounded out to the smallest block.
+                let min = if part == 1 || part == 2 { 0x1000 } else { erase_size() };
+                check_erase(min + 0x234, 10, min, 2 * min);
+                assert_eq!(model_erase_ops(), 1);
+
+                deinit(1);
+            }
+        }
+
+        // The smaller blocks are only used at the edges: 7 * 4 KB, 32 KB,
+        // 6 * 64 KB, 32 KB and 7 * 4 KB.
+        model_set_part(Some(1));
+        assert_eq!(init_sfdp(1), 0);
+        check_erase(0x41000, 0x7E000, 0x41000, 0xBF000);
+        assert_eq!(model_erase_ops(), 22);
+        deinit(1);
+    }
+}
@@ -7,10 +7,15 @@
 //!
 //! This module is capable of simulating the type of NOR flash commonly used in microcontrollers.
 //! These generally can be written as individual bytes, but must be erased in larger units.
+//!
+//! The contents are stored sparsely (see `sparse`), so that large external flash parts are cheap
+//! to create and clone as long as most of them stay erased.
 
 mod pdump;
+mod sparse;
 
 use crate::pdump::HexDump;
+use crate::sparse::SparseStore;
 use failure::Fail;
 use log::info;
 use rand::{
@@ -72,6 +77,10 @@ pub trait Flash {
 
     fn align(&self) -> usize;
     fn erased_val(&self) -> u8;
+
+    /// A count of the writes and erases of the device, as a flash driver
+    /// would keep for a warm boot.
+    fn generation(&self) -> u32;
 }
 
 fn ebounds<T: AsRef<str>>(message: T) -> FlashError {
@@ -88,18 +97,21 @@ fn esimulatedwrite<T: AsRef<str>>(message: T) -> FlashError {
     FlashError::SimulatedFail(message.as_ref().to_owned())
 }
 
-/// An emulated flash device.  It is represented as a block of bytes, and a list of the sector
-/// mappings.
+/// An emulated flash device.  It is represented as a sparse block of bytes, and a list of the
+/// sector mappings.
 #[derive(Clone)]
 pub struct SimFlash {
-    data: Vec<u8>,
-    write_safe: Vec<bool>,
+    data: SparseStore,
     sectors: Vec<usize>,
+    // Offset of the start of each sector, plus the device size as the last element.
+    sector_starts: Vec<usize>,
     bad_region: Vec<(usize, usize, f32)>,
     // Alignment required for writes.
     align: usize,
     verify_writes: bool,
     erased_val: u8,
+    // Count of the writes and erases, including the failed writes.
+    generation: u32,
 }
 
 impl SimFlash {
@@ -109,42 +121,57 @@ impl SimFlash {
         assert!(align > 0);
         assert!(align & (align - 1) == 0);
 
-        let total = sectors.iter().sum();
+        let mut sector_starts = Vec::with_capacity(sectors.len() + 1);
+        let mut total = 0;
+        sector_starts.push(0);
+        for &size in &sectors {
+            total += size;
+            sector_starts.push(total);
+        }
+
         SimFlash {
-            data: vec![erased_val; total],
-            write_safe: vec![true; total],
+            data: SparseStore::new(total, erased_val),
             sectors: sectors,
+            sector_starts: sector_starts,
             bad_region: Vec::new(),
             align: align,
             verify_writes: true,
             erased_val: erased_val,
+            generation: 0,
         }
     }
 
     #[allow(dead_code)]
     pub fn dump(&self) {
-        self.data.dump();
+        self.data.to_vec().dump();
     }
 
     /// Dump this image to the given file.
     #[allow(dead_code)]
     pub fn write_file<P: AsRef<Path>>(&self, path: P) -> Result<()> {
         let mut fd = File::create(path)?;
-        fd.write_all(&self.data)?;
+        fd.write_all(&self.data.to_vec())?;
         Ok(())
     }
 
-    // Scan the sector map, and return the base and offset within a sector for this given byte.
-    // Returns None if the value is outside of the device.
+    /// The number of storage pages currently allocated for the device contents.
+    #[allow(dead_code)]
+    pub fn allocated_pages(&self) -> usize {
+        self.data.allocated_pages()
+    }
+
+    // Look up the sector map, and return the sector and offset within that sector for this given
+    // byte.  Returns None if the value is outside of the device.
     fn get_sector(&self, offset: usize) -> Option<(usize, usize)> {
-        let mut offset = offset;
-        for (sector, &size) in self.sectors.iter().enumerate() {
-            if offset < size {
-                return Some((sector, offset));
-            }
-            offset -= size;
+        if offset >= self.data.len() {
+            return None;
         }
-        return None;
+        // The first sector starting after the offset follows the one holding it.
+        let sector = match self.sector_starts.binary_search(&offset) {
+            Ok(sector) => sector,
+            Err(next) => next - 1,
+        };
+        Some((sector, offset - self.sector_starts[sector]))
     }
 
 }
@@ -166,13 +193,8 @@ impl Flash for SimFlash {
             bail!(ebounds("end not at start of sector"));
         }
 
-        for x in &mut self.data[offset .. offset + len] {
-            *x = self.erased_val;
-        }
-
-        for x in &mut self.write_safe[offset .. offset + len] {
-            *x = true;
-        }
+        self.generation = self.generation.wrapping_add(1);
+        self.data.erase(offset, len);
 
         Ok(())
     }
@@ -186,6 +208,8 @@ impl Flash for SimFlash {
     /// added restriction that repeated writes to the same location
     /// are disallowed, even if they would be safe to do.
     fn write(&mut self, offset: usize, payload: &[u8]) -> Result<()> {
+        self.generation = self.generation.wrapping_add(1);
+
         for &(off, len, rate) in &self.bad_region {
             if offset >= off && (offset + payload.len()) <= (off + len) {
                 let mut rng = rand::thread_rng();
@@ -210,15 +234,13 @@ impl Flash for SimFlash {
             panic!("Write length not multiple of alignment");
         }
 
-        for (i, x) in &mut self.write_safe[offset .. offset + payload.len()].iter_mut().enumerate() {
-            if self.verify_writes && !(*x) {
-                panic!("Write to unerased location at 0x{:x}", offset + i);
+        if self.verify_writes {
+            if let Some(pos) = self.data.first_written(offset, payload.len()) {
+                panic!("Write to unerased location at 0x{:x}", pos);
             }
-            *x = false;
         }
 
-        let sub = &mut self.data[offset .. offset + payload.len()];
-        sub.copy_from_slice(payload);
+        self.data.write(offset, payload);
         Ok(())
     }
 
@@ -228,8 +250,7 @@ impl Flash for SimFlash {
             bail!(ebounds("Read outside of device"));
         }
 
-        let sub = &self.data[offset .. offset + data.len()];
-        data.copy_from_slice(sub);
+        self.data.read(offset, data);
         Ok(())
     }
 
@@ -273,6 +294,10 @@ impl Flash for SimFlash {
     fn erased_val(&self) -> u8 {
         self.erased_val
     }
+
+    fn generation(&self) -> u32 {
+        self.generation
+    }
 }
 
 /// It is possible to iterate over the sectors in the device, each element returning this.
@@ -328,6 +353,38 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_large_flash() {
+        for &erased_val in &[0, 0xff] {
+            // A 256 MB QSPI part with 4 KB sectors.
+            let mut f1 = SimFlash::new(vec![4096usize; 65536], 1, erased_val);
+            assert_eq!(f1.allocated_pages(), 0);
+
+            let last = f1.device_size() - 4096;
+            f1.write(last + 4092, &[1, 2, 3, 4]).unwrap();
+            assert_eq!(f1.allocated_pages(), 1);
+
+            // Clones share the pages until they are written.
+            let mut f2 = f1.clone();
+            f2.erase(last, 4096).unwrap();
+            f2.write(0, &[5]).unwrap();
+
+            let mut buf = [0; 4];
+            f1.read(last + 4092, &mut buf).unwrap();
+            assert_eq!(buf, [1, 2, 3, 4]);
+            f1.read(0, &mut buf[..1]).unwrap();
+            assert_eq!(buf[0], erased_val);
+
+            f2.read(last + 4092, &mut buf).unwrap();
+            assert_eq!(buf, [erased_val; 4]);
+            assert_eq!(f2.allocated_pages(), 1);
+
+            // The sector index is used for erases at the end of the device.
+            assert!(f1.erase(last + 1, 4095).is_bounds());
+            assert!(f1.erase(last, 4097).is_bounds());
+        }
+    }
+
     fn test_device(flash: &mut dyn Flash, erased_val: u8) {
         let sectors: Vec<Sector> = flash.sector_iter().collect();
 
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+
+//! Sparse backing store for the flash simulator.
+//!
+//! The device contents are kept in fixed-size pages.  A page is only allocated once it is
+//! written, and goes back to being implicit (all erased, all writable) when it is erased as a
+//! whole.  Each page also tracks, one bit per byte, which bytes have been written since they
+//! were last erased.  Pages are shared between clones of the store and copied on write, so
+//! cloning a large, mostly erased device is cheap.
+
+use std::sync::Arc;
+
+/// Size of a storage page, in bytes.
+pub const PAGE_SIZE: usize = 4096;
+
+const WORD_BITS: usize = 64;
+
+#[derive(Clone)]
+struct Page {
+    data: Vec<u8>,
+    written: Vec<u64>,
+}
+
+impl Page {
+    fn new(erased_val: u8) -> Page {
+        Page {
+            data: vec![erased_val; PAGE_SIZE],
+            written: vec![0; PAGE_SIZE / WORD_BITS],
+        }
+    }
+
+    fn is_written(&self, pos: usize) -> bool {
+        self.written[pos / WORD_BITS] & (1 << (pos % WORD_BITS)) != 0
+    }
+
+    fn set_written(&mut self, pos: usize, written: bool) {
+        let mask = 1 << (pos % WORD_BITS);
+        if written {
+            self.written[pos / WORD_BITS] |= mask;
+        } else {
+            self.written[pos / WORD_BITS] &= !mask;
+        }
+    }
+}
+
+#[derive(Clone)]
+pub struct SparseStore {
+    pages: Vec<Option<Arc<Page>>>,
+    size: usize,
+    erased_val: u8,
+}
+
+impl SparseStore {
+    /// Create a fully erased store of `size` bytes.  No page is allocated.
+    pub fn new(size: usize, erased_val: u8) -> SparseStore {
+        SparseStore {
+            pages: vec![None; (size + PAGE_SIZE - 1) / PAGE_SIZE],
+            size: size,
+            erased_val: erased_val,
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.size
+    }
+
+    /// The number of pages which are currently allocated.
+    pub fn allocated_pages(&self) -> usize {
+        self.pages.iter().filter(|p| p.is_some()).count()
+    }
+
+    // Split the range into (page, offset within the page, length) chunks.
+    fn chunks(offset: usize, len: usize) -> impl Iterator<Item = (usize, usize, usize)> {
+        let end = offset + len;
+        let mut pos = offset;
+        std::iter::from_fn(move || {
+            if pos >= end {
+                return None;
+            }
+            let page = pos / PAGE_SIZE;
+            let start = pos % PAGE_SIZE;
+            let count = (PAGE_SIZE - start).min(end - pos);
+            pos += count;
+            Some((page, start, count))
+        })
+    }
+
+    fn page_mut(&mut self, page: usize) -> &mut Page {
+        let erased_val = self.erased_val;
+        let entry = self.pages[page].get_or_insert_with(|| Arc::new(Page::new(erased_val)));
+        Arc::make_mut(entry)
+    }
+
+    /// Copy the contents of the range starting at `offset` into `data`.
+    pub fn read(&self, offset: usize, data: &mut [u8]) {
+        let mut done = 0;
+        for (page, start, count) in Self::chunks(offset, data.len()) {
+            let dst = &mut data[done .. done + count];
+            match self.pages[page] {
+                None => {
+                    for x in dst.iter_mut() {
+                        *x = self.erased_val;
+                    }
+                }
+                Some(ref p) => dst.copy_from_slice(&p.data[start .. start + count]),
+            }
+            done += count;
+        }
+    }
+
+    /// Return the offset of the first byte in the range that has been written since it was
+    /// erased, if any.
+    pub fn first_written(&self, offset: usize, len: usize) -> Option<usize> {
+        for (page, start, count) in Self::chunks(offset, len) {
+            if let Some(ref p) = self.pages[page] {
+                if let Some(pos) = (start .. start + count).find(|&pos| p.is_written(pos)) {
+                    return Some(page * PAGE_SIZE + pos);
+                }
+            }
+        }
+        None
+    }
+
+    /// Store `payload` at `offset`, and mark the range as written.
+    pub fn write(&mut self, offset: usize, payload: &[u8]) {
+        let mut done = 0;
+        for (page, start, count) in Self::chunks(offset, payload.len()) {
+            let p = self.page_mut(page);
+            p.data[start .. start + count].copy_from_slice(&payload[done .. done + count]);
+            for pos in start .. start + count {
+                p.set_written(pos, true);
+            }
+            done += count;
+        }
+    }
+
+    /// Erase the range.  Pages covered completely are released.
+    pub fn erase(&mut self, offset: usize, len: usize) {
+        let erased_val = self.erased_val;
+        for (page, start, count) in Self::chunks(offset, len) {
+            if count == PAGE_SIZE {
+                self.pages[page] = None;
+            } else if self.pages[page].is_some() {
+                let p = self.page_mut(page);
+                for pos in start .. start + count {
+                    p.data[pos] = erased_val;
+                    p.set_written(pos, false);
+                }
+            }
+        }
+    }
+
+    /// Return the whole contents as a contiguous buffer.
+    pub fn to_vec(&self) -> Vec<u8> {
+        let mut data = vec![0; self.size];
+        self.read(0, &mut data);
+        data
+    }
+}
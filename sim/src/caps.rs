@@ -25,6 +25,15 @@ pub enum Caps {
     DowngradePrevention  = (1 << 12),
     EncX25519            = (1 << 13),
     Bootstrap            = (1 << 14),
+    HashBlocks           = (1 << 15),
+    Lms                  = (1 << 16),
+    SwapUsingOffset      = (1 << 17),
+    CompactTrailer       = (1 << 18),
+    StagedBoot           = (1 << 19),
+    EraseSkipErased      = (1 << 20),
+    EncAead              = (1 << 21),
+    DirectXip            = (1 << 22),
+    WarmBoot             = (1 << 23),
 }
 
 impl Caps {
@@ -38,9 +47,31 @@ impl Caps {
     pub fn get_num_images() -> usize {
         (unsafe { bootutil_get_num_images() }) as usize
     }
+
+    /// Query for the number of slots per image that have been configured
+    /// into this MCUboot build.
+    pub fn get_num_slots() -> usize {
+        (unsafe { bootutil_get_num_slots() }) as usize
+    }
+
+    /// Query for the number of times an image which is not confirmed is
+    /// booted before it is rejected, 0 if this build has no attempt counter.
+    pub fn get_boot_attempts() -> usize {
+        (unsafe { bootutil_get_boot_attempts() }) as usize
+    }
+
+    /// Does this build upgrade images by writing them to the primary slot.
+    /// The tests of the upgrades and of their recovery only apply to these
+    /// builds.
+    pub fn modifies_flash() -> bool {
+        Caps::OverwriteUpgrade.present() || Caps::SwapUsingScratch.present() ||
+            Caps::SwapUsingMove.present() || Caps::SwapUsingOffset.present()
+    }
 }
 
 extern "C" {
     fn bootutil_get_caps() -> Caps;
     fn bootutil_get_num_images() -> u32;
+    fn bootutil_get_num_slots() -> u32;
+    fn bootutil_get_boot_attempts() -> u32;
 }
@@ -5,7 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 use byteorder::{
-    LittleEndian, WriteBytesExt,
+    ByteOrder, LittleEndian, WriteBytesExt,
 };
 use log::{
     Level::Info,
@@ -19,10 +19,12 @@ use rand::{
     rngs::SmallRng,
 };
 use std::{
+    cmp,
     collections::HashSet,
     io::{Cursor, Write},
     mem,
     slice,
+    time::Instant,
 };
 use aes_ctr::{
     Aes128Ctr,
@@ -49,7 +51,7 @@ use crate::depends::{
     PairDep,
     UpgradeInfo,
 };
-use crate::tlv::{ManifestGen, TlvGen, TlvFlags};
+use crate::tlv::{ManifestGen, TlvGen, TlvFlags, TlvKinds};
 
 /// A builder for Images.  This describes a single run of the simulator,
 /// capturing the configuration of a particular set of devices, including
@@ -58,7 +60,7 @@ use crate::tlv::{ManifestGen, TlvGen, TlvFlags};
 pub struct ImagesBuilder {
     flash: SimMultiFlash,
     areadesc: AreaDesc,
-    slots: Vec<[SlotInfo; 2]>,
+    slots: Vec<Vec<SlotInfo>>,
 }
 
 /// Images represents the state of a simulation for a given set of images.
@@ -74,7 +76,7 @@ pub struct Images {
 /// When doing multi-image, there is an instance of this information for
 /// each of the images.  Single image there will be one of these.
 struct OneImage {
-    slots: [SlotInfo; 2],
+    slots: Vec<SlotInfo>,
     primaries: ImageData,
     upgrades: ImageData,
 }
@@ -92,7 +94,7 @@ impl ImagesBuilder {
     /// Some(builder) if is possible to test this configuration, or None if
     /// not possible (for example, if there aren't enough image slots).
     pub fn new(device: DeviceName, align: usize, erased_val: u8) -> Result<Self, String> {
-        let (flash, areadesc, unsupported_caps) = Self::make_device(device, align, erased_val);
+        let (mut flash, areadesc, unsupported_caps) = Self::make_device(device, align, erased_val);
 
         for cap in unsupported_caps {
             if cap.present() {
@@ -100,6 +102,13 @@ impl ImagesBuilder {
             }
         }
 
+        // The compact trailer programs the same write units again.
+        if Caps::CompactTrailer.present() {
+            for dev in flash.values_mut() {
+                dev.set_verify_writes(false);
+            }
+        }
+
         let num_images = Caps::get_num_images();
 
         let mut slots = Vec::with_capacity(num_images);
@@ -125,13 +134,22 @@ impl ImagesBuilder {
                 None => return Err("insufficient partitions".to_string()),
             };
 
-            let offset_from_end = c::boot_magic_sz() + c::boot_max_align() * 4;
+            let offset_from_end = c::boot_magic_sz() + trailer_flags_sz();
+
+            // With swap using offset, upgrade images start one sector into
+            // the secondary slot.
+            let upgrade_off = if Caps::SwapUsingOffset.present() {
+                areadesc.first_sector_size(id1).unwrap()
+            } else {
+                0
+            };
 
             // Construct a primary image.
             let primary = SlotInfo {
                 base_off: primary_base as usize,
                 trailer_off: primary_base + primary_len - offset_from_end,
                 len: primary_len as usize,
+                upgrade_off: 0,
                 dev_id: primary_dev_id,
                 index: 0,
             };
@@ -141,11 +159,37 @@ impl ImagesBuilder {
                 base_off: secondary_base as usize,
                 trailer_off: secondary_base + secondary_len - offset_from_end,
                 len: secondary_len as usize,
+                upgrade_off: upgrade_off,
                 dev_id: secondary_dev_id,
                 index: 1,
             };
 
-            slots.push([primary, secondary]);
+            let mut image_slots = vec![primary, secondary];
+
+            // Direct-xip doesn't use the scratch area, which holds the third
+            // slot, as `flash_area_id_from_multi_image_slot()` maps it.
+            if Caps::get_num_slots() > 2 {
+                if Caps::get_num_slots() > 3 {
+                    panic!("More than 3 slots not supported");
+                }
+                let (extra_base, extra_len, extra_dev_id) = match areadesc.find(FlashId::ImageScratch) {
+                    Some(info) => info,
+                    None => return Err("insufficient partitions".to_string()),
+                };
+                if extra_len < primary_len {
+                    return Err("insufficient partitions".to_string());
+                }
+                image_slots.push(SlotInfo {
+                    base_off: extra_base as usize,
+                    trailer_off: extra_base + extra_len - offset_from_end,
+                    len: extra_len as usize,
+                    upgrade_off: 0,
+                    dev_id: extra_dev_id,
+                    index: 2,
+                });
+            }
+
+            slots.push(image_slots);
         }
 
         Ok(ImagesBuilder {
@@ -205,6 +249,11 @@ impl ImagesBuilder {
             mark_upgrade(&mut images.flash, &image.slots[1]);
         }
 
+        // Nothing is upgraded when the slots are equivalent.
+        if !Caps::modifies_flash() {
+            return images;
+        }
+
         // upgrades without fails, counts number of flash operations
         let total_count = match images.run_basic_upgrade(permanent) {
             Ok(v)  => v,
@@ -220,6 +269,29 @@ impl ImagesBuilder {
         images
     }
 
+    /// Construct an `Images` whose upgrades are small enough for the header,
+    /// the payload and the TLVs to be copied in a single chunk.
+    pub fn make_small_image(self) -> Images {
+        let mut flash = self.flash;
+        let images = self.slots.into_iter().enumerate().map(|(image_num, slots)| {
+            let dep = BoringDep::new(image_num, &NO_DEPS);
+            let primaries = install_image(&mut flash, &slots[0], 42784, &dep, false);
+            let upgrades = install_image(&mut flash, &slots[1], 512, &dep, false);
+            mark_upgrade(&mut flash, &slots[1]);
+            OneImage {
+                slots: slots,
+                primaries: primaries,
+                upgrades: upgrades,
+            }}).collect();
+        install_ptable(&mut flash, &self.areadesc);
+        Images {
+            flash: flash,
+            areadesc: self.areadesc,
+            images: images,
+            total_count: None,
+        }
+    }
+
     pub fn make_bad_secondary_slot_image(self) -> Images {
         let mut bad_flash = self.flash;
         let images = self.slots.into_iter().enumerate().map(|(image_num, slots)| {
@@ -277,6 +349,43 @@ impl ImagesBuilder {
         }
     }
 
+    /// Construct an `Images` for direct-xip, with an image in every slot; the
+    /// higher the slot, the newer the image.  All images are confirmed but
+    /// the newest one, which is only marked for a test.  The primaries are the
+    /// images of the primary slot, the upgrades the ones of the newest slot.
+    pub fn make_xip_image(self) -> Images {
+        let mut flash = self.flash;
+        let images = self.slots.into_iter().enumerate().map(|(image_num, slots)| {
+            let dep = BoringDep::new(image_num, &NO_DEPS);
+            let sizes = [32784, 41928, 37144];
+            let newest = slots.len() - 1;
+            let mut primaries = install_no_image();
+            let mut upgrades = install_no_image();
+            for (index, slot) in slots.iter().enumerate() {
+                let data = install_image(&mut flash, slot, sizes[index], &dep, false);
+                mark_upgrade(&mut flash, slot);
+                if index == 0 {
+                    primaries = data;
+                } else if index == newest {
+                    upgrades = data;
+                }
+                if index != newest {
+                    mark_permanent_upgrade(&mut flash, slot);
+                }
+            }
+            OneImage {
+                slots: slots,
+                primaries: primaries,
+                upgrades: upgrades,
+            }}).collect();
+        Images {
+            flash: flash,
+            areadesc: self.areadesc,
+            images: images,
+            total_count: None,
+        }
+    }
+
     /// Build the Flash and area descriptor for a given device.
     pub fn make_device(device: DeviceName, align: usize, erased_val: u8) -> (SimMultiFlash, AreaDesc, &'static [Caps]) {
         match device {
@@ -295,7 +404,7 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset])
             }
             DeviceName::K64f => {
                 // NXP style flash.  Small sectors, one small sector for scratch.
@@ -326,7 +435,7 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset])
             }
             DeviceName::Nrf52840 => {
                 // Simulating the flash on the nrf52840 with partitions set up so that the scratch size
@@ -355,7 +464,25 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade])
+                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade,
+                                    Caps::SwapUsingOffset])
+            }
+            DeviceName::Nrf52840LargerSecondary => {
+                // The layout swap using offset is meant for: the secondary
+                // slot is one sector larger, for the sector the upgrade
+                // image is written after.
+                let dev = SimFlash::new(vec![4096; 128], align as usize, erased_val);
+
+                let dev_id = 0;
+                let mut areadesc = AreaDesc::new();
+                areadesc.add_flash_sectors(dev_id, &dev);
+                areadesc.add_image(0x008000, 0x03b000, FlashId::Image0, dev_id);
+                areadesc.add_image(0x043000, 0x03c000, FlashId::Image1, dev_id);
+
+                let mut flash = SimMultiFlash::new();
+                flash.insert(dev_id, dev);
+                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade,
+                                    Caps::SwapUsingMove])
             }
             DeviceName::Nrf52840SpiFlash => {
                 // Simulate nrf52840 with external SPI flash. The external SPI flash
@@ -374,7 +501,7 @@ impl ImagesBuilder {
                 let mut flash = SimMultiFlash::new();
                 flash.insert(0, dev0);
                 flash.insert(1, dev1);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset])
             }
             DeviceName::K64fMulti => {
                 // NXP style flash, but larger, to support multiple images.
@@ -460,11 +587,12 @@ impl Images {
     }
 
     fn is_swap_upgrade(&self) -> bool {
-        Caps::SwapUsingScratch.present() || Caps::SwapUsingMove.present()
+        Caps::SwapUsingScratch.present() || Caps::SwapUsingMove.present() ||
+            Caps::SwapUsingOffset.present()
     }
 
     pub fn run_basic_revert(&self) -> bool {
-        if Caps::OverwriteUpgrade.present() {
+        if !Caps::modifies_flash() || Caps::OverwriteUpgrade.present() {
             return false;
         }
 
@@ -485,7 +613,38 @@ impl Images {
         fails > 0
     }
 
+    /// Upgrade to, and for swaps revert from, an image that fits in one copy
+    /// chunk.  When encrypted, only its payload may be decrypted, never the
+    /// TLVs that follow it in the same chunk.
+    pub fn run_small_upgrade(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
+        let mut fails = 0;
+
+        let (flash, _) = self.try_upgrade(None, false);
+        if !self.verify_images(&flash, 0, 1) {
+            error!("Small image was not upgraded");
+            fails += 1;
+        }
+
+        if self.is_swap_upgrade() {
+            let flash = self.try_revert(2);
+            if !self.verify_images(&flash, 0, 0) {
+                error!("Small image was not reverted");
+                fails += 1;
+            }
+        }
+
+        fails > 0
+    }
+
     pub fn run_perm_with_fails(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
         let mut fails = 0;
         let total_flash_ops = self.total_count.unwrap();
 
@@ -529,6 +688,10 @@ impl Images {
     }
 
     pub fn run_perm_with_random_fails(&self, total_fails: usize) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
         let mut fails = 0;
         let total_flash_ops = self.total_count.unwrap();
         let (flash, total_counts) = self.try_random_fails(total_flash_ops, total_fails);
@@ -567,7 +730,7 @@ impl Images {
     }
 
     pub fn run_revert_with_fails(&self) -> bool {
-        if Caps::OverwriteUpgrade.present() {
+        if !Caps::modifies_flash() || Caps::OverwriteUpgrade.present() {
             return false;
         }
 
@@ -587,7 +750,7 @@ impl Images {
     }
 
     pub fn run_norevert(&self) -> bool {
-        if Caps::OverwriteUpgrade.present() {
+        if !Caps::modifies_flash() || Caps::OverwriteUpgrade.present() {
             return false;
         }
 
@@ -689,6 +852,10 @@ impl Images {
     // image_ok set while there is no image on the secondary slot, so no revert
     // should ever happen...
     pub fn run_norevert_newimage(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
         let mut flash = self.flash.clone();
         let mut fails = 0;
 
@@ -738,6 +905,10 @@ impl Images {
     // image_ok set while there is no image on the secondary slot, so no revert
     // should ever happen...
     pub fn run_signfail_upgrade(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
         let mut flash = self.flash.clone();
         let mut fails = 0;
 
@@ -781,6 +952,10 @@ impl Images {
     // Should detect there is a leftover trailer in an otherwise erased
     // secondary slot and erase its trailer.
     pub fn run_secondary_leftover_trailer(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
         let mut flash = self.flash.clone();
         let mut fails = 0;
 
@@ -827,7 +1002,7 @@ impl Images {
     /// allowing for fails in the status area. This should run to the end
     /// and warn that write fails were detected...
     pub fn run_with_status_fails_complete(&self) -> bool {
-        if !Caps::ValidatePrimarySlot.present() {
+        if !Caps::modifies_flash() || !Caps::ValidatePrimarySlot.present() {
             return false;
         }
 
@@ -882,7 +1057,7 @@ impl Images {
     /// allowing for fails in the status area. This should run to the end
     /// and warn that write fails were detected...
     pub fn run_with_status_fails_with_reset(&self) -> bool {
-        if Caps::OverwriteUpgrade.present() {
+        if !Caps::modifies_flash() || Caps::OverwriteUpgrade.present() {
             false
         } else if Caps::ValidatePrimarySlot.present() {
 
@@ -944,6 +1119,534 @@ impl Images {
         }
     }
 
+    /// Staged boot: Image 1 is deferred, and checked only after Image 0 is
+    /// handed over.  With the image in the primary slot of Image 1
+    /// corrupted, Image 0 is still booted and the deferred check reports
+    /// Image 1; unless Image 0 depends on it, in which case Image 1 is
+    /// checked before the handoff and the boot fails.  The staged-boot
+    /// feature brings in the validation of the primary slots, which this
+    /// relies on.
+    pub fn run_staged_boot(&self, deps: &DepTest) -> bool {
+        if !Caps::StagedBoot.present() {
+            return false;
+        }
+        assert!(Caps::ValidatePrimarySlot.present() && self.images.len() == 2,
+                "Staged boot is tested with two validated primary slots");
+
+        let mut fails = 0;
+        let (mut flash, _) = self.try_upgrade(None, true);
+        let depends = match deps.depends[0] {
+            DepType::Nothing => false,
+            _ => true,
+        };
+
+        let (result, _) = c::boot_go(&mut flash, &self.areadesc, None, false);
+        if result != 0 || c::boot_deferred_failed() != 0 {
+            warn!("Failed boot with valid images");
+            fails += 1;
+        }
+
+        self.corrupt_slot(&mut flash, 1, 0);
+
+        let (result, _) = c::boot_go(&mut flash, &self.areadesc, None, false);
+        if depends {
+            if result == 0 {
+                warn!("Image 0 booted before the image it depends on was checked");
+                fails += 1;
+            }
+        } else {
+            if result != 0 {
+                warn!("Image 0 held back by a deferred image");
+                fails += 1;
+            }
+            if c::boot_deferred_failed() != 1 << 1 {
+                warn!("Deferred check didn't report Image 1");
+                fails += 1;
+            }
+        }
+
+        if fails > 0 {
+            error!("Expected Image 1 to be checked {} the handoff",
+                   if depends { "before" } else { "after" });
+        }
+
+        fails > 0
+    }
+
+    /// Prepare the upgrades from the running images with boot_prestage(),
+    /// stopping it after each flash operation and running it again: the next
+    /// boot must upgrade all of them, with no more flash operations than
+    /// without the preparation.
+    pub fn run_prestage(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
+        let mut fails = 0;
+
+        let mut flash = self.flash.clone();
+        self.mark_upgrades(&mut flash, 1);
+        let mut counter = 0;
+        let _ = c::boot_go(&mut flash, &self.areadesc, Some(&mut counter), false);
+        let upgrade_count = -counter;
+
+        let mut flash = self.flash.clone();
+        let prestage_count = match self.try_prestage(&mut flash, None) {
+            Some(count) => count,
+            None => panic!("Preparation of the upgrades failed"),
+        };
+        let mut counter = 0;
+        let (result, _) = c::boot_go(&mut flash, &self.areadesc, Some(&mut counter), false);
+        if result != 0 || !self.verify_images(&flash, 0, 1) {
+            warn!("Failed upgrade after the preparation");
+            fails += 1;
+        }
+        if Caps::EraseSkipErased.present() && -counter > upgrade_count {
+            warn!("Prepared upgrade took {} flash operations instead of {}",
+                  -counter, upgrade_count);
+            fails += 1;
+        }
+
+        for stop in 1 .. prestage_count + 1 {
+            let mut flash = self.flash.clone();
+            if self.try_prestage(&mut flash, Some(stop)).is_some() {
+                warn!("Should have stopped the preparation at {}", stop);
+                fails += 1;
+            }
+            if self.try_prestage(&mut flash, None).is_none() {
+                warn!("Failed preparation after a stop at {}", stop);
+                fails += 1;
+                continue;
+            }
+            let (result, _) = c::boot_go(&mut flash, &self.areadesc, None, false);
+            if result != 0 || !self.verify_images(&flash, 0, 1) {
+                warn!("Failed upgrade after a preparation stopped at {}", stop);
+                fails += 1;
+            }
+        }
+
+        if fails > 0 {
+            error!("Expected an upgrade after the preparation");
+        }
+
+        fails > 0
+    }
+
+    /// boot_prestage() must refuse an image with a bad signature, and leave
+    /// it not pending.
+    pub fn run_prestage_bad_image(&self) -> bool {
+        if !Caps::modifies_flash() {
+            return false;
+        }
+
+        // Encrypted images are only checked by the swap.
+        if Caps::EncRsa.present() || Caps::EncKw.present() ||
+            Caps::EncEc256.present() || Caps::EncX25519.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        for image_num in 0 .. self.images.len() {
+            if c::prestage(&mut flash, &self.areadesc, image_num, false, None) == 0 {
+                warn!("Image {} with a bad signature was accepted", image_num);
+                fails += 1;
+            }
+        }
+
+        if !self.verify_trailers(&flash, 1, BOOT_MAGIC_UNSET,
+                                 BOOT_FLAG_UNSET, BOOT_FLAG_UNSET) {
+            warn!("Image with a bad signature marked pending");
+            fails += 1;
+        }
+
+        let (result, _) = c::boot_go(&mut flash, &self.areadesc, None, false);
+        if result != 0 || !self.verify_images(&flash, 0, 0) {
+            warn!("Failed boot of the running images");
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the preparation to refuse the image");
+        }
+
+        fails > 0
+    }
+
+    /// Direct-xip: the newest valid image is booted, whatever its slot.  An
+    /// image which fails the validation is erased and the next newest one is
+    /// booted instead, down to the image in the primary slot.
+    pub fn run_xip_select(&self) -> bool {
+        if !Caps::DirectXip.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+        let slots = &self.images[0].slots;
+        let newest = slots.len() - 1;
+
+        mark_permanent_upgrade(&mut flash, &slots[newest]);
+
+        for slot in (0 .. newest + 1).rev() {
+            let booted = self.boot_slot(&mut flash);
+            if booted != Some(slot) {
+                warn!("Booted {:?} instead of slot {}", booted, slot);
+                fails += 1;
+            }
+            if slot == newest && !self.verify_images(&flash, newest, 1) {
+                warn!("Image in slot {} modified by the boot", slot);
+                fails += 1;
+            }
+
+            self.corrupt_slot(&mut flash, 0, slot);
+        }
+
+        if let Some(slot) = self.boot_slot(&mut flash) {
+            warn!("Booted slot {} with no valid image left", slot);
+            fails += 1;
+        }
+
+        for slot in slots {
+            if !verify_trailer(&flash, slot, BOOT_MAGIC_UNSET, None, None) {
+                warn!("Invalid image in slot {} not erased", slot.index);
+                fails += 1;
+            }
+        }
+
+        if fails > 0 {
+            error!("Expected the newest valid image to be booted");
+        }
+
+        fails > 0
+    }
+
+    /// Direct-xip revert: an image which is not confirmed is booted once, or
+    /// as many times as the boot attempts allow, then the previous image is
+    /// booted instead.  The rejected image is erased, unless the build counts
+    /// the boot attempts, which leaves it intact.
+    pub fn run_xip_revert(&self) -> bool {
+        if !Caps::DirectXip.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+        let slots = &self.images[0].slots;
+        let newest = slots.len() - 1;
+        let attempts = Caps::get_boot_attempts();
+
+        for attempt in 0 .. cmp::max(attempts, 1) {
+            let booted = self.boot_slot(&mut flash);
+            if booted != Some(newest) {
+                warn!("Attempt {} booted {:?} instead of slot {}", attempt, booted,
+                      newest);
+                fails += 1;
+            }
+        }
+
+        // The rejection sticks, whatever the number of boots.
+        for _ in 0 .. 2 {
+            let booted = self.boot_slot(&mut flash);
+            if booted != Some(newest - 1) {
+                warn!("Booted {:?} instead of reverting to slot {}", booted,
+                      newest - 1);
+                fails += 1;
+            }
+        }
+
+        if attempts > 0 {
+            if !self.verify_images(&flash, newest, 1) {
+                warn!("Image rejected after {} attempts was modified", attempts);
+                fails += 1;
+            }
+        } else if !verify_trailer(&flash, &slots[newest], BOOT_MAGIC_UNSET,
+                                  None, None) {
+            warn!("Reverted image in slot {} not erased", newest);
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the image which is not confirmed to be reverted");
+        }
+
+        fails > 0
+    }
+
+    /// Direct-xip: once confirmed, an image is booted however many boot
+    /// attempts it used before.
+    pub fn run_xip_confirm(&self) -> bool {
+        if !Caps::DirectXip.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+        let slots = &self.images[0].slots;
+        let newest = slots.len() - 1;
+        let attempts = cmp::max(Caps::get_boot_attempts(), 1);
+
+        // Use up all the attempts, then confirm the image from the last one.
+        for _ in 0 .. attempts {
+            let booted = self.boot_slot(&mut flash);
+            if booted != Some(newest) {
+                warn!("Booted {:?} instead of slot {}", booted, newest);
+                fails += 1;
+            }
+        }
+
+        mark_permanent_upgrade(&mut flash, &slots[newest]);
+
+        for count in 0 .. attempts + 2 {
+            let booted = self.boot_slot(&mut flash);
+            if booted != Some(newest) {
+                warn!("Boot {} after confirm booted {:?} instead of slot {}",
+                      count, booted, newest);
+                fails += 1;
+            }
+        }
+
+        if !self.verify_images(&flash, newest, 1) {
+            warn!("Confirmed image in slot {} modified", newest);
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the confirmed image to be kept");
+        }
+
+        fails > 0
+    }
+
+    /// Block hashed images: a range of the image in the primary slot checks
+    /// out until a block it overlaps is corrupted, while the ranges which
+    /// miss the corrupted block still check out.
+    pub fn run_check_blocks(&self) -> bool {
+        if !Caps::HashBlocks.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        for (image_num, image) in self.images.iter().enumerate() {
+            let size = hashed_size(&flash, &image.slots[0]);
+            let check = |flash: &mut SimMultiFlash, off: u32, len: u32| {
+                c::check_blocks(flash, &self.areadesc, image_num, 0, off, len)
+            };
+
+            if check(&mut flash, 0, size) != 0 {
+                warn!("Image {} does not check out", image_num);
+                fails += 1;
+            }
+
+            // Damages the first block, past the header.
+            self.corrupt_slot(&mut flash, image_num, 0);
+
+            if check(&mut flash, 0, size) == 0 {
+                warn!("Image {} checks out with a corrupted block", image_num);
+                fails += 1;
+            }
+            if check(&mut flash, 256, 1) == 0 {
+                warn!("Corrupted range of image {} checks out", image_num);
+                fails += 1;
+            }
+            if check(&mut flash, HASH_BLOCK_SIZE, size - HASH_BLOCK_SIZE) != 0 {
+                warn!("Intact blocks of image {} do not check out", image_num);
+                fails += 1;
+            }
+        }
+
+        if fails > 0 {
+            error!("Expected only the corrupted block to fail the check");
+        }
+
+        fails > 0
+    }
+
+    /// Warm boot: after a warm reset which left the flash alone, the image
+    /// recorded by the previous boot is booted without reading the slots.  A
+    /// cold reset always goes the normal way.
+    pub fn run_warm_cold(&self) -> bool {
+        if !Caps::WarmBoot.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        for (count, &warm) in [false, true, true, false, true].iter().enumerate() {
+            let (full, booted) = self.warm_boot(&mut flash, warm);
+            if booted != Some(0) {
+                warn!("Boot {} booted {:?} instead of the primary slot", count, booted);
+                fails += 1;
+            }
+            if full == warm {
+                warn!("Boot {} after a {} reset {} the slots", count,
+                      if warm { "warm" } else { "cold" },
+                      if full { "read" } else { "did not read" });
+                fails += 1;
+            }
+        }
+
+        if fails > 0 {
+            error!("Expected only the warm resets to skip the slots");
+        }
+
+        fails > 0
+    }
+
+    /// Warm boot: a write to the flash since the recorded boot, even one
+    /// which leaves it as it was, sends the boot the normal way, which
+    /// performs the upgrade the image asked for.
+    pub fn run_warm_generation(&self) -> bool {
+        if !Caps::WarmBoot.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        self.warm_boot(&mut flash, false);
+        self.rewrite_slot(&mut flash, 0, 1, 0);
+
+        let (full, _) = self.warm_boot(&mut flash, true);
+        if !full {
+            warn!("Warm reset skipped the slots after a flash write");
+            fails += 1;
+        }
+
+        let (full, _) = self.warm_boot(&mut flash, true);
+        if full {
+            warn!("Warm reset read the slots again");
+            fails += 1;
+        }
+
+        self.mark_upgrades(&mut flash, 1);
+        self.mark_permanent_upgrades(&mut flash, 1);
+
+        let (full, booted) = self.warm_boot(&mut flash, true);
+        if !full || booted != Some(0) || !self.verify_images(&flash, 0, 1) {
+            warn!("Warm reset skipped the upgrade asked for by the image");
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the flash writes to invalidate the recorded boot");
+        }
+
+        fails > 0
+    }
+
+    /// Warm boot: a recorded boot redirected to the secondary slot without
+    /// the key of its MAC is dropped, and the boot goes the normal way.
+    pub fn run_warm_forged(&self) -> bool {
+        if !Caps::WarmBoot.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        self.warm_boot(&mut flash, false);
+        assert!(c::warm_forge(self.images[0].slots[1].base_off));
+
+        let (full, booted) = self.warm_boot(&mut flash, true);
+        if !full || booted != Some(0) {
+            warn!("Forged boot state followed, booted {:?}", booted);
+            fails += 1;
+        }
+
+        // The boot that went the normal way is recorded in its place.
+        let (full, booted) = self.warm_boot(&mut flash, true);
+        if full || booted != Some(0) {
+            warn!("Boot state not recorded again, booted {:?}", booted);
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the forged boot state to be dropped");
+        }
+
+        fails > 0
+    }
+
+    /// Warm boot: a test image is recorded with the trailers calling for a
+    /// revert, which a warm reset still performs.
+    pub fn run_warm_revert(&self) -> bool {
+        if !Caps::WarmBoot.present() || Caps::OverwriteUpgrade.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+
+        let (_, booted) = self.warm_boot(&mut flash, false);
+        if booted != Some(0) || !self.verify_images(&flash, 0, 1) {
+            warn!("Test image not booted");
+            fails += 1;
+        }
+
+        let (full, booted) = self.warm_boot(&mut flash, true);
+        if !full || booted != Some(0) || !self.verify_images(&flash, 0, 0) {
+            warn!("Warm reset kept the test image");
+            fails += 1;
+        }
+
+        if fails > 0 {
+            error!("Expected the test image to be reverted");
+        }
+
+        fails > 0
+    }
+
+    /// Boot after a warm or a cold reset.  Returns whether the boot read the
+    /// slots, and the slot it booted Image 0 from.
+    fn warm_boot(&self, flash: &mut SimMultiFlash, warm: bool) -> (bool, Option<usize>) {
+        c::set_warm_reset(warm);
+        let booted = self.boot_slot(flash);
+        c::set_warm_reset(false);
+        (c::boot_flash_reads() != 0, booted)
+    }
+
+    /// Boot, and return the slot the image was booted from; None if the boot
+    /// failed.
+    fn boot_slot(&self, flash: &mut SimMultiFlash) -> Option<usize> {
+        let (result, _) = c::boot_go(flash, &self.areadesc, None, false);
+        if result != 0 {
+            return None;
+        }
+
+        let off = c::boot_image_off();
+        self.images[0].slots.iter().position(|slot| slot.base_off == off)
+    }
+
+    /// Flip bits in the payload of the image in the given slot.
+    fn corrupt_slot(&self, flash: &mut SimMultiFlash, image_num: usize, slot: usize) {
+        self.rewrite_slot(flash, image_num, slot, 0x55);
+    }
+
+    /// Write the payload of the image in the given slot over itself, with
+    /// the bits of `flip` flipped.
+    fn rewrite_slot(&self, flash: &mut SimMultiFlash, image_num: usize, slot: usize,
+                    flip: u8) {
+        let slot = &self.images[image_num].slots[slot];
+        let dev = flash.get_mut(&slot.dev_id).unwrap();
+        let align = dev.align();
+        let off = slot.base_off + 256;
+
+        let mut buf = vec![0u8; align];
+        dev.read(off, &mut buf).unwrap();
+        for b in buf.iter_mut() {
+            *b ^= flip;
+        }
+
+        dev.set_verify_writes(false);
+        dev.write(off, &buf).unwrap();
+        dev.set_verify_writes(true);
+    }
+
     /// Adds a new flash area that fails statistically
     fn mark_bad_status_with_rate(&self, flash: &mut SimMultiFlash, slot: usize,
                                  rate: f32) {
@@ -1012,6 +1715,24 @@ impl Images {
         (flash, count - counter)
     }
 
+    /// Run boot_prestage() on each image in turn, optionally stopping after
+    /// 'n' flash operations.  Returns the number of flash operations done,
+    /// or None if stopped.
+    fn try_prestage(&self, flash: &mut SimMultiFlash, stop: Option<i32>) -> Option<i32> {
+        let start = stop.unwrap_or(0);
+        let mut counter = start;
+
+        for image_num in 0 .. self.images.len() {
+            match c::prestage(flash, &self.areadesc, image_num, false, Some(&mut counter)) {
+                -0x13579 => return None,
+                0 => (),
+                x => panic!("Unknown return: {}", x),
+            }
+        }
+
+        Some(start - counter)
+    }
+
     fn try_revert(&self, count: usize) -> SimMultiFlash {
         let mut flash = self.flash.clone();
 
@@ -1155,7 +1876,10 @@ impl Images {
     /// against the expected image.
     fn verify_images(&self, flash: &SimMultiFlash, slot: usize, against: usize) -> bool {
         self.images.iter().all(|image| {
-            verify_image(flash, &image.slots[slot],
+            // Upgrade images stay where they were installed, images swapped
+            // out of the primary slot are at the start of the slot.
+            let off = if against == 1 { image.slots[slot].upgrade_off } else { 0 };
+            verify_image(flash, &image.slots[slot], off,
                          match against {
                              0 => &image.primaries,
                              1 => &image.upgrades,
@@ -1168,7 +1892,7 @@ impl Images {
     fn verify_dep_images(&self, flash: &SimMultiFlash, deps: &DepTest) -> bool {
         for (image_num, (image, upgrade)) in self.images.iter().zip(deps.upgrades.iter()).enumerate() {
             info!("Upgrade: slot:{}, {:?}", image_num, upgrade);
-            if !verify_image(flash, &image.slots[0],
+            if !verify_image(flash, &image.slots[0], 0,
                             match upgrade {
                                 UpgradeInfo::Upgraded => &image.upgrades,
                                 UpgradeInfo::Held => &image.primaries,
@@ -1369,21 +2093,22 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: usize,
             cipher: enc_copy,
         }
     } else {
+        let image_off = offset + slot.upgrade_off;
 
-        dev.write(offset, &buf).unwrap();
+        dev.write(image_off, &buf).unwrap();
 
         let mut copy = vec![0u8; buf.len()];
-        dev.read(offset, &mut copy).unwrap();
+        dev.read(image_off, &mut copy).unwrap();
 
         let enc_copy: Option<Vec<u8>>;
 
         if is_encrypted {
             dev.erase(offset, slot_len).unwrap();
 
-            dev.write(offset, &encbuf).unwrap();
+            dev.write(image_off, &encbuf).unwrap();
 
             let mut enc = vec![0u8; encbuf.len()];
-            dev.read(offset, &mut enc).unwrap();
+            dev.read(image_off, &mut enc).unwrap();
 
             enc_copy = Some(enc);
         } else {
@@ -1397,6 +2122,18 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: usize,
     }
 }
 
+/// The size of the hashed area of the image in the given slot: its header,
+/// payload and protected TLVs.
+fn hashed_size(flash: &SimMultiFlash, slot: &SlotInfo) -> u32 {
+    let dev = flash.get(&slot.dev_id).unwrap();
+    let mut hdr = [0u8; 16];
+    dev.read(slot.base_off, &mut hdr).unwrap();
+
+    LittleEndian::read_u16(&hdr[8..10]) as u32 +
+        LittleEndian::read_u32(&hdr[12..16]) +
+        LittleEndian::read_u16(&hdr[10..12]) as u32
+}
+
 /// Install no image.  This is used when no upgrade happens.
 fn install_no_image() -> ImageData {
     ImageData {
@@ -1405,11 +2142,26 @@ fn install_no_image() -> ImageData {
     }
 }
 
+/// The block size of the block hashed images.  Small enough to give the test
+/// images several blocks, and a partial last one.
+const HASH_BLOCK_SIZE: u32 = 1000;
+
 fn make_tlv() -> TlvGen {
     if Caps::EcdsaP224.present() {
         panic!("Ecdsa P224 not supported in Simulator");
     }
 
+    let mut tlv = make_sig_tlv();
+    if Caps::HashBlocks.present() {
+        tlv.set_hash_block_size(HASH_BLOCK_SIZE);
+    }
+    if Caps::EncAead.present() {
+        tlv.set_aead();
+    }
+    tlv
+}
+
+fn make_sig_tlv() -> TlvGen {
     if Caps::EncKw.present() {
         if Caps::RSA2048.present() {
             TlvGen::new_rsa_kw()
@@ -1446,6 +2198,8 @@ fn make_tlv() -> TlvGen {
             TlvGen::new_ecdsa()
         } else if Caps::Ed25519.present() {
             TlvGen::new_ed25519()
+        } else if Caps::Lms.present() {
+            TlvGen::new_lms()
         } else {
             TlvGen::new_hash_only()
         }
@@ -1467,14 +2221,16 @@ impl ImageData {
     }
 }
 
-/// Verify that given image is present in the flash at the given offset.
-fn verify_image(flash: &SimMultiFlash, slot: &SlotInfo, images: &ImageData) -> bool {
+/// Verify that given image is present in the flash at the given offset
+/// within the slot.
+fn verify_image(flash: &SimMultiFlash, slot: &SlotInfo, off: usize,
+                images: &ImageData) -> bool {
     let image = images.find(slot.index);
     let buf = image.as_slice();
     let dev_id = slot.dev_id;
 
     let mut copy = vec![0u8; buf.len()];
-    let offset = slot.base_off;
+    let offset = slot.base_off + off;
     let dev = flash.get(&dev_id).unwrap();
     dev.read(offset, &mut copy).unwrap();
 
@@ -1499,9 +2255,15 @@ fn verify_trailer(flash: &SimMultiFlash, slot: &SlotInfo,
         return true;
     }
 
-    let offset = slot.trailer_off + c::boot_max_align();
+    // Index of copy_done, image_ok and the magic in the copy.  The compact
+    // trailer packs the flags into the unit before the magic.
+    let (offset, cd, ok, mg) = if Caps::CompactTrailer.present() {
+        (slot.trailer_off, 5, 6, c::boot_max_align())
+    } else {
+        (slot.trailer_off + c::boot_max_align(), 8, 16, 24)
+    };
     let dev_id = slot.dev_id;
-    let mut copy = vec![0u8; c::boot_magic_sz() + c::boot_max_align() * 3];
+    let mut copy = vec![0u8; c::boot_magic_sz() + mg];
     let mut failed = false;
 
     let dev = flash.get(&dev_id).unwrap();
@@ -1510,12 +2272,12 @@ fn verify_trailer(flash: &SimMultiFlash, slot: &SlotInfo,
 
     failed |= match magic {
         Some(v) => {
-            if v == 1 && &copy[24..] != MAGIC {
+            if v == 1 && &copy[mg..] != MAGIC {
                 warn!("\"magic\" mismatch at {:#x}", offset);
                 true
             } else if v == 3 {
                 let expected = [erased_val; 16];
-                if &copy[24..] != expected {
+                if &copy[mg..] != expected {
                     warn!("\"magic\" mismatch at {:#x}", offset);
                     true
                 } else {
@@ -1530,8 +2292,8 @@ fn verify_trailer(flash: &SimMultiFlash, slot: &SlotInfo,
 
     failed |= match image_ok {
         Some(v) => {
-            if (v == 1 && copy[16] != v) || (v == 3 && copy[16] != erased_val) {
-                warn!("\"image_ok\" mismatch at {:#x} v={} val={:#x}", offset, v, copy[8]);
+            if (v == 1 && copy[ok] != v) || (v == 3 && copy[ok] != erased_val) {
+                warn!("\"image_ok\" mismatch at {:#x} v={} val={:#x}", offset, v, copy[ok]);
                 true
             } else {
                 false
@@ -1542,8 +2304,8 @@ fn verify_trailer(flash: &SimMultiFlash, slot: &SlotInfo,
 
     failed |= match copy_done {
         Some(v) => {
-            if (v == 1 && copy[8] != v) || (v == 3 && copy[8] != erased_val) {
-                warn!("\"copy_done\" mismatch at {:#x} v={} val={:#x}", offset, v, copy[0]);
+            if (v == 1 && copy[cd] != v) || (v == 3 && copy[cd] != erased_val) {
+                warn!("\"copy_done\" mismatch at {:#x} v={} val={:#x}", offset, v, copy[cd]);
                 true
             } else {
                 false
@@ -1636,6 +2398,8 @@ pub struct SlotInfo {
     pub base_off: usize,
     pub trailer_off: usize,
     pub len: usize,
+    // Where upgrade images are installed within this slot.
+    pub upgrade_off: usize,
     // Which slot within this device.
     pub index: usize,
     pub dev_id: u8,
@@ -1657,7 +2421,7 @@ const BOOT_FLAG_UNSET: Option<u8> = Some(3);
 pub fn mark_upgrade(flash: &mut SimMultiFlash, slot: &SlotInfo) {
     let dev = flash.get_mut(&slot.dev_id).unwrap();
     let align = dev.align();
-    let offset = slot.trailer_off + c::boot_max_align() * 4;
+    let offset = slot.trailer_off + trailer_flags_sz();
     if offset % align != 0 || MAGIC.len() % align != 0 {
         // The write size is larger than the magic value.  Fill a buffer
         // with the erased value, put the MAGIC in it, and write it in its
@@ -1681,13 +2445,34 @@ fn mark_permanent_upgrade(flash: &mut SimMultiFlash, slot: &SlotInfo) {
     }
 
     let dev = flash.get_mut(&slot.dev_id).unwrap();
+    let align = dev.align();
+    if Caps::CompactTrailer.present() {
+        // image_ok shares its unit with the other flags, program it again.
+        let off = slot.trailer_off + 6;
+        let unit = off - off % align;
+        let mut buf = vec![0u8; align];
+        dev.read(unit, &mut buf).unwrap();
+        buf[off - unit] = 1u8;
+        dev.write(unit, &buf).unwrap();
+        return;
+    }
+
     let mut ok = [dev.erased_val(); 8];
     ok[0] = 1u8;
     let off = slot.trailer_off + c::boot_max_align() * 3;
-    let align = dev.align();
     dev.write(off, &ok[..align]).unwrap();
 }
 
+/// Size of the flags (swap_size, swap_info, copy_done and image_ok) before
+/// the magic in the trailer.
+fn trailer_flags_sz() -> usize {
+    if Caps::CompactTrailer.present() {
+        c::boot_max_align()
+    } else {
+        c::boot_max_align() * 4
+    }
+}
+
 // Drop some pseudo-random gibberish onto the data.
 fn splat(data: &mut [u8], seed: usize) {
     let mut seed_block = [0u8; 16];
@@ -1716,6 +2501,73 @@ pub fn show_sizes() {
     }
 }
 
+/// Time the signature verification of the backend the simulator was built with.  The
+/// backends are compared by running this with each of the signature features.
+pub fn bench_verify(count: usize) {
+    let sig_kinds = [TlvKinds::RSA2048, TlvKinds::RSA3072, TlvKinds::ECDSA256,
+                     TlvKinds::ED25519, TlvKinds::LMS];
+
+    let mut tlv: Box<dyn ManifestGen> = Box::new(make_sig_tlv());
+    let mut payload = vec![0; 32 * 1024];
+    splat(&mut payload, 0);
+    tlv.add_bytes(&payload);
+    let tlv = tlv.make_tlv();
+
+    // Skip the TLV info header, and pick up the hash and the signature.
+    let mut hash = None;
+    let mut sig = None;
+    let mut pos = 4;
+    while pos + 4 <= tlv.len() {
+        let kind = u16::from_le_bytes([tlv[pos], tlv[pos + 1]]);
+        let len = u16::from_le_bytes([tlv[pos + 2], tlv[pos + 3]]) as usize;
+        let value = &tlv[pos + 4 .. pos + 4 + len];
+        if kind == TlvKinds::SHA256 as u16 {
+            hash = Some(value);
+        } else if sig_kinds.iter().any(|&k| kind == k as u16) {
+            sig = Some(value);
+        }
+        pos += 4 + len;
+    }
+
+    let (hash, sig) = match (hash, sig) {
+        (Some(hash), Some(sig)) => (hash, sig),
+        _ => {
+            println!("No signature type configured");
+            return;
+        }
+    };
+
+    assert!(c::verify_sig(hash, sig), "Signature does not verify");
+    let start = Instant::now();
+    for _ in 0 .. count {
+        assert!(c::verify_sig(hash, sig));
+    }
+    let elapsed = start.elapsed();
+    println!("{} verifications of a {} byte signature: {:?} each",
+             count, sig.len(), elapsed / count as u32);
+}
+
+/// Time the X25519 key agreement used to decrypt ECIES-X25519 images.
+pub fn bench_x25519(count: usize) {
+    if !Caps::EncX25519.present() {
+        println!("X25519 encryption not configured");
+        return;
+    }
+
+    // Repeatedly derive a key from the base point, so every iteration works on a new value.
+    let mut point = [0u8; 32];
+    point[0] = 9;
+    let mut scalar = [0u8; 32];
+    splat(&mut scalar, 0);
+
+    let start = Instant::now();
+    for _ in 0 .. count {
+        point = c::x25519(&scalar, &point).expect("X25519 failed");
+    }
+    let elapsed = start.elapsed();
+    println!("{} X25519 agreements: {:?} each", count, elapsed / count as u32);
+}
+
 #[cfg(not(feature = "large-write"))]
 fn test_alignments() -> &'static [usize] {
     &[1, 2, 4, 8]
@@ -15,6 +15,7 @@ use serde_derive::Deserialize;
 mod caps;
 mod depends;
 mod image;
+mod lms;
 mod tlv;
 pub mod testlog;
 
@@ -29,6 +30,8 @@ pub use crate::{
     image::{
         ImagesBuilder,
         Images,
+        bench_verify,
+        bench_x25519,
         show_sizes,
     },
 };
@@ -40,6 +43,7 @@ Usage:
   bootsim sizes
   bootsim run --device TYPE [--align SIZE]
   bootsim runall
+  bootsim bench [--count N]
   bootsim (--help | --version)
 
 Options:
@@ -48,6 +52,7 @@ Options:
   --device TYPE      MCU to simulate
                      Valid values: stm32f4, k64f
   --align SIZE       Flash write alignment
+  --count N          Number of operations to time [default: 100]
 ";
 
 #[derive(Debug, Deserialize)]
@@ -56,6 +61,8 @@ struct Args {
     flag_version: bool,
     flag_device: Option<DeviceName>,
     flag_align: Option<AlignArg>,
+    flag_count: usize,
+    cmd_bench: bool,
     cmd_sizes: bool,
     cmd_run: bool,
     cmd_runall: bool,
@@ -64,7 +71,7 @@ struct Args {
 #[derive(Copy, Clone, Debug, Deserialize)]
 pub enum DeviceName {
     Stm32f4, K64f, K64fBig, K64fMulti, Nrf52840, Nrf52840SpiFlash,
-    Nrf52840UnequalSlots,
+    Nrf52840UnequalSlots, Nrf52840LargerSecondary,
 }
 
 pub static ALL_DEVICES: &'static [DeviceName] = &[
@@ -75,6 +82,7 @@ pub static ALL_DEVICES: &'static [DeviceName] = &[
     DeviceName::Nrf52840,
     DeviceName::Nrf52840SpiFlash,
     DeviceName::Nrf52840UnequalSlots,
+    DeviceName::Nrf52840LargerSecondary,
 ];
 
 impl fmt::Display for DeviceName {
@@ -87,6 +95,7 @@ impl fmt::Display for DeviceName {
             DeviceName::Nrf52840 => "nrf52840",
             DeviceName::Nrf52840SpiFlash => "Nrf52840SpiFlash",
             DeviceName::Nrf52840UnequalSlots => "Nrf52840UnequalSlots",
+            DeviceName::Nrf52840LargerSecondary => "Nrf52840LargerSecondary",
         };
         f.write_str(name)
     }
@@ -136,6 +145,12 @@ pub fn main() {
         return;
     }
 
+    if args.cmd_bench {
+        bench_verify(args.flag_count);
+        bench_x25519(args.flag_count);
+        return;
+    }
+
     let mut status = RunStatus::new();
     if args.cmd_run {
 
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+
+//! LMS (RFC 8554) signatures for the test images.
+//!
+//! Only the SHA-256 parameter sets with 32 byte hashes are supported.  The whole tree is
+//! recomputed for every signature, which is only reasonable for the small trees used by the
+//! tests.
+
+use byteorder::{BigEndian, WriteBytesExt};
+use ring::digest;
+
+const N: usize = 32;
+const D_PBLC: u16 = 0x8080;
+const D_MESG: u16 = 0x8181;
+const D_LEAF: u16 = 0x8282;
+const D_INTR: u16 = 0x8383;
+
+pub struct LmsKey {
+    lms_type: u32,
+    ots_type: u32,
+    ident: Vec<u8>,
+    seed: Vec<u8>,
+}
+
+fn hash(parts: &[&[u8]]) -> Vec<u8> {
+    let mut ctx = digest::Context::new(&digest::SHA256);
+    for part in parts {
+        ctx.update(part);
+    }
+    ctx.finish().as_ref().to_vec()
+}
+
+fn u32str(x: u32) -> Vec<u8> {
+    let mut buf = vec![];
+    buf.write_u32::<BigEndian>(x).unwrap();
+    buf
+}
+
+fn u16str(x: u16) -> Vec<u8> {
+    let mut buf = vec![];
+    buf.write_u16::<BigEndian>(x).unwrap();
+    buf
+}
+
+fn coef(s: &[u8], i: usize, w: usize) -> usize {
+    ((1 << w) - 1) & ((s[i * w / 8] as usize) >> (8 - (w * (i % (8 / w)) + w)))
+}
+
+impl LmsKey {
+    /// Parse a private key: the LMS and LM-OTS types, I, SEED and the next leaf (ignored).
+    pub fn from_bytes(data: &[u8]) -> LmsKey {
+        assert_eq!(data.len(), 8 + 16 + N + 4, "Invalid LMS private key");
+        let be = |b: &[u8]| u32::from_be_bytes([b[0], b[1], b[2], b[3]]);
+        LmsKey {
+            lms_type: be(&data[0..4]),
+            ots_type: be(&data[4..8]),
+            ident: data[8..24].to_vec(),
+            seed: data[24..24 + N].to_vec(),
+        }
+    }
+
+    /// The number of one-time keys.
+    pub fn leaves(&self) -> u32 {
+        1 << self.height()
+    }
+
+    fn height(&self) -> usize {
+        match self.lms_type {
+            5 => 5,
+            6 => 10,
+            7 => 15,
+            8 => 20,
+            9 => 25,
+            t => panic!("Unsupported LMS type {}", t),
+        }
+    }
+
+    /// The Winternitz parameter, number of chains and checksum shift.
+    fn ots_params(&self) -> (usize, usize, usize) {
+        match self.ots_type {
+            1 => (1, 265, 7),
+            2 => (2, 133, 6),
+            3 => (4, 67, 4),
+            4 => (8, 34, 0),
+            t => panic!("Unsupported LM-OTS type {}", t),
+        }
+    }
+
+    fn chain(&self, q: u32, i: usize, start: usize, end: usize, mut tmp: Vec<u8>) -> Vec<u8> {
+        for j in start .. end {
+            tmp = hash(&[&self.ident, &u32str(q), &u16str(i as u16), &[j as u8], &tmp]);
+        }
+        tmp
+    }
+
+    fn ots_private(&self, q: u32, i: usize) -> Vec<u8> {
+        hash(&[&self.ident, &u32str(q), &u16str(i as u16), &[0xff], &self.seed])
+    }
+
+    fn ots_public(&self, q: u32) -> Vec<u8> {
+        let (w, p, _) = self.ots_params();
+        let mut ctx = digest::Context::new(&digest::SHA256);
+        ctx.update(&self.ident);
+        ctx.update(&u32str(q));
+        ctx.update(&u16str(D_PBLC));
+        for i in 0 .. p {
+            ctx.update(&self.chain(q, i, 0, (1 << w) - 1, self.ots_private(q, i)));
+        }
+        ctx.finish().as_ref().to_vec()
+    }
+
+    /// The tree, indexed by node number.
+    fn tree(&self) -> Vec<Vec<u8>> {
+        let leaves = self.leaves();
+        let mut tree = vec![vec![]; 2 * leaves as usize];
+        for q in 0 .. leaves {
+            let r = leaves + q;
+            tree[r as usize] = hash(&[&self.ident, &u32str(r), &u16str(D_LEAF),
+                                    &self.ots_public(q)]);
+        }
+        for r in (1 .. leaves).rev() {
+            let node = hash(&[&self.ident, &u32str(r), &u16str(D_INTR),
+                              &tree[2 * r as usize], &tree[2 * r as usize + 1]]);
+            tree[r as usize] = node;
+        }
+        tree
+    }
+
+    /// Sign `message` with the one-time key `q`, using the randomizer `c`.
+    pub fn sign(&self, q: u32, c: &[u8], message: &[u8]) -> Vec<u8> {
+        assert!(q < self.leaves());
+        assert_eq!(c.len(), N);
+        let (w, p, ls) = self.ots_params();
+
+        let mut s = hash(&[&self.ident, &u32str(q), &u16str(D_MESG), c, message]);
+        let cksm: usize = (0 .. N * 8 / w).map(|i| (1 << w) - 1 - coef(&s, i, w)).sum();
+        s.extend_from_slice(&u16str((cksm << ls) as u16));
+
+        let mut sig = u32str(q);
+        sig.extend_from_slice(&u32str(self.ots_type));
+        sig.extend_from_slice(c);
+        for i in 0 .. p {
+            sig.extend_from_slice(&self.chain(q, i, 0, coef(&s, i, w), self.ots_private(q, i)));
+        }
+        sig.extend_from_slice(&u32str(self.lms_type));
+
+        let tree = self.tree();
+        let node = (self.leaves() + q) as usize;
+        for i in 0 .. self.height() {
+            sig.extend_from_slice(&tree[(node >> i) ^ 1]);
+        }
+        sig
+    }
+}
@@ -17,6 +17,7 @@ use byteorder::{
     LittleEndian, WriteBytesExt,
 };
 use crate::image::ImageVersion;
+use crate::lms::LmsKey;
 use pem;
 use base64;
 use log::info;
@@ -38,6 +39,7 @@ use aes_ctr::{
     },
 };
 use mcuboot_sys::c;
+use std::sync::atomic::{AtomicUsize, Ordering};
 
 #[repr(u16)]
 #[derive(Copy, Clone, Debug, PartialEq, Eq)]
@@ -45,15 +47,18 @@ use mcuboot_sys::c;
 pub enum TlvKinds {
     KEYHASH = 0x01,
     SHA256 = 0x10,
+    SHA256BLOCKS = 0x13,
     RSA2048 = 0x20,
     ECDSA224 = 0x21,
     ECDSA256 = 0x22,
     RSA3072 = 0x23,
     ED25519 = 0x24,
+    LMS = 0x25,
     ENCRSA2048 = 0x30,
     ENCKW128 = 0x31,
     ENCEC256 = 0x32,
     ENCX25519 = 0x33,
+    ENCAEAD = 0x34,
     DEPENDENCY = 0x40,
 }
 
@@ -63,6 +68,8 @@ pub enum TlvFlags {
     NON_BOOTABLE = 0x02,
     ENCRYPTED = 0x04,
     RAM_LOAD = 0x20,
+    HASH_BLOCKS = 0x40,
+    AEAD = 0x80,
 }
 
 /// A generator for manifests.  The format of the manifest can be either a
@@ -109,6 +116,10 @@ pub struct TlvGen {
     enc_key: Vec<u8>,
     /// Should this signature be corrupted.
     gen_corrupted: bool,
+    /// Hash the image in blocks of this size.
+    hash_block_size: Option<u32>,
+    /// Authenticate the encrypted payload in a protected TLV.
+    aead: bool,
 }
 
 #[derive(Debug)]
@@ -119,7 +130,75 @@ struct Dependency {
 
 const AES_KEY_LEN: usize = 16;
 
+/// The size of the ENC_AEAD TLV: the key check value, the tag of the ciphertext, and the hash of
+/// the plaintext.
+const AEAD_TLV_LEN: usize = 16 + 16 + 32;
+
+/// The next one-time key to sign with the LMS test key.
+static LMS_NEXT_LEAF: AtomicUsize = AtomicUsize::new(0);
+
 impl TlvGen {
+    /// Hash the image in blocks of `block_size` bytes.  This must be set before the header is
+    /// generated, as it changes the flags.
+    pub fn set_hash_block_size(&mut self, block_size: u32) {
+        self.hash_block_size = Some(block_size);
+        self.flags |= TlvFlags::HASH_BLOCKS as u32;
+    }
+
+    /// Authenticate the encrypted payload, with its tag and plaintext hash in a protected TLV.
+    /// This must be set before the header is generated, as it changes the flags.
+    pub fn set_aead(&mut self) {
+        self.aead = true;
+        self.flags |= TlvFlags::AEAD as u32;
+    }
+
+    /// Return the message that the image hash covers, and that is signed: the payload itself, or
+    /// the block size followed by the hash of each block when hashing in blocks.  An AEAD image
+    /// leaves the payload out, as the protected TLVs already cover it.
+    fn signed_message(&self, payload: &[u8]) -> Vec<u8> {
+        if self.aead {
+            let mut message = payload[..self.header_size()].to_vec();
+            message.extend_from_slice(&payload[self.payload.len()..]);
+            return message;
+        }
+
+        match self.hash_block_size {
+            Some(block_size) => {
+                let mut message = vec![];
+                message.write_u32::<LittleEndian>(block_size).unwrap();
+                for block in payload.chunks(block_size as usize) {
+                    message.extend_from_slice(digest::digest(&digest::SHA256, block).as_ref());
+                }
+                message
+            }
+            None => payload.to_vec(),
+        }
+    }
+
+    /// The size of the image header, which is at the start of the payload.
+    fn header_size(&self) -> usize {
+        u16::from_le_bytes([self.payload[8], self.payload[9]]) as usize
+    }
+
+    /// Build the ENC_AEAD TLV value for the payload, encrypted with the current key.
+    fn aead_tlv(&self) -> Vec<u8> {
+        let enc_key = self.get_enc_key();
+        let mac_key = aes_cmac(&enc_key, b"MCUBOOT-AEAD-MAC");
+
+        let mut ciphertext = self.payload[self.header_size()..].to_vec();
+        let key = GenericArray::from_slice(&enc_key);
+        let nonce = GenericArray::from_slice(&[0; 16]);
+        let mut cipher = Aes128Ctr::new(&key, &nonce);
+        cipher.apply_keystream(&mut ciphertext);
+
+        let mut value = aes_cmac(&enc_key, b"MCUBOOT-AEAD-KCV");
+        value.extend_from_slice(&aes_cmac(&mac_key, &ciphertext));
+        value.extend_from_slice(digest::digest(&digest::SHA256,
+                                               &self.payload[self.header_size()..]).as_ref());
+        assert_eq!(value.len(), AEAD_TLV_LEN);
+        value
+    }
+
     /// Construct a new tlv generator that will only contain a hash of the data.
     #[allow(dead_code)]
     pub fn new_hash_only() -> TlvGen {
@@ -161,6 +240,14 @@ impl TlvGen {
         }
     }
 
+    #[allow(dead_code)]
+    pub fn new_lms() -> TlvGen {
+        TlvGen {
+            kinds: vec![TlvKinds::SHA256, TlvKinds::LMS],
+            ..Default::default()
+        }
+    }
+
     #[allow(dead_code)]
     pub fn new_enc_rsa() -> TlvGen {
         TlvGen {
@@ -259,11 +346,15 @@ impl ManifestGen for TlvGen {
     }
 
     fn protect_size(&self) -> u16 {
-        if self.dependencies.is_empty() {
+        let mut size = (self.dependencies.len() as u16) * (4 + 4 + 8);
+        if self.aead {
+            size += 4 + AEAD_TLV_LEN as u16;
+        }
+        if size == 0 {
             0
         } else {
-            // Include the header and space for each dependency.
-            4 + (self.dependencies.len() as u16) * (4 + 4 + 8)
+            // Include the header.
+            4 + size
         }
     }
 
@@ -302,6 +393,12 @@ impl ManifestGen for TlvGen {
                 protected_tlv.write_u32::<LittleEndian>(dep.version.build_num).unwrap();
             }
 
+            if self.aead {
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::ENCAEAD as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(AEAD_TLV_LEN as u16).unwrap();
+                protected_tlv.extend_from_slice(&self.aead_tlv());
+            }
+
             assert_eq!(size, protected_tlv.len() as u16, "protected TLV length incorrect");
         }
 
@@ -335,7 +432,7 @@ impl ManifestGen for TlvGen {
             let mut corrupt_hash = self.gen_corrupted;
             for k in &[TlvKinds::RSA2048, TlvKinds::RSA3072,
                 TlvKinds::ECDSA224, TlvKinds::ECDSA256,
-                TlvKinds::ED25519]
+                TlvKinds::ED25519, TlvKinds::LMS]
             {
                 if self.kinds.contains(k) {
                     corrupt_hash = false;
@@ -347,7 +444,7 @@ impl ManifestGen for TlvGen {
                 sig_payload[0] ^= 1;
             }
 
-            let hash = digest::digest(&digest::SHA256, &sig_payload);
+            let hash = digest::digest(&digest::SHA256, &self.signed_message(&sig_payload));
             let hash = hash.as_ref();
 
             assert!(hash.len() == 32);
@@ -360,6 +457,13 @@ impl ManifestGen for TlvGen {
                 sig_payload[0] ^= 1;
             }
 
+            if self.hash_block_size.is_some() {
+                let blocks = self.signed_message(&sig_payload);
+                result.write_u16::<LittleEndian>(TlvKinds::SHA256BLOCKS as u16).unwrap();
+                result.write_u16::<LittleEndian>(blocks.len() as u16).unwrap();
+                result.extend_from_slice(&blocks);
+            }
+
         }
 
         if self.gen_corrupted {
@@ -401,7 +505,8 @@ impl ManifestGen for TlvGen {
             } else {
                 assert_eq!(signature.len(), 384);
             }
-            key_pair.sign(&RSA_PSS_SHA256, &rng, &sig_payload, &mut signature).unwrap();
+            key_pair.sign(&RSA_PSS_SHA256, &rng, &self.signed_message(&sig_payload),
+                          &mut signature).unwrap();
 
             if is_rsa2048 {
                 result.write_u16::<LittleEndian>(TlvKinds::RSA2048 as u16).unwrap();
@@ -427,7 +532,7 @@ impl ManifestGen for TlvGen {
             let key_pair = EcdsaKeyPair::from_pkcs8(&ECDSA_P256_SHA256_ASN1_SIGNING,
                                                     &key_bytes.contents).unwrap();
             let rng = rand::SystemRandom::new();
-            let signature = key_pair.sign(&rng, &sig_payload).unwrap();
+            let signature = key_pair.sign(&rng, &self.signed_message(&sig_payload)).unwrap();
 
             result.write_u16::<LittleEndian>(TlvKinds::ECDSA256 as u16).unwrap();
 
@@ -446,7 +551,7 @@ impl ManifestGen for TlvGen {
             result.write_u16::<LittleEndian>(32).unwrap();
             result.extend_from_slice(keyhash);
 
-            let hash = digest::digest(&digest::SHA256, &sig_payload);
+            let hash = digest::digest(&digest::SHA256, &self.signed_message(&sig_payload));
             let hash = hash.as_ref();
             assert!(hash.len() == 32);
 
@@ -464,6 +569,36 @@ impl ManifestGen for TlvGen {
             result.extend_from_slice(signature.as_ref());
         }
 
+        if self.kinds.contains(&TlvKinds::LMS) {
+            let keyhash = digest::digest(&digest::SHA256, LMS_PUB_KEY);
+            let keyhash = keyhash.as_ref();
+
+            assert!(keyhash.len() == 32);
+            result.write_u16::<LittleEndian>(TlvKinds::KEYHASH as u16).unwrap();
+            result.write_u16::<LittleEndian>(32).unwrap();
+            result.extend_from_slice(keyhash);
+
+            let hash = digest::digest(&digest::SHA256, &self.signed_message(&sig_payload));
+            let hash = hash.as_ref();
+            assert!(hash.len() == 32);
+
+            let key_bytes = pem::parse(include_bytes!("../../root-lms.pem").as_ref()).unwrap();
+            assert_eq!(key_bytes.tag, "LMS PRIVATE KEY");
+            let key = LmsKey::from_bytes(&key_bytes.contents);
+
+            // The tests sign many more images than the test key has one-time keys, so
+            // they get reused.  This must never happen with a real key.
+            let q = LMS_NEXT_LEAF.fetch_add(1, Ordering::Relaxed) as u32 % key.leaves();
+            let mut c = [0u8; 32];
+            let rng = rand::SystemRandom::new();
+            rng.fill(&mut c).unwrap();
+            let signature = key.sign(q, &c, hash);
+
+            result.write_u16::<LittleEndian>(TlvKinds::LMS as u16).unwrap();
+            result.write_u16::<LittleEndian>(signature.len() as u16).unwrap();
+            result.extend_from_slice(&signature);
+        }
+
         if self.kinds.contains(&TlvKinds::ENCRSA2048) {
             let key_bytes = pem::parse(include_bytes!("../../enc-rsa2048-pub.pem")
                                        .as_ref()).unwrap();
@@ -610,7 +745,61 @@ impl ManifestGen for TlvGen {
     }
 }
 
+/// Encrypt a single block with AES-128, as the first block of the CTR key stream with that block
+/// as the counter.  This matches how bootutil builds CMAC on its AES-CTR backend.
+fn aes_block(key: &[u8], block: &[u8]) -> [u8; 16] {
+    let mut out = [0u8; 16];
+    let mut cipher = Aes128Ctr::new(GenericArray::from_slice(key), GenericArray::from_slice(block));
+    cipher.apply_keystream(&mut out);
+    out
+}
+
+/// Multiply a block by x in GF(2^128).
+fn cmac_double(block: &[u8; 16]) -> [u8; 16] {
+    let mut out = [0u8; 16];
+    for i in 0 .. 15 {
+        out[i] = (block[i] << 1) | (block[i + 1] >> 7);
+    }
+    out[15] = (block[15] << 1) ^ if block[0] & 0x80 != 0 { 0x87 } else { 0 };
+    out
+}
+
+/// Compute the AES-CMAC (RFC 4493) of `data`.
+fn aes_cmac(key: &[u8], data: &[u8]) -> Vec<u8> {
+    let k1 = cmac_double(&aes_block(key, &[0; 16]));
+    let k2 = cmac_double(&k1);
+
+    let mut chunks: Vec<&[u8]> = data.chunks(16).collect();
+    if chunks.is_empty() {
+        chunks.push(&[]);
+    }
+    let last = chunks.len() - 1;
+
+    let mut x = [0u8; 16];
+    for (i, chunk) in chunks.iter().enumerate() {
+        let mut block = [0u8; 16];
+        block[..chunk.len()].copy_from_slice(chunk);
+        if i == last {
+            let k = if chunk.len() == 16 {
+                &k1
+            } else {
+                block[chunk.len()] = 0x80;
+                &k2
+            };
+            for j in 0 .. 16 {
+                block[j] ^= k[j];
+            }
+        }
+        for j in 0 .. 16 {
+            x[j] ^= block[j];
+        }
+        x = aes_block(key, &x);
+    }
+    x.to_vec()
+}
+
 include!("rsa_pub_key-rs.txt");
 include!("rsa3072_pub_key-rs.txt");
 include!("ecdsa_pub_key-rs.txt");
 include!("ed25519_pub_key-rs.txt");
+include!("lms_pub_key-rs.txt");
@@ -51,6 +51,7 @@ sim_test!(secondary_trailer_leftover, make_erased_secondary_image(), run_seconda
 sim_test!(bootstrap, make_bootstrap_image(), run_bootstrap());
 sim_test!(norevert_newimage, make_no_upgrade_image(&NO_DEPS), run_norevert_newimage());
 sim_test!(basic_revert, make_image(&NO_DEPS, true), run_basic_revert());
+sim_test!(small_upgrade, make_small_image(), run_small_upgrade());
 sim_test!(revert_with_fails, make_image(&NO_DEPS, false), run_revert_with_fails());
 sim_test!(perm_with_fails, make_image(&NO_DEPS, true), run_perm_with_fails());
 sim_test!(perm_with_random_fails, make_image(&NO_DEPS, true), run_perm_with_random_fails(5));
@@ -58,6 +59,19 @@ sim_test!(norevert, make_image(&NO_DEPS, true), run_norevert());
 sim_test!(status_write_fails_complete, make_image(&NO_DEPS, true), run_with_status_fails_complete());
 sim_test!(status_write_fails_with_reset, make_image(&NO_DEPS, true), run_with_status_fails_with_reset());
 sim_test!(downgrade_prevention, make_image(&REV_DEPS, true), run_nodowngrade());
+sim_test!(staged_boot, make_image(&NO_DEPS, true), run_staged_boot(&NO_DEPS));
+sim_test!(staged_boot_dependency, make_image(&STAGED_DEPS, true),
+          run_staged_boot(&STAGED_DEPS));
+sim_test!(prestage, make_no_upgrade_image(&NO_DEPS), run_prestage());
+sim_test!(prestage_bad_image, make_bad_secondary_slot_image(), run_prestage_bad_image());
+sim_test!(xip_select, make_xip_image(), run_xip_select());
+sim_test!(xip_revert, make_xip_image(), run_xip_revert());
+sim_test!(xip_confirm, make_xip_image(), run_xip_confirm());
+sim_test!(check_blocks, make_no_upgrade_image(&NO_DEPS), run_check_blocks());
+sim_test!(warm_cold, make_no_upgrade_image(&NO_DEPS), run_warm_cold());
+sim_test!(warm_generation, make_no_upgrade_image(&NO_DEPS), run_warm_generation());
+sim_test!(warm_forged, make_no_upgrade_image(&NO_DEPS), run_warm_forged());
+sim_test!(warm_revert, make_image(&NO_DEPS, false), run_warm_revert());
 
 // Test various combinations of incorrect dependencies.
 test_shell!(dependency_combos, r, {
@@ -73,6 +87,13 @@ test_shell!(dependency_combos, r, {
     }
 });
 
+/// Image 0 depends on Image 1, which then can't be checked after the handoff.
+static STAGED_DEPS: DepTest = DepTest {
+    depends: [DepType::Correct, DepType::Nothing],
+    upgrades: [UpgradeInfo::Upgraded, UpgradeInfo::Upgraded],
+    downgrade: false,
+};
+
 /// These are the variants of dependencies we will test.
 pub static TEST_DEPS: &[DepTest] = &[
     // A sanity test, no dependencies should upgrade.